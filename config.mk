@@ -29,6 +29,9 @@ SIZE=$(GCC_PATH)/arm-none-eabi-size
 STRIP=$(GCC_PATH)/arm-none-eabi-strip
 READELF=$(GCC_PATH)/arm-none-eabi-readelf
 
+# Defines to configure the SDK for this microapp, for example: -DMAX_INTERRUPT_REGISTRATIONS=10
+MICROAPP_DEFINES=
+
 # The build directory
 BUILD_PATH=build
 
@@ -38,6 +41,9 @@ TARGET_NAME=hello
 # The target source file
 TARGET_SOURCE=examples/$(TARGET_NAME).ino
 
+# Headers next to the target source can be included, such as examples/tests/TestCheck.h
+TARGET_INCLUDES=-I$(dir $(TARGET_SOURCE))
+
 # The build target (including build directory)
 TARGET=$(BUILD_PATH)/$(TARGET_NAME)
 
@@ -57,6 +63,29 @@ FLAGS=-std=c++17 -mthumb -ffunction-sections -fdata-sections -Wall -Werror \
 	  -g \
 	  -Wno-error=unused-function -Os -fomit-frame-pointer -Wl,-z,nocopyreloc \
 	  --specs=nosys.specs -Wl,-lnosys \
-	  -mcpu=cortex-m4 -mfloat-abi=hard -mfpu=fpv4-sp-d16 -u _printf_float
+	  -mcpu=cortex-m4 -mfloat-abi=hard -mfpu=fpv4-sp-d16
 
 # ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ #
+
+###############################################################################
+# Host build: runs the microapp on the build machine against an emulated bluenet (see docs/HOST.md).
+###############################################################################
+
+# The host compiler
+HOST_CC=g++
+
+# The host build target
+HOST_TARGET=$(TARGET)_host
+
+# The event file with scripted interrupts, and the number of ticks to run
+HOST_EVENTS=
+HOST_TICKS=100
+
+# Command used to benchmark the host build
+HOST_BENCH=perf stat -e task-clock,cycles,instructions
+
+# Do not link against the libc versions of the functions the microapp implements itself
+HOST_FLAGS=-std=c++17 -Wall -Werror -fno-strict-aliasing -fno-builtin -fshort-enums -Wno-error=format \
+	  -fno-exceptions -g -O2 -DMICROAPP_HOST_BUILD \
+	  -Dstrlen=microapp_strlen -Dmemcmp=microapp_memcmp -Dmemcpy=microapp_memcpy \
+	  -Dmemmove=microapp_memmove -Dmemset=microapp_memset
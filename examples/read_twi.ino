@@ -44,10 +44,10 @@ void loop() {
 
 	// Read something new every so many times
 	if (counter % 5 == 0) {
-		// register 5
+		// register 5, without releasing the bus: the register address and the read are sent together
 		Wire.beginTransmission(address);
 		Wire.send(TEMPERATURE_REGISTER);
-		Wire.endTransmission();
+		Wire.endTransmission(false);
 
 		// Request 2 bytes from device at given address
 		Wire.requestFrom(address, 2, true);
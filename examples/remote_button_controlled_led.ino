@@ -149,7 +149,7 @@ void loop() {
 		meshReplyReceived = false;
 		MacAddress remoteAddress(meshReplyAddress, 6, 0);
 		Serial.println(remoteAddress.string());
-		BLE.scanForAddress(remoteAddress.string());
+		BLE.scanForAddress(remoteAddress.string().c_str());
 		return;
 	}
 
@@ -0,0 +1,24 @@
+/*
+ * Check helper for the test microapps in this directory.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <Arduino.h>
+
+/**
+ * Print the name of a check, followed by "OK" or "FAIL".
+ *
+ * A test passes when every printed check ends with "OK", and no check is missing.
+ * Checks are printed via Serial_ rather than Serial, so that they are not compiled out when MICROAPP_LOG_LEVEL is above
+ * info, which would make a test pass without any check.
+ */
+inline void check(const char* name, bool result) {
+	Serial_::getInstance().print(name);
+	Serial_::getInstance().println(result ? " OK" : " FAIL");
+}
@@ -0,0 +1,49 @@
+#include <Arduino.h>
+#include "TestCheck.h"
+
+const uint8_t CALL_LIMIT = 8;
+
+/**
+ * Makes more calls than the call limit allows, in a batch.
+ *
+ * The batched calls are sent in a few yields, so unlike in the consecutive calls test, the microapp is not throttled.
+ * With a bluenet version that does not support batches, the calls are sent one by one and throttling does kick in.
+ * The results are the same in both cases: run it on the host (see docs/HOST.md) with and without
+ * MICROAPP_HOST_NO_BATCH.
+ */
+
+uint8_t loopCount = 0;
+
+void setup() {
+	Serial.println("Batched call test");
+
+	microapp_sdk_result_t begun  = beginBatch();
+	microapp_sdk_result_t nested = beginBatch();
+	for (int i = 0; i <= 2 * CALL_LIMIT; i++) {
+		Serial.println(i);
+	}
+	microapp_sdk_result_t result = commitBatch();
+	check("begin", begun == CS_MICROAPP_SDK_ACK_SUCCESS);
+	check("nested begin", nested == CS_MICROAPP_SDK_ACK_ERR_BUSY);
+	check("commit", result == CS_MICROAPP_SDK_ACK_SUCCESS);
+	check("commit without batch", commitBatch() == CS_MICROAPP_SDK_ACK_ERR_EMPTY);
+}
+
+void loop() {
+	// Update several pins at once: they are handled in a single yield.
+	static bool on = false;
+	on             = !on;
+	beginBatch();
+	digitalWrite(LED1_PIN, on ? HIGH : LOW);
+	digitalWrite(LED2_PIN, on ? LOW : HIGH);
+	digitalWrite(LED3_PIN, on ? HIGH : LOW);
+	microapp_sdk_result_t result = commitBatch();
+	if (loopCount < 2) {
+		loopCount++;
+		// Reading a pin needs its result, so it is not batched.
+		uint8_t expected = on ? CS_MICROAPP_SDK_PIN_ON : CS_MICROAPP_SDK_PIN_OFF;
+		check("pins", result == CS_MICROAPP_SDK_ACK_SUCCESS && digitalRead(LED1_PIN) == expected
+							  && digitalRead(LED3_PIN) == expected && digitalRead(LED2_PIN) != expected);
+	}
+	delay(1000);
+}
@@ -0,0 +1,75 @@
+#include <Arduino.h>
+#include <ArduinoBLE.h>
+#include "TestCheck.h"
+
+/**
+ * Tests the attribute cache: when reconnecting to a peripheral, its services and characteristics are restored from the
+ * cache instead of discovered again, which takes no time. With the default cache size of 2, the peripheral used longest
+ * ago is forgotten.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/ble_peripherals.txt, where three peripherals advertise, and
+ * the emulator acts as each of them.
+ */
+
+struct Step {
+	const char* address;
+	bool cached;
+};
+
+const Step steps[] = {
+		{"A4:C1:38:9A:45:E3", false},
+		{"A4:C1:38:12:34:56", false},
+		{"A4:C1:38:AB:CD:EF", false},
+		{"A4:C1:38:AB:CD:EF", true},
+		{"A4:C1:38:12:34:56", true},
+		// Used longest ago, so replaced by the third one.
+		{"A4:C1:38:9A:45:E3", false},
+		// Replaced by the first one.
+		{"A4:C1:38:AB:CD:EF", false},
+		// Forgotten by clearAttributeCache().
+		{"A4:C1:38:9A:45:E3", false},
+};
+const uint8_t STEP_COUNT = sizeof(steps) / sizeof(steps[0]);
+
+uint8_t step = 0;
+
+void setup() {
+	Serial.println("BLE attribute cache test");
+	if (!BLE.begin()) {
+		check("begin", false);
+		return;
+	}
+	BLE.scan(true);
+}
+
+void loop() {
+	if (step >= STEP_COUNT) {
+		return;
+	}
+	BleDevice& peripheral = BLE.available();
+	if (!peripheral || peripheral.address() != steps[step].address) {
+		return;
+	}
+	BLE.stopScan();
+	Serial.printf("step %u: %s\n", step, steps[step].address);
+	check("connect", peripheral.connect());
+
+	uint32_t startMs = millis();
+	bool discovered  = peripheral.discoverService("181A");
+	// Without a request to bluenet, no time passes.
+	bool cached      = (millis() == startMs);
+	check("discover", discovered && peripheral.characteristicCount() == 4);
+	check(steps[step].cached ? "cached" : "not cached", cached == steps[step].cached);
+
+	// The handles are the same as when discovered.
+	uint8_t humidity[2];
+	int length = peripheral.characteristic("2A6F").readValue(humidity, sizeof(humidity));
+	check("read", length == 2 && humidity[0] == 0x88 && humidity[1] == 0x13);
+	check("disconnect", peripheral.disconnect());
+
+	step++;
+	if (step == STEP_COUNT - 1) {
+		BLE.clearAttributeCache();
+	}
+	BLE.scan(true);
+}
@@ -0,0 +1,119 @@
+#include <Arduino.h>
+#include <ArduinoBLE.h>
+#include "TestCheck.h"
+
+/**
+ * Tests the async BLE central requests: connect, discover, read, write and read again, each sent from the handler of
+ * the previous one, while the loop keeps running. Afterwards the blocking requests are tested, and async requests
+ * that complete right away: their handlers are called at the end of the loop.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/ble_peripheral.txt, where the emulator acts as the
+ * peripheral.
+ */
+
+const char* peripheralAddress = "A4:C1:38:9A:45:E3";
+
+BleDevice* peripheral = nullptr;
+
+uint8_t temperature[2];
+// 25.00 °C
+uint8_t newTemperature[2] = {0xC4, 0x09};
+uint8_t readBack[2];
+
+bool sequenceDone          = false;
+uint8_t step               = 0;
+uint16_t loopsMeanwhile    = 0;
+uint8_t completedRightAway = 0;
+
+void onReadBack(BleRequestToken token, microapp_sdk_result_t result) {
+	check("read after write", result == CS_MICROAPP_SDK_ACK_SUCCESS && readBack[0] == 0xC4 && readBack[1] == 0x09);
+	sequenceDone = true;
+}
+
+void onWritten(BleRequestToken token, microapp_sdk_result_t result) {
+	check("write", result == CS_MICROAPP_SDK_ACK_SUCCESS);
+	BleCharacteristic& characteristic = peripheral->characteristic("2A6E");
+	BleRequestToken readToken         = characteristic.readValueAsync(readBack, sizeof(readBack), onReadBack);
+	check("readValueAsync", readToken != BLE_REQUEST_TOKEN_NONE);
+}
+
+void onTemperature(BleRequestToken token, microapp_sdk_result_t result) {
+	BleCharacteristic& characteristic = peripheral->characteristic("2A1F");
+	check("read", result == CS_MICROAPP_SDK_ACK_SUCCESS && characteristic.valueLength() == 2 && temperature[0] == 0xE1
+						  && temperature[1] == 0x00);
+	BleCharacteristic& writable = peripheral->characteristic("2A6E");
+	check("writeValueAsync",
+		  writable.writeValueAsync(newTemperature, sizeof(newTemperature), onWritten) != BLE_REQUEST_TOKEN_NONE);
+}
+
+void onDiscovered(BleRequestToken token, microapp_sdk_result_t result) {
+	check("discover", result == CS_MICROAPP_SDK_ACK_SUCCESS && peripheral->characteristicCount() == 4);
+	BleCharacteristic& characteristic = peripheral->characteristic("2A1F");
+	token = characteristic.readValueAsync(temperature, sizeof(temperature), onTemperature);
+	check("pending", token != BLE_REQUEST_TOKEN_NONE && BLE.requestPending(token));
+}
+
+void onCompletedRightAway(BleRequestToken token, microapp_sdk_result_t result) {
+	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
+		completedRightAway++;
+	}
+}
+
+void onConnected(BleRequestToken token, microapp_sdk_result_t result) {
+	check("connect", result == CS_MICROAPP_SDK_ACK_SUCCESS && peripheral->connected());
+	check("discoverServiceAsync", peripheral->discoverServiceAsync("181A", onDiscovered) != BLE_REQUEST_TOKEN_NONE);
+}
+
+void setup() {
+	Serial.println("BLE central async test");
+	if (!BLE.begin()) {
+		check("begin", false);
+		return;
+	}
+	BLE.scanForAddress(peripheralAddress);
+}
+
+void loop() {
+	if (peripheral == nullptr) {
+		BleDevice& device = BLE.available();
+		if (!device) {
+			return;
+		}
+		BLE.stopScan();
+		peripheral = &device;
+		check("connectAsync", device.connectAsync(onConnected) != BLE_REQUEST_TOKEN_NONE);
+		return;
+	}
+	if (!sequenceDone) {
+		loopsMeanwhile++;
+		return;
+	}
+	switch (step++) {
+		case 0: {
+			// One loop per request: connect, discover, read, write and read.
+			check("loop continued", loopsMeanwhile >= 4);
+
+			// The blocking requests use the same path.
+			BleCharacteristic& humidity = peripheral->characteristic("2A6F");
+			uint8_t value[2];
+			check("readValue", humidity.readValue(value, sizeof(value)) == 2 && value[0] == 0x88 && value[1] == 0x13);
+			check("writeValue read only", !humidity.writeValue(value, sizeof(value)));
+			BleCharacteristic& writable = peripheral->characteristic("2A6E");
+			check("writeValue", writable.writeValue(temperature, sizeof(temperature)));
+			check("subscribe", peripheral->characteristic("2A1F").subscribe());
+
+			// Already connected and discovered: the handlers are not called before the tokens are returned.
+			BleRequestToken connectToken  = peripheral->connectAsync(onCompletedRightAway);
+			BleRequestToken discoverToken = peripheral->discoverServiceAsync("181A", onCompletedRightAway);
+			check("completed right away",
+				  BLE.requestPending(connectToken) && BLE.requestPending(discoverToken) && completedRightAway == 0);
+			break;
+		}
+		case 1: {
+			check("completed at end of loop", completedRightAway == 2);
+			check("disconnect", peripheral->disconnect() && !peripheral->connected());
+			break;
+		}
+		default: break;
+	}
+}
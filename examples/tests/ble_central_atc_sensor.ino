@@ -19,6 +19,25 @@ void onConnect(BleDevice& device) {
 	Serial.println(device.address().c_str());
 }
 
+uint8_t temperature[2];
+uint8_t humidity[2];
+
+void onTemperatureRead(BleRequestToken token, microapp_sdk_result_t result) {
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		Serial.println("   Reading temperature failed");
+		return;
+	}
+	Serial.println(temperature, 2);
+}
+
+void onHumidityRead(BleRequestToken token, microapp_sdk_result_t result) {
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		Serial.println("   Reading humidity failed");
+		return;
+	}
+	Serial.println(humidity, 2);
+}
+
 void onNotification(BleDevice& device, BleCharacteristic& characteristic, uint8_t* data, uint16_t size) {
 	Serial.print("   Microapp notification for ");
 	Serial.println(characteristic.uuid());
@@ -77,6 +96,11 @@ void loop() {
 		return;
 	}
 	BleCharacteristic& temperatureCharacteristic = peripheral.characteristic("2A1F");
+	// Read temperature and, if present, 2A6F 'Humidity' at once: the reads are sent back-to-back
+	temperatureCharacteristic.readValueAsync(temperature, sizeof(temperature), onTemperatureRead);
+	if (peripheral.hasCharacteristic("2A6F")) {
+		peripheral.characteristic("2A6F").readValueAsync(humidity, sizeof(humidity), onHumidityRead);
+	}
 	temperatureCharacteristic.setEventHandler(BLENotification, onNotification);
 	// Subscribe to the characteristic so that we get notifications
 	if (!temperatureCharacteristic.subscribe()) {
@@ -0,0 +1,129 @@
+#include <Arduino.h>
+#include <ArduinoBLE.h>
+#include "TestCheck.h"
+
+/**
+ * Tests queued BLE central requests: several reads and a write requested at once are sent one after the other, each
+ * from the event of the previous one, so they take a tick each. Also tests a value that is longer than fits in a
+ * single read event, and one that exactly fills a read event.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/ble_peripheral.txt, where the emulator acts as the
+ * peripheral, and has a Model Number String of 51 bytes. Run it again with MICROAPP_HOST_NO_EMPTY_READ_PART set: the
+ * read of the value that exactly fills a read event then completes after BLE_READ_PART_TIMEOUT_MS.
+ */
+
+const char* peripheralAddress = "A4:C1:38:9A:45:E3";
+
+BleDevice* peripheral = nullptr;
+
+uint8_t temperature[2];
+uint8_t humidity[2];
+char model[64];
+char newModel[] = "Model number written in two parts by the microapp, 0043-B8";
+// Exactly fills a read event.
+char exactModel[] = "Model number of 32 bytes, 0044-C";
+char readBack[64];
+
+// The order in which the requests complete.
+BleRequestToken completed[5];
+uint8_t completedCount = 0;
+BleRequestToken tokens[5];
+
+bool queued             = false;
+bool done               = false;
+uint16_t loopsMeanwhile = 0;
+
+void onCompleted(BleRequestToken token, microapp_sdk_result_t result) {
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		Serial.printf("request %u failed: %u\n", token, result);
+	}
+	completed[completedCount++] = token;
+}
+
+void onReadBack(BleRequestToken token, microapp_sdk_result_t result) {
+	onCompleted(token, result);
+	BleCharacteristic& characteristic = peripheral->characteristic("2A24");
+	check("long write", result == CS_MICROAPP_SDK_ACK_SUCCESS && characteristic.valueLength() == strlen(newModel)
+								&& memcmp(readBack, newModel, strlen(newModel)) == 0);
+	done = true;
+}
+
+void onWritten(BleRequestToken token, microapp_sdk_result_t result) {
+	onCompleted(token, result);
+	BleCharacteristic& characteristic = peripheral->characteristic("2A24");
+	tokens[4] = characteristic.readValueAsync((uint8_t*)readBack, sizeof(readBack), onReadBack);
+}
+
+void onDiscovered(BleRequestToken token, microapp_sdk_result_t result) {
+	check("discover", result == CS_MICROAPP_SDK_ACK_SUCCESS && peripheral->characteristicCount() == 4);
+	// Request everything at once: the requests are sent one after the other.
+	BleCharacteristic& modelNumber = peripheral->characteristic("2A24");
+	tokens[0] = peripheral->characteristic("2A1F").readValueAsync(temperature, sizeof(temperature), onCompleted);
+	tokens[1] = peripheral->characteristic("2A6F").readValueAsync(humidity, sizeof(humidity), onCompleted);
+	tokens[2] = modelNumber.readValueAsync((uint8_t*)model, sizeof(model), onCompleted);
+	tokens[3] = modelNumber.writeValueAsync((uint8_t*)newModel, strlen(newModel), onWritten);
+	check("queued", tokens[0] != BLE_REQUEST_TOKEN_NONE && tokens[1] != BLE_REQUEST_TOKEN_NONE
+							&& tokens[2] != BLE_REQUEST_TOKEN_NONE && tokens[3] != BLE_REQUEST_TOKEN_NONE);
+	token = modelNumber.readValueAsync((uint8_t*)model, sizeof(model), onCompleted);
+	check("queue full", token == BLE_REQUEST_TOKEN_NONE);
+	queued = true;
+}
+
+void onConnected(BleRequestToken token, microapp_sdk_result_t result) {
+	check("connect", result == CS_MICROAPP_SDK_ACK_SUCCESS);
+	peripheral->discoverServiceAsync("181A", onDiscovered);
+}
+
+void setup() {
+	Serial.println("BLE central queue test");
+	if (!BLE.begin()) {
+		check("begin", false);
+		return;
+	}
+	BLE.scanForAddress(peripheralAddress);
+}
+
+void loop() {
+	if (peripheral == nullptr) {
+		BleDevice& device = BLE.available();
+		if (!device) {
+			return;
+		}
+		BLE.stopScan();
+		peripheral = &device;
+		device.connectAsync(onConnected);
+		return;
+	}
+	if (!queued) {
+		return;
+	}
+	if (!done) {
+		loopsMeanwhile++;
+		return;
+	}
+	if (!peripheral->connected()) {
+		return;
+	}
+	check("order", completedCount == 5 && completed[0] == tokens[0] && completed[1] == tokens[1]
+						   && completed[2] == tokens[2] && completed[3] == tokens[3] && completed[4] == tokens[4]);
+	check("read", temperature[0] == 0xE1 && humidity[0] == 0x88 && humidity[1] == 0x13);
+	check("long read", memcmp(model, "Emulated environmental sensor, model number 0042-A7", 51) == 0);
+	// A tick per request, not a loop per request.
+	check("back to back", loopsMeanwhile <= 5);
+
+	// The blocking requests use the same queue.
+	memset(readBack, 0, sizeof(readBack));
+	BleCharacteristic& modelNumber = peripheral->characteristic("2A24");
+	check("readValue long", modelNumber.readValue((uint8_t*)readBack, sizeof(readBack)) == (int)strlen(newModel)
+									&& memcmp(readBack, newModel, strlen(newModel)) == 0);
+	// Only the part that fits in the buffer.
+	memset(readBack, 0, sizeof(readBack));
+	check("readValue truncated", modelNumber.readValue((uint8_t*)readBack, 40) == 40
+										 && memcmp(readBack, newModel, 40) == 0 && readBack[40] == 0);
+	// Ends with an empty part, or the timeout for the next part.
+	memset(readBack, 0, sizeof(readBack));
+	check("readValue exact", modelNumber.writeValue((uint8_t*)exactModel, strlen(exactModel))
+									 && modelNumber.readValue((uint8_t*)readBack, sizeof(readBack)) == (int)strlen(exactModel)
+									 && memcmp(readBack, exactModel, strlen(exactModel)) == 0);
+	check("disconnect", peripheral->disconnect());
+}
@@ -0,0 +1,89 @@
+#include <Arduino.h>
+#include <ArduinoBLE.h>
+#include "TestCheck.h"
+
+/**
+ * Scans without a BLEDeviceScanned event handler, so scanned devices are buffered.
+ *
+ * Every loop, all buffered devices are retrieved via BLE.available(). Devices that arrived while the buffer was full
+ * are counted as dropped. Increase BLE_SCAN_BUFFER_SIZE (via MICROAPP_DEFINES) if that number keeps growing.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/scan_burst.txt, for at least 30 ticks. The devices are told
+ * apart by their RSSI: the buffer should return them in the order of the event file, and drop the ones that do not
+ * fit during the burst.
+ */
+
+const int8_t RSSI_EVERY_TICK       = -60;
+const int8_t RSSI_EVERY_OTHER_TICK = -75;
+const int8_t RSSI_BURST            = -80;
+const uint8_t BURST_SIZE           = 20;
+const uint32_t BURST_FIRST_TICK    = 10;
+const uint32_t BURST_LAST_TICK     = 20;
+const uint32_t CHECK_TICK          = 30;
+
+// Setup runs in tick 0, every loop in the next tick.
+uint32_t tick            = 0;
+uint32_t expectedDropped = 0;
+bool orderOk             = true;
+bool droppedOk           = true;
+bool addressOk           = false;
+
+void setup() {
+	Serial.println("BLE scan buffer test");
+
+	if (!BLE.begin()) {
+		check("begin", false);
+		return;
+	}
+	BLE.scan();
+}
+
+void loop() {
+	tick++;
+	if (tick > CHECK_TICK) {
+		return;
+	}
+
+	// The devices scanned this tick, in the order of the event file.
+	int8_t expected[2 + BURST_SIZE];
+	uint8_t expectedCount     = 0;
+	expected[expectedCount++] = RSSI_EVERY_TICK;
+	if (tick % 2 == 1) {
+		expected[expectedCount++] = RSSI_EVERY_OTHER_TICK;
+	}
+	if (tick >= BURST_FIRST_TICK && tick <= BURST_LAST_TICK) {
+		for (uint8_t i = 0; i < BURST_SIZE; ++i) {
+			expected[expectedCount++] = RSSI_BURST;
+		}
+	}
+	uint8_t bufferedCount = (expectedCount < BLE_SCAN_BUFFER_SIZE) ? expectedCount : BLE_SCAN_BUFFER_SIZE;
+	expectedDropped += expectedCount - bufferedCount;
+
+	uint8_t count = 0;
+	while (true) {
+		BleDevice& device = BLE.available();
+		if (!device) {
+			break;
+		}
+		if (count >= bufferedCount || device.rssi() != expected[count]) {
+			orderOk = false;
+		}
+		if (tick == BURST_FIRST_TICK && device.rssi() == RSSI_BURST) {
+			String address = device.address();
+			addressOk      = (address.length() == 17 && memcmp(address.c_str(), "AA:BB:CC:DD:EE:03", 17) == 0);
+		}
+		count++;
+	}
+	if (count != bufferedCount) {
+		orderOk = false;
+	}
+	if (BLE.droppedScanCount() != expectedDropped) {
+		droppedOk = false;
+	}
+
+	if (tick == CHECK_TICK) {
+		check("order", orderOk);
+		check("address", addressOk);
+		check("dropped", droppedOk && expectedDropped > 0);
+	}
+}
@@ -0,0 +1,75 @@
+#include <Arduino.h>
+#include <ArduinoBLE.h>
+#include "TestCheck.h"
+
+/**
+ * Filters scanned devices in the microapp, on several criteria at once.
+ *
+ * Only devices with one of two addresses, with an RSSI of at least -78 dBm, and with Nordic manufacturer data are
+ * buffered.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/scan_burst.txt, for at least 30 ticks. Of its three devices,
+ * AA:BB:CC:DD:EE:01 (every tick) has no manufacturer data, AA:BB:CC:DD:EE:02 (every other tick) passes, and
+ * AA:BB:CC:DD:EE:03 (a burst of 20 every tick from tick 10 to 20) has a too low RSSI.
+ */
+
+const uint16_t NORDIC_COMPANY_ID = 0x0059;
+const uint32_t CHECK_TICK        = 30;
+
+// Setup runs in tick 0, every loop in the next tick.
+uint32_t tick      = 0;
+uint16_t retrieved = 0;
+bool onlyPassingOk = true;
+
+void setup() {
+	Serial.println("BLE scan filter test");
+
+	if (!BLE.begin()) {
+		check("begin", false);
+		return;
+	}
+	BleScanFilterChain& filters = BLE.scanFilters();
+	check("invalid address", filters.addAddressFilter("AA:BB:CC:DD:EE") == CS_MICROAPP_SDK_ACK_ERR_UNDEFINED);
+	check("add", filters.addAddressFilter("AA:BB:CC:DD:EE:01") == CS_MICROAPP_SDK_ACK_SUCCESS
+						 && filters.addAddressFilter("AA:BB:CC:DD:EE:02") == CS_MICROAPP_SDK_ACK_SUCCESS
+						 && filters.addRssiFilter(-78) == CS_MICROAPP_SDK_ACK_SUCCESS
+						 && filters.addManufacturerDataFilter(NORDIC_COMPANY_ID) == CS_MICROAPP_SDK_ACK_SUCCESS);
+	check("full", filters.addRssiFilter(-90) == CS_MICROAPP_SDK_ACK_ERR_NO_SPACE && filters.filterCount() == 4);
+	BLE.scan(true);
+}
+
+void loop() {
+	tick++;
+	while (true) {
+		BleDevice& device = BLE.available();
+		if (!device) {
+			break;
+		}
+		if (device.rssi() != -75) {
+			onlyPassingOk = false;
+		}
+		retrieved++;
+	}
+	if (tick != CHECK_TICK) {
+		return;
+	}
+
+	// Number of scans of each device up to and including this tick.
+	uint16_t everyTick      = tick;
+	uint16_t everyOtherTick = (tick + 1) / 2;
+	uint16_t burst          = 20 * (20 - 10 + 1);
+
+	BleScanFilterChain& filters = BLE.scanFilters();
+	check("retrieved", onlyPassingOk && retrieved == everyOtherTick);
+	// Filters on the same field are or-ed: the first one that matches gets the hit.
+	check("address hits", filters.hitCount(0) == everyTick && filters.hitCount(1) == everyOtherTick);
+	check("rssi hits", filters.hitCount(2) == everyTick + everyOtherTick);
+	check("manufacturer data hits", filters.hitCount(3) == everyOtherTick);
+	// Once a field does not match, the other fields are not evaluated.
+	check("rejected", filters.rejectedCount() == everyTick + burst);
+
+	filters.resetCounters();
+	check("reset", filters.hitCount(0) == 0 && filters.rejectedCount() == 0);
+	filters.clear();
+	check("clear", filters.filterCount() == 0);
+}
@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include "TestCheck.h"
+
+/**
+ * Logs at every level.
+ *
+ * Build with for example MICROAPP_DEFINES="-DMICROAPP_LOG_LEVEL=MICROAPP_LOG_WARN" to compile out the debug and info
+ * logs, and the calls to Serial. Add -DMICROAPP_LOG_INTERNED to send the logs with the id of the format string instead
+ * of the text, and decode them with scripts/microapp_log_strings.py.
+ *
+ * The checks hold at every log level. With the default level, also check the printed text against log_levels.expected,
+ * which holds the output of setup and 1 loop (setup is throttled for a tick):
+ *   make host TARGET_NAME=log_levels TARGET_SOURCE=examples/tests/log_levels.ino
+ *   MICROAPP_HOST_TICKS=3 build/log_levels_host 2>/dev/null | diff examples/tests/log_levels.expected - \
+ *     && echo OK || echo FAIL
+ */
+
+uint32_t counter = 0;
+
+// Number of times the arguments of a log at each level were evaluated.
+uint8_t evaluated[4] = {0};
+
+uint8_t evaluate(uint8_t index) {
+	return ++evaluated[index];
+}
+
+void setup() {
+	Serial.println("Log levels test");
+	LOGi("Log level: %i", MICROAPP_LOG_LEVEL);
+
+	LOGd("evaluated %u", evaluate(0));
+	LOGi("evaluated %u", evaluate(1));
+	LOGw("evaluated %u", evaluate(2));
+	LOGe("evaluated %u", evaluate(3));
+	// Logs below the log level are compiled out, including their arguments.
+	bool compiledOutOk = true;
+	for (uint8_t i = 0; i < 4; ++i) {
+		uint8_t expected = (MICROAPP_LOG_LEVEL <= MICROAPP_LOG_DEBUG + i) ? 1 : 0;
+		if (evaluated[i] != expected) {
+			compiledOutOk = false;
+		}
+	}
+	check("compiled out", compiledOutOk);
+	check("serial", (bool)Serial == (MICROAPP_LOG_LEVEL <= MICROAPP_LOG_INFO));
+}
+
+void loop() {
+	counter++;
+	LOGd("debug: counter=%u", (unsigned int)counter);
+	LOGi("info: temperature=%.2f", 20.0f + counter * 0.25f);
+	LOGw("warn: name=%s id=%04X", "crownstone", 0xC5);
+	LOGe("error: code=%d", -(int)counter);
+}
@@ -0,0 +1,65 @@
+#include <Arduino.h>
+#include <Mesh.h>
+#include "TestCheck.h"
+
+/**
+ * Polls for mesh messages, which are buffered in the order in which they are received.
+ *
+ * When more messages are received between two polls than fit in the buffer (MESH_MSG_BUFFER_LEN), either the oldest
+ * or the new ones are dropped, depending on the drop policy.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/mesh_order.txt, for at least 10 ticks. It sends numbered
+ * messages: 3 at tick 3, and 12 at tick 6 and 9, when the oldest and the new ones are dropped respectively.
+ */
+
+const uint8_t BURST_SIZE = 12;
+
+// Setup runs in tick 0, every loop in the next tick.
+uint32_t tick = 0;
+
+void setup() {
+	Serial.println("Mesh buffer test");
+
+	Mesh.setDropPolicy(MeshDropOldest);
+	if (!Mesh.listen()) {
+		check("listen", false);
+	}
+}
+
+/**
+ * Read all buffered messages, and check that they are numbered from first to last, from the given stone.
+ */
+bool readInOrder(uint8_t stoneId, uint8_t first, uint8_t last) {
+	bool result    = true;
+	uint8_t number = first;
+	while (Mesh.available()) {
+		MeshMsg msg;
+		Mesh.readMeshMsg(&msg);
+		if (msg.stoneId != stoneId || msg.size != 1 || msg.dataPtr[0] != number) {
+			result = false;
+		}
+		number++;
+	}
+	return result && number == last + 1;
+}
+
+void loop() {
+	tick++;
+	uint8_t dropCount = (BURST_SIZE > MESH_MSG_BUFFER_LEN) ? BURST_SIZE - MESH_MSG_BUFFER_LEN : 0;
+	switch (tick) {
+		case 3: {
+			check("order", readInOrder(3, 1, 3) && Mesh.droppedCount() == 0);
+			break;
+		}
+		case 6: {
+			check("drop oldest", readInOrder(4, 1 + dropCount, BURST_SIZE) && Mesh.droppedCount() == dropCount);
+			Mesh.setDropPolicy(MeshDropNew);
+			break;
+		}
+		case 9: {
+			check("drop new", readInOrder(4, 1, BURST_SIZE - dropCount) && Mesh.droppedCount() == 2 * dropCount);
+			break;
+		}
+		default: break;
+	}
+}
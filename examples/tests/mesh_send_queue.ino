@@ -0,0 +1,67 @@
+#include <Arduino.h>
+#include <Mesh.h>
+#include "TestCheck.h"
+
+/**
+ * Replies to every incoming mesh message from the mesh handler.
+ *
+ * Since the handler is called from an interrupt, the replies are queued and sent in a single batch at the end of the
+ * loop, instead of one by one from within the handler. When more replies are queued than fit (MESH_SEND_QUEUE_LEN),
+ * sendMeshMsg() reports back-pressure and the reply is skipped, instead of waiting for bluenet.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/mesh_burst.txt, for at least 30 ticks. It sends a message
+ * from stone 2 every tick, and a burst of 10 from stone 3 every 10 ticks, starting at tick 5.
+ */
+
+const uint8_t BURST_SIZE  = 10;
+const uint32_t CHECK_TICK = 30;
+
+// Setup runs in tick 0, every loop in the next tick.
+uint32_t tick         = 0;
+uint16_t skippedCount = 0;
+uint16_t burstCount   = 0;
+bool queuedOk         = true;
+
+void onMeshMsg(MeshMsg msg) {
+	uint8_t reply[2] = {0xAC, msg.size};
+	if (Mesh.sendMeshMsg(reply, sizeof(reply), msg.stoneId, true) != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		skippedCount++;
+	}
+}
+
+void setup() {
+	Serial.println("Mesh send queue test");
+
+	Mesh.setIncomingMeshMsgHandler(onMeshMsg);
+	if (!Mesh.listen()) {
+		check("listen", false);
+	}
+}
+
+void loop() {
+	tick++;
+	if (tick > CHECK_TICK) {
+		return;
+	}
+
+	// The replies of the previous loop were sent at the end of that loop.
+	uint8_t received = 1;
+	if (tick % 10 == 5) {
+		received += BURST_SIZE;
+		burstCount++;
+	}
+	uint8_t expected = (received < MESH_SEND_QUEUE_LEN) ? received : MESH_SEND_QUEUE_LEN;
+	if (Mesh.queuedMeshMsgCount() != expected) {
+		queuedOk = false;
+	}
+
+	if (tick == CHECK_TICK) {
+		check("queued", queuedOk);
+		check("skipped", skippedCount == burstCount * (1 + BURST_SIZE - MESH_SEND_QUEUE_LEN));
+
+		// Outside of an interrupt handler, the queued messages are sent first.
+		uint8_t msg[1] = {0xAD};
+		check("send from loop", Mesh.sendMeshMsg(msg, sizeof(msg)) == CS_MICROAPP_SDK_ACK_SUCCESS);
+		check("queue sent first", Mesh.queuedMeshMsgCount() == 0);
+	}
+}
@@ -0,0 +1,126 @@
+#include <Arduino.h>
+#include <MeshTransport.h>
+#include "TestCheck.h"
+
+/**
+ * Sends and receives messages via the mesh transport.
+ *
+ * At tick 10, a few small messages are sent packed together in mesh frames, and a larger message in fragments,
+ * followed by a lone small message, which is sent at the end of the loop. Received messages are checked, whether they
+ * were packed or fragmented.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/mesh_transport.txt, for at least 20 ticks.
+ */
+
+const uint32_t SEND_TICK   = 10;
+const uint32_t CHECK_TICK  = 20;
+const uint8_t MAX_RECEIVED = 8;
+const uint8_t LARGE_SIZE   = 20;
+const uint8_t SMALL_SIZE   = 2;
+
+struct ReceivedMsg {
+	uint8_t stoneId;
+	uint8_t size;
+	uint8_t data[MESH_TRANSPORT_MAX_MESSAGE_SIZE];
+};
+
+// Setup runs in tick 0, every loop in the next tick.
+uint32_t tick = 0;
+ReceivedMsg received[MAX_RECEIVED];
+uint8_t receivedCount   = 0;
+uint16_t sentFrameCount = 0;
+
+void onMessage(MeshMsg msg) {
+	if (receivedCount < MAX_RECEIVED) {
+		received[receivedCount].stoneId = msg.stoneId;
+		received[receivedCount].size    = msg.size;
+		memcpy(received[receivedCount].data, msg.dataPtr, msg.size);
+	}
+	receivedCount++;
+}
+
+bool isReceived(uint8_t index, uint8_t stoneId, const uint8_t* data, uint8_t size) {
+	if (index >= receivedCount || index >= MAX_RECEIVED) {
+		return false;
+	}
+	ReceivedMsg& msg = received[index];
+	return msg.stoneId == stoneId && msg.size == size && memcmp(msg.data, data, size) == 0;
+}
+
+/**
+ * Get the number of fragments of a message that does not fit in a single frame.
+ */
+uint8_t getFragmentCount(uint8_t size) {
+	if (size <= MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE) {
+		return 1;
+	}
+	return 1
+		   + (size - MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE + MESH_TRANSPORT_FRAGMENT_DATA_SIZE - 1)
+					 / MESH_TRANSPORT_FRAGMENT_DATA_SIZE;
+}
+
+void setup() {
+	Serial.println("Mesh transport test");
+
+	if (!MeshTransport.listen(onMessage)) {
+		check("listen", false);
+	}
+}
+
+void sendMessages() {
+	// Three small messages, of which two fit in a single frame.
+	uint8_t small[SMALL_SIZE] = {0xAB, 0x01};
+	bool sendOk               = true;
+	for (uint8_t i = 0; i < 3; ++i) {
+		small[0] = 0xA0 + i;
+		sendOk   = sendOk && MeshTransport.send(small, sizeof(small)) == CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	MeshTransport.flush();
+	uint8_t recordsPerFrame = (MAX_MICROAPP_MESH_PAYLOAD_SIZE - 1) / (1 + SMALL_SIZE);
+	uint16_t expected       = (3 + recordsPerFrame - 1) / recordsPerFrame;
+	check("packed", sendOk && MeshTransport.sentFrameCount() == expected);
+
+	uint8_t large[LARGE_SIZE];
+	for (uint8_t i = 0; i < sizeof(large); ++i) {
+		large[i] = i;
+	}
+	sendOk = MeshTransport.send(large, sizeof(large)) == CS_MICROAPP_SDK_ACK_SUCCESS;
+	expected += getFragmentCount(LARGE_SIZE);
+	check("fragmented", sendOk && MeshTransport.sentFrameCount() == expected);
+
+	uint8_t tooLarge[MESH_TRANSPORT_MAX_MESSAGE_SIZE + 1] = {0};
+	check("too large", MeshTransport.send(tooLarge, sizeof(tooLarge)) == CS_MICROAPP_SDK_ACK_ERR_NO_SPACE);
+	check("empty", MeshTransport.send(small, 0) == CS_MICROAPP_SDK_ACK_ERR_EMPTY);
+
+	// Not flushed: sent at the end of the loop.
+	small[0] = 0xAF;
+	MeshTransport.send(small, sizeof(small));
+	check("pending", MeshTransport.sentFrameCount() == expected);
+	sentFrameCount = expected + 1;
+}
+
+void loop() {
+	tick++;
+	if (tick == SEND_TICK) {
+		sendMessages();
+	}
+	if (tick == SEND_TICK + 1) {
+		check("flushed at end of loop", MeshTransport.sentFrameCount() == sentFrameCount);
+	}
+	if (tick != CHECK_TICK) {
+		return;
+	}
+
+	// In the order of host/events/mesh_transport.txt.
+	const uint8_t records[2][2] = {{0xAA, 0xBB}, {0x01, 0x02}};
+	check("records", isReceived(0, 4, records[0], 2) && isReceived(1, 4, records[1], 2));
+	uint8_t reassembled[14];
+	for (uint8_t i = 0; i < sizeof(reassembled); ++i) {
+		reassembled[i] = i + 1;
+	}
+	check("reassembled out of order", isReceived(2, 5, reassembled, sizeof(reassembled)));
+	const uint8_t afterTimeout[8] = {0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00, 0x11};
+	check("reassembled after timeout", isReceived(3, 5, afterTimeout, sizeof(afterTimeout)));
+	check("received", receivedCount == 4);
+	check("dropped", MeshTransport.droppedMsgCount() == 1);
+}
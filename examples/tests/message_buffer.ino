@@ -0,0 +1,68 @@
+#include <Arduino.h>
+#include <Message.h>
+#include "TestCheck.h"
+
+/**
+ * Reads newline terminated lines from received messages.
+ *
+ * Received messages are buffered, so a line can be split over multiple messages, and a message can contain multiple
+ * lines. When a burst of messages does not fit in the buffer (MESSAGE_RECEIVE_BUFFER_SIZE), the part that fits is
+ * kept, and the rest is dropped.
+ *
+ * Run it on the host (see docs/HOST.md) with host/events/message_lines.txt, for at least 10 ticks.
+ */
+
+const char* BURST_LINE       = "012345678901234";
+const uint8_t BURST_SIZE     = 12;
+const uint8_t BURST_LINE_LEN = 16;
+const uint32_t CHECK_TICK    = 10;
+
+// The lines before the burst, in the order of host/events/message_lines.txt.
+const char* LINES[]      = {"on", "off", "toggle"};
+const uint8_t LINE_COUNT = sizeof(LINES) / sizeof(LINES[0]);
+
+// Setup runs in tick 0, every loop in the next tick.
+uint32_t tick = 0;
+char line[32];
+microapp_size_t lineSize = 0;
+uint8_t lineCount        = 0;
+bool linesOk             = true;
+
+void setup() {
+	Serial.println("Message buffer test");
+
+	Message.setAcceptPolicy(MessageAcceptPartial);
+	if (!Message.begin()) {
+		check("begin", false);
+	}
+}
+
+void checkLine() {
+	const char* expected = (lineCount < LINE_COUNT) ? LINES[lineCount] : BURST_LINE;
+	if (lineSize != strlen(expected) || memcmp(line, expected, lineSize) != 0) {
+		linesOk = false;
+	}
+	lineCount++;
+}
+
+void loop() {
+	tick++;
+	int value;
+	while ((value = Message.read()) >= 0) {
+		if (value != '\n' && lineSize < sizeof(line) - 1) {
+			line[lineSize++] = value;
+			continue;
+		}
+		checkLine();
+		lineSize = 0;
+	}
+	if (tick != CHECK_TICK) {
+		return;
+	}
+
+	// The burst is received while the buffer is empty: the part that fits is kept.
+	microapp_size_t burstBytes = BURST_SIZE * BURST_LINE_LEN;
+	microapp_size_t keptBytes  = (burstBytes < MESSAGE_RECEIVE_BUFFER_SIZE) ? burstBytes : MESSAGE_RECEIVE_BUFFER_SIZE;
+	check("lines", linesOk && lineCount == LINE_COUNT + keptBytes / BURST_LINE_LEN);
+	check("dropped", Message.droppedByteCount() == burstBytes - keptBytes);
+}
@@ -0,0 +1,47 @@
+#include <Arduino.h>
+#include <Message.h>
+#include "TestCheck.h"
+
+/**
+ * Sends frames that are larger than a single message, written in small chunks.
+ *
+ * Every 5 loops, a frame of 101 bytes, counting up from 0, is sent. The frame is written in chunks of 10 bytes, but
+ * sent in full messages. Use scripts/MessageFrameReassembler.py to reassemble the frames on the receiving side.
+ *
+ * Run it on the host (see docs/HOST.md) with MICROAPP_HOST_MESSAGES set, for at least 15 ticks, and check the
+ * reassembled frames with:
+ *   scripts/MessageFrameReassembler.py --expected-size 101 <messages file>
+ */
+
+const uint8_t FRAME_SIZE = 101;
+const uint8_t CHUNK_SIZE = 10;
+
+// Setup runs in tick 0, every loop in the next tick.
+uint32_t tick = 0;
+
+void setup() {
+	Serial.println("Message frames test");
+
+	check("chunk without frame", Message.writeChunk(&tick, 1) == 0 && !Message.endFrame());
+}
+
+void loop() {
+	tick++;
+	if (tick % 5 != 0 || tick > 15) {
+		return;
+	}
+	uint8_t chunk[CHUNK_SIZE];
+	bool begun              = Message.beginFrame();
+	bool nested             = Message.beginFrame();
+	microapp_size_t written = 0;
+	for (uint8_t offset = 0; offset < FRAME_SIZE; offset += CHUNK_SIZE) {
+		uint8_t size = (FRAME_SIZE - offset < CHUNK_SIZE) ? FRAME_SIZE - offset : CHUNK_SIZE;
+		for (uint8_t i = 0; i < size; ++i) {
+			chunk[i] = offset + i;
+		}
+		written += Message.writeChunk(chunk, size);
+	}
+	check("begin", begun && !nested);
+	check("write", written == FRAME_SIZE);
+	check("end", Message.endFrame());
+}
@@ -0,0 +1,49 @@
+#include <Arduino.h>
+
+/**
+ * Prints formatted text, and compares the number of yields of line buffered and unbuffered prints.
+ *
+ * Each loop prints the same line in three ways:
+ * - With print() and println() in line buffered mode: the line is sent in a single log.
+ * - With printf(): the line is sent in a single log.
+ * - With print() and println() without buffering: each call is a separate log.
+ *
+ * Check the printed text against serial_printf.expected, which holds the output of setup and 2 loops:
+ *   make host TARGET_NAME=serial_printf TARGET_SOURCE=examples/tests/serial_printf.ino
+ *   MICROAPP_HOST_TICKS=3 build/serial_printf_host 2>/dev/null | diff examples/tests/serial_printf.expected - \
+ *     && echo OK || echo FAIL
+ */
+
+uint32_t counter = 0;
+
+void setup() {
+	Serial.println("Serial printf test");
+	Serial.printf("%d|%5d|%-5d|%05d|%u|%x|%X|%c|%s|%%\n", -42, 42, 42, -42, 42u, 0xbeef, 0xbeef, 'c', "str");
+	Serial.printf("%f|%.2f|%.0f|%8.3f|%08.3f\n", 3.14159, -2.005, 2.7, 3.14159, -3.14159);
+	Serial.printf("A line that is longer than fits in a single log, which is split over multiple logs.\n");
+
+	// A newline character ends the line only once.
+	Serial.setLineBuffered(true);
+	Serial.print("newline character");
+	Serial.println('\n');
+	Serial.setLineBuffered(false);
+}
+
+void loop() {
+	counter++;
+	float temperature = 20.0f + counter * 0.25f;
+
+	Serial.setLineBuffered(true);
+	Serial.print("buffered: temp=");
+	Serial.print(temperature);
+	Serial.print(" count=");
+	Serial.println((int)counter);
+
+	Serial.printf("printf: temp=%.2f count=%lu\n", temperature, (unsigned long)counter);
+
+	Serial.setLineBuffered(false);
+	Serial.print("unbuffered: temp=");
+	Serial.print(temperature);
+	Serial.print(" count=");
+	Serial.println((int)counter);
+}
@@ -0,0 +1,53 @@
+#include <Arduino.h>
+#include <BleMacAddress.h>
+#include <BleUuid.h>
+#include "TestCheck.h"
+
+/**
+ * Tests String, FixedString and StringView.
+ */
+
+void setup() {
+	Serial.println("Strings test");
+
+	String str("temperature");
+	str += '=';
+	str += 21;
+	str += ' ';
+	str.concat(20.5f, 1);
+	Serial.println(str);
+	check("concat", str == "temperature=21 20.5");
+	check("length", str.length() == 19);
+
+	check("indexOf", str.indexOf('=') == 11 && str.indexOf("21") == 12 && str.indexOf('x') == -1);
+	check("lastIndexOf", str.lastIndexOf('e') == 10);
+	check("substring", str.substring(0, 4) == "temp" && str.substring(15) == "20.5");
+	check("startsWith", str.startsWith("temp") && !str.startsWith("pressure"));
+	check("endsWith", str.endsWith(".5") && !str.endsWith("0"));
+	check("compareTo", str.compareTo("temperature") > 0 && String("a").compareTo("b") < 0);
+	check("charAt", str.charAt(0) == 't' && str[str.length()] == 0);
+
+	// Text that does not fit is cut off.
+	FixedString<8> small("1234");
+	bool fits = small.concat("56789");
+	check("capacity", !fits && small == "12345678");
+
+	// Literals longer than MAX_STRING_SIZE are not cut off at that size.
+	String longText("A literal of fifty characters, longer than one log");
+	check("long literal", longText.length() == 50 && longText.endsWith("one log"));
+
+	// The result of + has the capacity of the left side.
+	FixedString<32> sum = FixedString<32>(small) + '-' + 9;
+	check("operator+", sum == "12345678-9" && small == "12345678");
+
+	// Strings returned by the BLE classes no longer share a static buffer.
+	UuidString uuid1 = Uuid("181A").string();
+	UuidString uuid2 = Uuid("2A6E").string();
+	check("uuid", uuid1 == "181A" && uuid2 == "2A6E");
+	MacAddressString address1 = MacAddress("01:23:45:67:89:AB").string();
+	MacAddressString address2 = MacAddress("CD:EF:01:23:45:67").string();
+	check("address", address1 == "01:23:45:67:89:AB" && address2 == "CD:EF:01:23:45:67");
+	check("uninitialized", Uuid().string().isEmpty() && MacAddress().string().isEmpty());
+}
+
+void loop() {}
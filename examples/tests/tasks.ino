@@ -0,0 +1,52 @@
+#include <Arduino.h>
+#include "TestCheck.h"
+
+/**
+ * Tests cooperative tasks: two tasks and the loop wait in delay() at different rates, and share the yields to bluenet.
+ *
+ * The loop waits 3 intervals at a time, the sensor task polls every interval, and the blink task toggles a led every 2
+ * intervals, logging from its own stack.
+ */
+
+uint32_t sensorCount = 0;
+uint32_t blinkCount  = 0;
+int8_t sensorTask    = TASK_ID_NONE;
+
+void pollSensor() {
+	// Finishes after 6 polls.
+	for (int i = 0; i < 6; ++i) {
+		sensorCount++;
+		Serial.printf("poll %u at tick %u\n", sensorCount, getLoopTickCount());
+		delay(MICROAPP_LOOP_INTERVAL_MS);
+	}
+}
+
+void blink() {
+	bool on = false;
+	while (true) {
+		on = !on;
+		digitalWrite(LED1_PIN, on ? HIGH : LOW);
+		blinkCount++;
+		Serial.printf("blink %u at tick %u\n", blinkCount, getLoopTickCount());
+		delay(2 * MICROAPP_LOOP_INTERVAL_MS);
+	}
+}
+
+void setup() {
+	Serial.println("Tasks test");
+	sensorTask = Tasks.start(pollSensor);
+	check("start", sensorTask != TASK_ID_NONE && Tasks.start(blink) != TASK_ID_NONE);
+	check("max count", Tasks.start(blink) == TASK_ID_NONE);
+	check("main", !Tasks.inTask() && Tasks.current() == TASK_ID_MAIN);
+}
+
+void loop() {
+	static int loopCount = 0;
+	uint32_t tick        = getLoopTickCount();
+	delay(3 * MICROAPP_LOOP_INTERVAL_MS);
+	Serial.printf("loop waited %u ticks\n", getLoopTickCount() - tick);
+	if (++loopCount == 3) {
+		check("sensor task finished", sensorCount == 6 && !Tasks.isRunning(sensorTask));
+		check("blink task running", blinkCount >= 5);
+	}
+}
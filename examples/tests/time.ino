@@ -0,0 +1,45 @@
+#include <Arduino.h>
+#include "TestCheck.h"
+
+/**
+ * Tests millis(), micros() and delay().
+ *
+ * Delays are never shorter than requested, and are rounded up to whole loop intervals (MICROAPP_LOOP_INTERVAL_MS):
+ * on the host, the measured delays should match that exactly. Also run it with bluenet versions that do not support
+ * time requests, then the time is estimated from the loop ticks.
+ */
+
+// Delay, and check the measured time.
+void checkDelay(const char* name, uint32_t delayMs, uint32_t expectedMs) {
+	unsigned long start = millis();
+	delay(delayMs);
+	unsigned long elapsed = millis() - start;
+	Serial.printf("delay(%u) took %lu ms\n", delayMs, elapsed);
+	check(name, elapsed >= delayMs && elapsed == expectedMs);
+}
+
+void setup() {
+	Serial.println("Time test");
+	unsigned long startMicros = micros();
+	unsigned long startMillis = millis();
+	check("micros", startMicros / 1000 == startMillis || startMicros / 1000 + 1 == startMillis);
+}
+
+void loop() {
+	static bool done = false;
+	if (done) {
+		return;
+	}
+	done = true;
+
+	checkDelay("short delay", MICROAPP_LOOP_INTERVAL_MS / 4, MICROAPP_LOOP_INTERVAL_MS);
+	checkDelay("delay", MICROAPP_LOOP_INTERVAL_MS, MICROAPP_LOOP_INTERVAL_MS);
+	checkDelay("rounded delay", 3 * MICROAPP_LOOP_INTERVAL_MS / 2, 2 * MICROAPP_LOOP_INTERVAL_MS);
+
+	// Time advances within a tick too, when bluenet supports time requests.
+	unsigned long before = micros();
+	digitalWrite(LED1_PIN, HIGH);
+	unsigned long after = micros();
+	Serial.printf("digitalWrite took %lu us\n", after - before);
+	check("monotonic", after >= before);
+}
@@ -0,0 +1,50 @@
+#include <Arduino.h>
+#include "TestCheck.h"
+
+/**
+ * Tests the timers: two periodic tasks and a one-shot share the loop, which does nothing itself.
+ *
+ * Every loop tick (MICROAPP_LOOP_INTERVAL_MS) the fast task runs, every 3 ticks the slow task runs, and the fast task
+ * is cancelled after 5 runs by the one-shot timer.
+ */
+
+uint32_t fastCount = 0;
+uint32_t slowCount = 0;
+int8_t fastTimer   = TIMER_ID_NONE;
+int8_t slowTimer   = TIMER_ID_NONE;
+uint32_t startTick = 0;
+
+void fastTask() {
+	fastCount++;
+	Serial.printf("fast %u at tick %u\n", fastCount, getLoopTickCount() - startTick);
+}
+
+void slowTask() {
+	slowCount++;
+	Serial.printf("slow %u at tick %u\n", slowCount, getLoopTickCount() - startTick);
+	if (slowCount == 3) {
+		check("fast count", fastCount == 5 && !Timer.isScheduled(fastTimer));
+		check("cancel", Timer.cancel(slowTimer) && !Timer.isScheduled(slowTimer));
+	}
+}
+
+void stopFastTask() {
+	check("after", getLoopTickCount() - startTick == 5 && fastCount == 5);
+	Timer.cancel(fastTimer);
+}
+
+void setup() {
+	Serial.println("Timer test");
+	startTick          = getLoopTickCount();
+	int8_t placeholder = Timer.after(MICROAPP_LOOP_INTERVAL_MS, stopFastTask);
+	fastTimer          = Timer.every(MICROAPP_LOOP_INTERVAL_MS / 2, fastTask);
+	slowTimer          = Timer.every(3 * MICROAPP_LOOP_INTERVAL_MS, slowTask);
+	Timer.cancel(placeholder);
+	// Due at the same tick as the 5th call of the fast task, but scheduled later: runs after it, even though it gets
+	// the lower id of the cancelled placeholder.
+	int8_t stopTimer = Timer.after(5 * MICROAPP_LOOP_INTERVAL_MS, stopFastTask);
+	check("schedule", stopTimer != TIMER_ID_NONE && stopTimer < fastTimer);
+	check("invalid", !Timer.cancel(TIMER_MAX_COUNT) && Timer.after(100, nullptr) == TIMER_ID_NONE);
+}
+
+void loop() {}
@@ -0,0 +1,58 @@
+#include <Arduino.h>
+#include "TestCheck.h"
+
+/**
+ * Tests combined TWI transactions, with a device that has registers, like most sensors.
+ *
+ * A register address followed by a read is done in a single yield, and so are several writes in a batch.
+ * Run it on the host (see docs/HOST.md), where every address is such a device: the statistics show the number of
+ * requests and batches.
+ */
+
+const uint8_t ADDRESS = 0x18;
+
+void setup() {
+	Serial.println("TWI transactions test");
+	Wire.begin();
+
+	// Write the register address and data as a single write.
+	Wire.beginTransmission(ADDRESS);
+	Wire.write(0x10);
+	Wire.write(0xAB);
+	Wire.write(0xCD);
+	check("endTransmission", Wire.endTransmission() == 0);
+
+	// Register address and read in a single yield.
+	uint8_t buf[2];
+	int length = Wire.writeThenRead(ADDRESS, 0x10, buf, sizeof(buf));
+	check("writeThenRead", length == 2 && buf[0] == 0xAB && buf[1] == 0xCD);
+
+	// The Arduino way: a repeated start, without releasing the bus.
+	Wire.beginTransmission(ADDRESS);
+	Wire.write(0x11);
+	Wire.endTransmission(false);
+	length = Wire.requestFrom(ADDRESS, 1, true);
+	check("repeated start", length == 1 && Wire.available() == 1 && Wire.read() == 0xCD);
+
+	// Several writes in a single yield.
+	beginBatch();
+	for (uint8_t reg = 0x20; reg < 0x24; ++reg) {
+		Wire.beginTransmission(ADDRESS);
+		Wire.write(reg);
+		Wire.write(reg + 1);
+		Wire.endTransmission();
+	}
+	check("batch", commitBatch() == CS_MICROAPP_SDK_ACK_SUCCESS);
+	uint8_t values[4];
+	length = Wire.writeThenRead(ADDRESS, 0x20, values, sizeof(values));
+	check("batched writes", length == 4 && values[0] == 0x21 && values[3] == 0x24);
+
+	// Too many bytes for a single write: nothing is sent.
+	Wire.beginTransmission(ADDRESS);
+	for (int i = 0; i <= WIRE_MAX_PAYLOAD_LENGTH; ++i) {
+		Wire.write((uint8_t)i);
+	}
+	check("too long", Wire.endTransmission() == 1);
+}
+
+void loop() {}
@@ -0,0 +1,947 @@
+/**
+ * Bluenet emulator.
+ *
+ * Stand-in for the bluenet side of the microapp interface, so that the SDK and an example can be built and run on a
+ * host (Linux) machine. It provides getRamData() and a microappCallback that handles the requests in the shared io
+ * buffers the same way bluenet would, and injects interrupts (scans, mesh messages, pins, messages) read from a
+ * scripted event file. A remote peripheral with an Environmental Sensing service can be connected to as central.
+ *
+ * There is no coroutine: a yield to bluenet is simply a function call that returns once bluenet would have resumed the
+ * microapp. Interrupts are delivered one at a time from within that call, so the microapp handles them in
+ * handleBluenetInterrupt() exactly as it does on hardware.
+ *
+ * Configuration is done via environment variables:
+ *   MICROAPP_HOST_EVENTS       Path to an event file (see docs/HOST.md for the format).
+ *   MICROAPP_HOST_TICKS        Number of ticks to run before exiting (default 100).
+ *   MICROAPP_HOST_CALL_LIMIT   Max number of consecutive requests per tick before throttling (default 8).
+ *   MICROAPP_HOST_QUIET        When set, do not print microapp logs.
+ *   MICROAPP_HOST_NO_BATCH     When set, batches are not supported, like in bluenet versions without batches.
+ *   MICROAPP_HOST_NO_TIME      When set, time requests are not supported, like in bluenet versions without them. When
+ *                              set to "unanswered", the request is left unanswered instead of rejected.
+ *   MICROAPP_HOST_NO_EMPTY_READ_PART
+ *                              When set, a read of a value that fills its last part does not end with an empty part,
+ *                              to test the timeout for the next part.
+ *   MICROAPP_HOST_MESSAGES     Path to a file to which messages sent by the microapp are written, one per line in hex.
+ *
+ * At exit, statistics are printed to stderr.
+ *
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <cs_MicroappStructs.h>
+#include <ipc/cs_IpcRamData.h>
+#include <microapp_batch.h>
+#include <microapp_time.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+const uint8_t EMULATOR_STONE_ID     = 1;
+const uint16_t MAX_EVENTS           = 1024;
+const uint8_t MAX_EVENT_DATA_LENGTH = 64;
+const uint8_t NUMBER_OF_TYPES       = 32;
+const uint8_t NUMBER_OF_PINS        = 32;
+const uint16_t NUMBER_OF_REGISTERS  = 256;
+
+// Time that passes with every request within a tick, in microseconds.
+const uint32_t REQUEST_DURATION_US = 100;
+
+const uint8_t MAX_CENTRAL_EVENTS          = 8;
+const uint8_t MAX_GATT_VALUE_LENGTH       = 64;
+const uint8_t NUMBER_OF_CHARACTERISTICS   = 4;
+const uint16_t GATT_SERVICE_UUID          = 0x181A;
+
+enum EventType {
+	EVENT_SCAN = 0,
+	EVENT_MESH,
+	EVENT_PIN,
+	EVENT_MESSAGE,
+};
+
+/**
+ * A scripted event: delivered 'count' times per tick on the ticks [firstTick, lastTick] with step 'period'.
+ */
+struct event_t {
+	EventType type;
+	uint32_t firstTick;
+	uint32_t lastTick;
+	uint32_t period;
+	uint16_t count;
+	uint8_t id;  // stone id for mesh, pin number for pin
+	uint8_t address[MAC_ADDRESS_LENGTH];
+	int8_t rssi;
+	uint8_t size;
+	uint8_t data[MAX_EVENT_DATA_LENGTH];
+};
+
+/**
+ * A characteristic of the emulated remote peripheral.
+ */
+struct gatt_characteristic_t {
+	uint16_t uuid;
+	uint16_t valueHandle;
+	uint16_t cccdHandle;
+	microapp_sdk_ble_characteristic_options_t options;
+	uint8_t size;
+	uint8_t value[MAX_GATT_VALUE_LENGTH];
+};
+
+/**
+ * An event with the result of a central request, delivered at the start of a later tick.
+ */
+struct central_event_t {
+	uint32_t tick;
+	microapp_sdk_ble_central_t central;
+};
+
+struct statistics_t {
+	uint32_t ticks;
+	uint32_t callbacks;
+	uint32_t requests;
+	uint32_t batches;
+	uint32_t requestsPerType[NUMBER_OF_TYPES];
+	uint32_t throttled;
+	uint32_t interrupts;
+	uint32_t interruptsBusy;
+	uint32_t interruptsFailed;
+	uint32_t meshMessagesSent;
+	uint32_t messagesSent;
+	uint32_t centralRequests;
+	uint32_t centralBusy;
+};
+
+struct emulator_t {
+	bool initialized;
+	bool quiet;
+	bool noBatch;
+	bool noTime;
+	bool noTimeUnanswered;
+	bool noEmptyReadPart;
+	FILE* messagesFile;
+	bluenet_io_buffers_t* ioBuffers;
+	uint32_t maxTicks;
+	uint8_t callLimit;
+
+	event_t events[MAX_EVENTS];
+	uint16_t eventCount;
+
+	// Position in the interrupt queue of the current tick.
+	uint16_t eventIndex;
+	uint16_t eventRepetition;
+
+	bool interruptInProgress;
+	uint8_t callsThisTick;
+
+	uint8_t pinValues[NUMBER_OF_PINS];
+	uint8_t switchValue;
+
+	// Every TWI address is a device with registers, initialized to their own index, like many sensors have.
+	uint8_t twiRegisters[NUMBER_OF_REGISTERS];
+	uint8_t twiRegisterPointer;
+
+	// The remote peripheral, and the events of the central request in progress.
+	bool peripheralConnected;
+	gatt_characteristic_t characteristics[NUMBER_OF_CHARACTERISTICS];
+	central_event_t centralEvents[MAX_CENTRAL_EVENTS];
+	uint8_t centralEventCount;
+
+	statistics_t stats;
+};
+
+emulator_t emulator;
+
+/*
+ * Parse a hex string into bytes. Returns the number of bytes, or -1 on a parse error.
+ */
+int parseHex(const char* str, uint8_t* buf, int maxSize) {
+	int len = strlen(str);
+	if (len % 2 != 0 || len / 2 > maxSize) {
+		return -1;
+	}
+	for (int i = 0; i < len / 2; ++i) {
+		unsigned int byte;
+		if (sscanf(str + 2 * i, "%2x", &byte) != 1) {
+			return -1;
+		}
+		buf[i] = byte;
+	}
+	return len / 2;
+}
+
+/*
+ * Parse a MAC address of the format "AA:BB:CC:DD:EE:FF". Bytes are stored in reverse order, as bluenet does.
+ */
+bool parseMac(const char* str, uint8_t* address) {
+	unsigned int bytes[MAC_ADDRESS_LENGTH];
+	if (sscanf(str, "%2x:%2x:%2x:%2x:%2x:%2x", &bytes[0], &bytes[1], &bytes[2], &bytes[3], &bytes[4], &bytes[5])
+		!= MAC_ADDRESS_LENGTH) {
+		return false;
+	}
+	for (int i = 0; i < MAC_ADDRESS_LENGTH; ++i) {
+		address[MAC_ADDRESS_LENGTH - 1 - i] = bytes[i];
+	}
+	return true;
+}
+
+/*
+ * Parse a tick specification of the format "first[-last[/period]][xcount]".
+ */
+bool parseTicks(const char* str, event_t* event) {
+	unsigned int first = 0, last = 0, period = 1, count = 1;
+	const char* repeat = strchr(str, 'x');
+	if (repeat != nullptr && sscanf(repeat + 1, "%u", &count) != 1) {
+		return false;
+	}
+	int fields = sscanf(str, "%u-%u/%u", &first, &last, &period);
+	if (fields < 1) {
+		return false;
+	}
+	if (fields == 1) {
+		last = first;
+	}
+	if (last < first || period == 0 || count == 0) {
+		return false;
+	}
+	event->firstTick = first;
+	event->lastTick  = last;
+	event->period    = period;
+	event->count     = count;
+	return true;
+}
+
+bool parseEvent(char* line, event_t* event) {
+	char* tokens[5] = {};
+	int tokenCount  = 0;
+	for (char* token = strtok(line, " \t\r\n"); token != nullptr && tokenCount < 5; token = strtok(nullptr, " \t\r\n")) {
+		tokens[tokenCount++] = token;
+	}
+	if (tokenCount < 2 || !parseTicks(tokens[0], event)) {
+		return false;
+	}
+	int size = 0;
+	if (strcmp(tokens[1], "scan") == 0) {
+		// <ticks> scan <mac> <rssi> <hex data>
+		if (tokenCount < 5 || !parseMac(tokens[2], event->address)) {
+			return false;
+		}
+		event->type = EVENT_SCAN;
+		event->rssi = atoi(tokens[3]);
+		size        = parseHex(tokens[4], event->data, MAX_BLE_ADV_DATA_LENGTH);
+	}
+	else if (strcmp(tokens[1], "mesh") == 0) {
+		// <ticks> mesh <stone id> <hex data>
+		if (tokenCount < 4) {
+			return false;
+		}
+		event->type = EVENT_MESH;
+		event->id   = atoi(tokens[2]);
+		size        = parseHex(tokens[3], event->data, MAX_MICROAPP_MESH_PAYLOAD_SIZE);
+	}
+	else if (strcmp(tokens[1], "pin") == 0) {
+		// <ticks> pin <pin>
+		if (tokenCount < 3) {
+			return false;
+		}
+		event->type = EVENT_PIN;
+		event->id   = atoi(tokens[2]);
+	}
+	else if (strcmp(tokens[1], "message") == 0) {
+		// <ticks> message <hex data>
+		if (tokenCount < 3) {
+			return false;
+		}
+		event->type = EVENT_MESSAGE;
+		size        = parseHex(tokens[2], event->data, MICROAPP_SDK_MESSAGE_RECEIVED_MSG_MAX_SIZE);
+	}
+	else {
+		return false;
+	}
+	if (size < 0) {
+		return false;
+	}
+	event->size = size;
+	return true;
+}
+
+void loadEvents(const char* filename) {
+	FILE* file = fopen(filename, "r");
+	if (file == nullptr) {
+		fprintf(stderr, "[emulator] Cannot open event file %s\n", filename);
+		exit(1);
+	}
+	char line[256];
+	int lineNumber = 0;
+	while (fgets(line, sizeof(line), file) != nullptr) {
+		lineNumber++;
+		char* start = line + strspn(line, " \t");
+		if (*start == '#' || *start == '\n' || *start == '\r' || *start == 0) {
+			continue;
+		}
+		if (emulator.eventCount >= MAX_EVENTS) {
+			fprintf(stderr, "[emulator] Too many events in %s\n", filename);
+			exit(1);
+		}
+		event_t* event = &emulator.events[emulator.eventCount];
+		memset(event, 0, sizeof(*event));
+		if (!parseEvent(start, event)) {
+			fprintf(stderr, "[emulator] Invalid event at %s:%i\n", filename, lineNumber);
+			exit(1);
+		}
+		emulator.eventCount++;
+	}
+	fclose(file);
+}
+
+void printStatistics() {
+	fflush(stdout);
+	statistics_t& stats = emulator.stats;
+	fprintf(stderr, "[emulator] ticks=%u callbacks=%u requests=%u batches=%u throttled=%u\n",
+			stats.ticks, stats.callbacks, stats.requests, stats.batches, stats.throttled);
+	fprintf(stderr, "[emulator] interrupts=%u busy=%u failed=%u\n",
+			stats.interrupts, stats.interruptsBusy, stats.interruptsFailed);
+	fprintf(stderr, "[emulator] meshSent=%u messagesSent=%u\n", stats.meshMessagesSent, stats.messagesSent);
+	fprintf(stderr, "[emulator] centralRequests=%u centralBusy=%u\n", stats.centralRequests, stats.centralBusy);
+	for (int i = 0; i < NUMBER_OF_TYPES; ++i) {
+		if (stats.requestsPerType[i] != 0) {
+			fprintf(stderr, "[emulator] requests of type %i: %u\n", i, stats.requestsPerType[i]);
+		}
+	}
+}
+
+void addCharacteristic(uint8_t index, uint16_t uuid, uint16_t valueHandle, bool write, bool notify, const void* value,
+		uint8_t size) {
+	gatt_characteristic_t& characteristic = emulator.characteristics[index];
+	characteristic.uuid                   = uuid;
+	characteristic.valueHandle            = valueHandle;
+	characteristic.cccdHandle             = notify ? valueHandle + 1 : 0;
+	characteristic.options.read           = true;
+	characteristic.options.write          = write;
+	characteristic.options.notify         = notify;
+	characteristic.size                   = size;
+	memcpy(characteristic.value, value, size);
+}
+
+void addCharacteristic(uint8_t index, uint16_t uuid, uint16_t valueHandle, bool write, bool notify, uint16_t value) {
+	addCharacteristic(index, uuid, valueHandle, write, notify, &value, sizeof(value));
+}
+
+/*
+ * The remote peripheral is an environmental sensor. Values are little endian, in the unit of the characteristic.
+ */
+void initPeripheral() {
+	// Temperature Celsius: 22.5 °C
+	addCharacteristic(0, 0x2A1F, 0x0010, false, true, 225);
+	// Humidity: 50.00 %
+	addCharacteristic(1, 0x2A6F, 0x0013, false, false, 5000);
+	// Temperature: 20.00 °C, writable
+	addCharacteristic(2, 0x2A6E, 0x0015, true, false, 2000);
+	// Model Number String, writable: longer than fits in a single read event
+	const char* model = "Emulated environmental sensor, model number 0042-A7";
+	addCharacteristic(3, 0x2A24, 0x0017, true, false, model, strlen(model));
+}
+
+void init() {
+	if (emulator.initialized) {
+		return;
+	}
+	emulator.initialized = true;
+	emulator.maxTicks    = 100;
+	emulator.callLimit   = 8;
+	for (uint16_t i = 0; i < NUMBER_OF_REGISTERS; ++i) {
+		emulator.twiRegisters[i] = i;
+	}
+	initPeripheral();
+	const char* value    = getenv("MICROAPP_HOST_TICKS");
+	if (value != nullptr) {
+		emulator.maxTicks = atoi(value);
+	}
+	value = getenv("MICROAPP_HOST_CALL_LIMIT");
+	if (value != nullptr) {
+		emulator.callLimit = atoi(value);
+	}
+	emulator.quiet            = (getenv("MICROAPP_HOST_QUIET") != nullptr);
+	emulator.noBatch          = (getenv("MICROAPP_HOST_NO_BATCH") != nullptr);
+	value                     = getenv("MICROAPP_HOST_NO_TIME");
+	emulator.noTime           = (value != nullptr);
+	emulator.noTimeUnanswered = (value != nullptr && strcmp(value, "unanswered") == 0);
+	emulator.noEmptyReadPart  = (getenv("MICROAPP_HOST_NO_EMPTY_READ_PART") != nullptr);
+	value                     = getenv("MICROAPP_HOST_EVENTS");
+	if (value != nullptr && *value != 0) {
+		loadEvents(value);
+	}
+	value = getenv("MICROAPP_HOST_MESSAGES");
+	if (value != nullptr && *value != 0) {
+		emulator.messagesFile = fopen(value, "w");
+		if (emulator.messagesFile == nullptr) {
+			fprintf(stderr, "[emulator] failed to open %s\n", value);
+		}
+	}
+	atexit(printStatistics);
+}
+
+bool eventScheduled(const event_t& event, uint32_t tick) {
+	if (tick < event.firstTick || tick > event.lastTick) {
+		return false;
+	}
+	return ((tick - event.firstTick) % event.period == 0);
+}
+
+/*
+ * Write the event as interrupt into the bluenet2microapp buffer.
+ */
+void writeInterrupt(const event_t& event) {
+	uint8_t* payload = emulator.ioBuffers->bluenet2microapp.payload;
+	memset(payload, 0, MICROAPP_SDK_MAX_PAYLOAD);
+	switch (event.type) {
+		case EVENT_SCAN: {
+			auto ble                     = reinterpret_cast<microapp_sdk_ble_t*>(payload);
+			ble->header.messageType      = CS_MICROAPP_SDK_TYPE_BLE;
+			ble->type                    = CS_MICROAPP_SDK_BLE_SCAN;
+			ble->scan.type               = CS_MICROAPP_SDK_BLE_SCAN_EVENT_SCAN;
+			ble->scan.eventScan.address.type = MICROAPP_SDK_BLE_ADDRESS_RANDOM_STATIC;
+			memcpy(ble->scan.eventScan.address.address, event.address, MAC_ADDRESS_LENGTH);
+			ble->scan.eventScan.rssi = event.rssi;
+			ble->scan.eventScan.size = event.size;
+			memcpy(ble->scan.eventScan.data, event.data, event.size);
+			break;
+		}
+		case EVENT_MESH: {
+			auto mesh                = reinterpret_cast<microapp_sdk_mesh_t*>(payload);
+			mesh->header.messageType = CS_MICROAPP_SDK_TYPE_MESH;
+			mesh->type               = CS_MICROAPP_SDK_MESH_READ;
+			mesh->stoneId            = event.id;
+			mesh->size               = event.size;
+			memcpy(mesh->data, event.data, event.size);
+			break;
+		}
+		case EVENT_PIN: {
+			auto pin                = reinterpret_cast<microapp_sdk_pin_t*>(payload);
+			pin->header.messageType = CS_MICROAPP_SDK_TYPE_PIN;
+			pin->pin                = event.id;
+			break;
+		}
+		case EVENT_MESSAGE: {
+			auto message                   = reinterpret_cast<microapp_sdk_message_t*>(payload);
+			message->header.messageType    = CS_MICROAPP_SDK_TYPE_MESSAGE;
+			message->type                  = CS_MICROAPP_SDK_MSG_EVENT_RECEIVED_MSG;
+			message->receivedMessage.size  = event.size;
+			memcpy(message->receivedMessage.data, event.data, event.size);
+			break;
+		}
+	}
+	reinterpret_cast<microapp_sdk_header_t*>(payload)->ack = CS_MICROAPP_SDK_ACK_REQUEST;
+	emulator.interruptInProgress                          = true;
+	emulator.stats.interrupts++;
+}
+
+/*
+ * Write the first central event as interrupt into the bluenet2microapp buffer.
+ */
+void writeCentralInterrupt() {
+	uint8_t* payload = emulator.ioBuffers->bluenet2microapp.payload;
+	memset(payload, 0, MICROAPP_SDK_MAX_PAYLOAD);
+	auto ble                = reinterpret_cast<microapp_sdk_ble_t*>(payload);
+	ble->header.messageType = CS_MICROAPP_SDK_TYPE_BLE;
+	ble->header.ack         = CS_MICROAPP_SDK_ACK_REQUEST;
+	ble->type               = CS_MICROAPP_SDK_BLE_CENTRAL;
+	ble->central            = emulator.centralEvents[0].central;
+	emulator.centralEventCount--;
+	memmove(&emulator.centralEvents[0], &emulator.centralEvents[1],
+			emulator.centralEventCount * sizeof(central_event_t));
+	emulator.interruptInProgress = true;
+	emulator.stats.interrupts++;
+}
+
+/*
+ * Deliver the next interrupt scheduled for the current tick, if any. Events of central requests go first.
+ *
+ * @return true when an interrupt has been written to the shared buffer.
+ */
+bool deliverNextInterrupt() {
+	uint32_t tick = emulator.stats.ticks;
+	if (emulator.centralEventCount != 0 && emulator.centralEvents[0].tick <= tick) {
+		writeCentralInterrupt();
+		return true;
+	}
+	while (emulator.eventIndex < emulator.eventCount) {
+		const event_t& event = emulator.events[emulator.eventIndex];
+		if (eventScheduled(event, tick) && emulator.eventRepetition < event.count) {
+			emulator.eventRepetition++;
+			writeInterrupt(event);
+			return true;
+		}
+		emulator.eventIndex++;
+		emulator.eventRepetition = 0;
+	}
+	return false;
+}
+
+/*
+ * Bluenet resumes the microapp at the next tick: first all interrupts of that tick are delivered.
+ */
+void startNextTick() {
+	emulator.stats.ticks++;
+	if (emulator.stats.ticks >= emulator.maxTicks) {
+		exit(0);
+	}
+	emulator.callsThisTick   = 0;
+	emulator.eventIndex      = 0;
+	emulator.eventRepetition = 0;
+	deliverNextInterrupt();
+}
+
+void printLog(microapp_sdk_log_header_t* log) {
+	if (emulator.quiet) {
+		return;
+	}
+	switch (log->type) {
+		case CS_MICROAPP_SDK_LOG_CHAR: printf("%c", reinterpret_cast<microapp_sdk_log_char_t*>(log)->value); break;
+		case CS_MICROAPP_SDK_LOG_SHORT: printf("%i", reinterpret_cast<microapp_sdk_log_short_t*>(log)->value); break;
+		case CS_MICROAPP_SDK_LOG_UINT: printf("%u", reinterpret_cast<microapp_sdk_log_uint_t*>(log)->value); break;
+		case CS_MICROAPP_SDK_LOG_INT: printf("%i", reinterpret_cast<microapp_sdk_log_int_t*>(log)->value); break;
+		case CS_MICROAPP_SDK_LOG_FLOAT: printf("%f", reinterpret_cast<microapp_sdk_log_float_t*>(log)->value); break;
+		case CS_MICROAPP_SDK_LOG_DOUBLE: printf("%f", reinterpret_cast<microapp_sdk_log_double_t*>(log)->value); break;
+		case CS_MICROAPP_SDK_LOG_STR: {
+			auto logString = reinterpret_cast<microapp_sdk_log_string_t*>(log);
+			printf("%.*s", log->size, logString->str);
+			break;
+		}
+		case CS_MICROAPP_SDK_LOG_ARR: {
+			auto logArray = reinterpret_cast<microapp_sdk_log_array_t*>(log);
+			for (int i = 0; i < log->size; ++i) {
+				printf("%02X ", logArray->arr[i]);
+			}
+			break;
+		}
+		default: break;
+	}
+	if (log->flags & CS_MICROAPP_SDK_LOG_FLAG_NEWLINE) {
+		printf("\n");
+	}
+}
+
+microapp_sdk_result_t handlePin(microapp_sdk_pin_t* pin) {
+	if (pin->pin >= NUMBER_OF_PINS) {
+		return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
+	}
+	if (pin->type == CS_MICROAPP_SDK_PIN_ACTION) {
+		if (pin->action == CS_MICROAPP_SDK_PIN_WRITE) {
+			emulator.pinValues[pin->pin] = pin->value;
+		}
+		else {
+			pin->value = emulator.pinValues[pin->pin];
+		}
+	}
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+/*
+ * Queue an event with the result of a central request, to be delivered at the next tick.
+ */
+microapp_sdk_ble_central_t* addCentralEvent(MicroappSdkBleCentralType type) {
+	if (emulator.centralEventCount >= MAX_CENTRAL_EVENTS) {
+		return nullptr;
+	}
+	central_event_t& event = emulator.centralEvents[emulator.centralEventCount++];
+	memset(&event, 0, sizeof(event));
+	event.tick             = emulator.stats.ticks + 1;
+	event.central.type     = type;
+	return &event.central;
+}
+
+gatt_characteristic_t* findCharacteristic(uint16_t handle) {
+	for (uint8_t i = 0; i < NUMBER_OF_CHARACTERISTICS; ++i) {
+		gatt_characteristic_t& characteristic = emulator.characteristics[i];
+		if (characteristic.valueHandle == handle
+			|| (characteristic.cccdHandle != 0 && characteristic.cccdHandle == handle)) {
+			return &characteristic;
+		}
+	}
+	return nullptr;
+}
+
+/*
+ * Like bluenet, handle one central request at a time: the result comes in an event at the next tick, and until then
+ * other requests are refused.
+ */
+microapp_sdk_result_t handleCentral(microapp_sdk_ble_central_t* central) {
+	if (central->type == CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_REGISTER_INTERRUPT) {
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	emulator.stats.centralRequests++;
+	if (emulator.centralEventCount != 0) {
+		emulator.stats.centralBusy++;
+		return CS_MICROAPP_SDK_ACK_ERR_BUSY;
+	}
+	if (central->type != CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_CONNECT && !emulator.peripheralConnected) {
+		return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
+	}
+	switch (central->type) {
+		case CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_CONNECT: {
+			if (emulator.peripheralConnected) {
+				return CS_MICROAPP_SDK_ACK_ERR_ALREADY_EXISTS;
+			}
+			emulator.peripheralConnected = true;
+			microapp_sdk_ble_central_t* event = addCentralEvent(CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_CONNECT);
+			event->eventConnect.result        = CS_MICROAPP_SDK_ACK_SUCCESS;
+			return CS_MICROAPP_SDK_ACK_IN_PROGRESS;
+		}
+		case CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_DISCONNECT: {
+			emulator.peripheralConnected = false;
+			addCentralEvent(CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_DISCONNECT);
+			return CS_MICROAPP_SDK_ACK_IN_PROGRESS;
+		}
+		case CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_DISCOVER: {
+			for (uint8_t i = 0; i < central->requestDiscover.uuidCount; ++i) {
+				microapp_sdk_ble_uuid_t& uuid = central->requestDiscover.uuids[i];
+				if (uuid.type != CS_MICROAPP_SDK_BLE_UUID_STANDARD || uuid.uuid != GATT_SERVICE_UUID) {
+					continue;
+				}
+				microapp_sdk_ble_central_t* event = addCentralEvent(CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_DISCOVER);
+				event->eventDiscover.uuid = uuid;
+				for (uint8_t j = 0; j < NUMBER_OF_CHARACTERISTICS; ++j) {
+					gatt_characteristic_t& characteristic = emulator.characteristics[j];
+					event = addCentralEvent(CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_DISCOVER);
+					event->eventDiscover.serviceUuid = uuid;
+					event->eventDiscover.uuid.type   = CS_MICROAPP_SDK_BLE_UUID_STANDARD;
+					event->eventDiscover.uuid.uuid   = characteristic.uuid;
+					event->eventDiscover.valueHandle = characteristic.valueHandle;
+					event->eventDiscover.cccdHandle  = characteristic.cccdHandle;
+					event->eventDiscover.options     = characteristic.options;
+				}
+			}
+			addCentralEvent(CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_DISCOVER_DONE)->eventDiscoverDone.result =
+					CS_MICROAPP_SDK_ACK_SUCCESS;
+			return CS_MICROAPP_SDK_ACK_IN_PROGRESS;
+		}
+		case CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_READ: {
+			gatt_characteristic_t* characteristic = findCharacteristic(central->requestRead.valueHandle);
+			if (characteristic == nullptr) {
+				return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
+			}
+			// A long value comes in parts, all at the next tick. The last part is shorter than fits, and can be empty.
+			const uint8_t partSize = sizeof(central->eventRead.data);
+			uint8_t offset         = 0;
+			while (true) {
+				microapp_sdk_ble_central_t* event = addCentralEvent(CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_READ);
+				if (event == nullptr) {
+					return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+				}
+				uint8_t size = characteristic->size - offset;
+				if (size > partSize) {
+					size = partSize;
+				}
+				event->eventRead.valueHandle = characteristic->valueHandle;
+				event->eventRead.result      = CS_MICROAPP_SDK_ACK_SUCCESS;
+				event->eventRead.offset      = offset;
+				event->eventRead.size        = size;
+				memcpy(event->eventRead.data, characteristic->value + offset, size);
+				offset += size;
+				if (size < partSize || (emulator.noEmptyReadPart && offset == characteristic->size)) {
+					return CS_MICROAPP_SDK_ACK_IN_PROGRESS;
+				}
+			}
+		}
+		case CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_WRITE: {
+			uint16_t handle                       = central->requestWrite.handle;
+			gatt_characteristic_t* characteristic = findCharacteristic(handle);
+			if (characteristic == nullptr) {
+				return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
+			}
+			microapp_sdk_ble_central_t* event = addCentralEvent(CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_WRITE);
+			event->eventWrite.handle          = handle;
+			event->eventWrite.result          = CS_MICROAPP_SDK_ACK_SUCCESS;
+			if (handle == characteristic->valueHandle) {
+				if (!characteristic->options.write) {
+					event->eventWrite.result = CS_MICROAPP_SDK_ACK_ERR_DISABLED;
+				}
+				else if (central->requestWrite.size > MAX_GATT_VALUE_LENGTH) {
+					event->eventWrite.result = CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+				}
+				else {
+					characteristic->size = central->requestWrite.size;
+					memcpy(characteristic->value, central->requestWrite.buffer, characteristic->size);
+				}
+			}
+			return CS_MICROAPP_SDK_ACK_IN_PROGRESS;
+		}
+		default: return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+	}
+}
+
+microapp_sdk_result_t handleBle(microapp_sdk_ble_t* ble) {
+	switch (ble->type) {
+		case CS_MICROAPP_SDK_BLE_MAC: {
+			ble->requestMac.address.type = MICROAPP_SDK_BLE_ADDRESS_RANDOM_STATIC;
+			for (int i = 0; i < MAC_ADDRESS_LENGTH; ++i) {
+				ble->requestMac.address.address[i] = 0x10 + i;
+			}
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		case CS_MICROAPP_SDK_BLE_UUID_REGISTER: {
+			// Return the short uuid, as bluenet does.
+			memcpy(&ble->requestUuidRegister.uuid.uuid, ble->requestUuidRegister.customUuid + 12, 2);
+			ble->requestUuidRegister.uuid.type = CS_MICROAPP_SDK_BLE_UUID_STANDARD + 1;
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		case CS_MICROAPP_SDK_BLE_SCAN: {
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		case CS_MICROAPP_SDK_BLE_CENTRAL: {
+			return handleCentral(&ble->central);
+		}
+		case CS_MICROAPP_SDK_BLE_PERIPHERAL: {
+			if (ble->peripheral.type == CS_MICROAPP_SDK_BLE_PERIPHERAL_REQUEST_REGISTER_INTERRUPT) {
+				return CS_MICROAPP_SDK_ACK_SUCCESS;
+			}
+			return CS_MICROAPP_SDK_ACK_ERR_NOT_IMPLEMENTED;
+		}
+		default: return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+	}
+}
+
+/*
+ * Every tick lasts a loop interval, and every request within a tick takes a little time.
+ */
+void handleTime(microapp_sdk_time_t* time) {
+	uint32_t us    = emulator.callsThisTick * REQUEST_DURATION_US;
+	time->uptimeMs = emulator.stats.ticks * MICROAPP_LOOP_INTERVAL_MS + us / 1000;
+	time->uptimeUs = us % 1000;
+}
+
+/*
+ * The first byte written sets the register pointer, the other bytes are written to the registers. Reads start at the
+ * register pointer. The register pointer increments with every byte.
+ *
+ * Only the requested size is written, as a request in a batch has no space for more.
+ */
+microapp_sdk_result_t handleTwi(microapp_sdk_twi_t* twi) {
+	switch (twi->type) {
+		case CS_MICROAPP_SDK_TWI_INIT: return CS_MICROAPP_SDK_ACK_SUCCESS;
+		case CS_MICROAPP_SDK_TWI_WRITE: {
+			if (twi->size > MICROAPP_SDK_MAX_TWI_PAYLOAD_SIZE) {
+				return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+			}
+			for (uint8_t i = 0; i < twi->size; ++i) {
+				if (i == 0) {
+					emulator.twiRegisterPointer = twi->buf[i];
+				}
+				else {
+					emulator.twiRegisters[emulator.twiRegisterPointer++] = twi->buf[i];
+				}
+			}
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		case CS_MICROAPP_SDK_TWI_READ: {
+			if (twi->size > MICROAPP_SDK_MAX_TWI_PAYLOAD_SIZE) {
+				twi->size = MICROAPP_SDK_MAX_TWI_PAYLOAD_SIZE;
+			}
+			for (uint8_t i = 0; i < twi->size; ++i) {
+				twi->buf[i] = emulator.twiRegisters[emulator.twiRegisterPointer++];
+			}
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		default: return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+	}
+}
+
+microapp_sdk_result_t handleMesh(microapp_sdk_mesh_t* mesh) {
+	switch (mesh->type) {
+		case CS_MICROAPP_SDK_MESH_SEND: {
+			if (mesh->size > MAX_MICROAPP_MESH_PAYLOAD_SIZE) {
+				return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+			}
+			emulator.stats.meshMessagesSent++;
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		case CS_MICROAPP_SDK_MESH_LISTEN: return CS_MICROAPP_SDK_ACK_SUCCESS;
+		case CS_MICROAPP_SDK_MESH_READ_CONFIG: {
+			mesh->stoneId = EMULATOR_STONE_ID;
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		default: return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+	}
+}
+
+microapp_sdk_result_t handleMessage(microapp_sdk_message_t* message) {
+	switch (message->type) {
+		case CS_MICROAPP_SDK_MSG_REGISTER_INTERRUPT: return CS_MICROAPP_SDK_ACK_SUCCESS;
+		case CS_MICROAPP_SDK_MSG_REQUEST_SEND_MSG: {
+			if (message->sendMessage.size > MICROAPP_SDK_MESSAGE_SEND_MSG_MAX_SIZE) {
+				return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+			}
+			emulator.stats.messagesSent++;
+			if (emulator.messagesFile != nullptr) {
+				for (uint8_t i = 0; i < message->sendMessage.size; ++i) {
+					fprintf(emulator.messagesFile, "%02x", message->sendMessage.data[i]);
+				}
+				fprintf(emulator.messagesFile, "\n");
+			}
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		default: return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+	}
+}
+
+/*
+ * Handle a single request, and write the result in its header.
+ */
+void handleSdkRequest(uint8_t* payload) {
+	auto header = reinterpret_cast<microapp_sdk_header_t*>(payload);
+	emulator.stats.requests++;
+	if (header->messageType < NUMBER_OF_TYPES) {
+		emulator.stats.requestsPerType[header->messageType]++;
+	}
+	microapp_sdk_result_t result = CS_MICROAPP_SDK_ACK_SUCCESS;
+	switch (header->messageType) {
+		case CS_MICROAPP_SDK_TYPE_LOG: printLog(reinterpret_cast<microapp_sdk_log_header_t*>(payload)); break;
+		case CS_MICROAPP_SDK_TYPE_PIN: result = handlePin(reinterpret_cast<microapp_sdk_pin_t*>(payload)); break;
+		case CS_MICROAPP_SDK_TYPE_SWITCH: {
+			auto switchRequest = reinterpret_cast<microapp_sdk_switch_t*>(payload);
+			if (switchRequest->type == CS_MICROAPP_SDK_SWITCH_REQUEST_SET) {
+				emulator.switchValue = switchRequest->set;
+			}
+			else {
+				switchRequest->get.relay  = false;
+				switchRequest->get.dimmer = (emulator.switchValue <= 100) ? emulator.switchValue : 100;
+			}
+			break;
+		}
+		case CS_MICROAPP_SDK_TYPE_TWI: result = handleTwi(reinterpret_cast<microapp_sdk_twi_t*>(payload)); break;
+		case CS_MICROAPP_SDK_TYPE_BLE: result = handleBle(reinterpret_cast<microapp_sdk_ble_t*>(payload)); break;
+		case CS_MICROAPP_SDK_TYPE_MESH: result = handleMesh(reinterpret_cast<microapp_sdk_mesh_t*>(payload)); break;
+		case CS_MICROAPP_SDK_TYPE_POWER_USAGE: {
+			reinterpret_cast<microapp_sdk_power_usage_t*>(payload)->powerUsage = 0;
+			break;
+		}
+		case CS_MICROAPP_SDK_TYPE_PRESENCE: {
+			reinterpret_cast<microapp_sdk_presence_t*>(payload)->presenceBitmask = 0;
+			break;
+		}
+		case CS_MICROAPP_SDK_TYPE_MESSAGE: {
+			result = handleMessage(reinterpret_cast<microapp_sdk_message_t*>(payload));
+			break;
+		}
+		case MICROAPP_SDK_TYPE_TIME: {
+			if (emulator.noTime) {
+				result = emulator.noTimeUnanswered ? CS_MICROAPP_SDK_ACK_REQUEST : CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+				break;
+			}
+			handleTime(reinterpret_cast<microapp_sdk_time_t*>(payload));
+			break;
+		}
+		case CS_MICROAPP_SDK_TYPE_SERVICE_DATA:
+		case CS_MICROAPP_SDK_TYPE_CONTROL_COMMAND:
+		case CS_MICROAPP_SDK_TYPE_BLUENET_EVENT:
+		case CS_MICROAPP_SDK_TYPE_ASSETS: break;
+		default: result = CS_MICROAPP_SDK_ACK_ERR_UNDEFINED; break;
+	}
+	header->ack = result;
+}
+
+/*
+ * Handle each request in a batch.
+ */
+microapp_sdk_result_t handleBatch(microapp_sdk_batch_t* batch) {
+	emulator.stats.batches++;
+	uint16_t offset = 0;
+	for (uint8_t i = 0; i < batch->count; ++i) {
+		if (offset >= MICROAPP_SDK_BATCH_MAX_DATA_SIZE
+			|| offset + 1 + batch->data[offset] > MICROAPP_SDK_BATCH_MAX_DATA_SIZE) {
+			return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+		}
+		handleSdkRequest(&batch->data[offset + 1]);
+		offset += 1 + batch->data[offset];
+	}
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+/*
+ * Handle a request from the microapp2bluenet buffer.
+ *
+ * @return true when bluenet would not resume the microapp before the next tick.
+ */
+bool handleRequest(uint8_t* payload) {
+	auto header = reinterpret_cast<microapp_sdk_header_t*>(payload);
+	if (header->messageType == CS_MICROAPP_SDK_TYPE_YIELD) {
+		// Any yield (setup, loop or async) ends the tick. Setup runs in tick 0.
+		return true;
+	}
+	if (header->ack != CS_MICROAPP_SDK_ACK_REQUEST) {
+		return false;
+	}
+	if (header->messageType == MICROAPP_SDK_TYPE_BATCH && !emulator.noBatch) {
+		header->ack = handleBatch(reinterpret_cast<microapp_sdk_batch_t*>(payload));
+	}
+	else {
+		handleSdkRequest(payload);
+	}
+
+	// Throttle consecutive calls, like bluenet does.
+	if (++emulator.callsThisTick > emulator.callLimit) {
+		emulator.stats.throttled++;
+		return true;
+	}
+	return false;
+}
+
+/*
+ * The emulated microappCallback: called by the microapp on every sendMessage().
+ */
+microapp_sdk_result_t emulatorCallback(uint8_t opcode, bluenet_io_buffers_t* ioBuffers) {
+	if (opcode == CS_MICROAPP_CALLBACK_UPDATE_IO_BUFFER) {
+		emulator.ioBuffers = ioBuffers;
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	emulator.stats.callbacks++;
+	auto incomingHeader = reinterpret_cast<microapp_sdk_header_t*>(ioBuffers->bluenet2microapp.payload);
+
+	if (emulator.interruptInProgress) {
+		switch (incomingHeader->ack) {
+			case CS_MICROAPP_SDK_ACK_IN_PROGRESS: {
+				// A request made from within the interrupt handler.
+				// No new interrupts are delivered until this one finishes.
+				handleRequest(ioBuffers->microapp2bluenet.payload);
+				return CS_MICROAPP_SDK_ACK_SUCCESS;
+			}
+			case CS_MICROAPP_SDK_ACK_ERR_BUSY: {
+				emulator.stats.interruptsBusy++;
+				break;
+			}
+			case CS_MICROAPP_SDK_ACK_SUCCESS: break;
+			default: {
+				emulator.stats.interruptsFailed++;
+				break;
+			}
+		}
+		// Interrupt finished: the outgoing buffer holds the restored state, not a new request.
+		emulator.interruptInProgress = false;
+		incomingHeader->ack          = CS_MICROAPP_SDK_ACK_NO_REQUEST;
+		deliverNextInterrupt();
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+
+	bool endOfTick = handleRequest(ioBuffers->microapp2bluenet.payload);
+	if (endOfTick) {
+		startNextTick();
+	}
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+}  // namespace
+
+uint8_t getRamData(uint8_t index, uint8_t* data, uint8_t* dataSize, uint8_t maxSize) {
+	init();
+	if (index != IPC_INDEX_BLUENET_TO_MICROAPP || maxSize < sizeof(bluenet2microapp_ipcdata_t)) {
+		return 1;
+	}
+	bluenet2microapp_ipcdata_t ipcData;
+	memset(&ipcData, 0, sizeof(ipcData));
+	ipcData.dataProtocol     = MICROAPP_IPC_DATA_PROTOCOL;
+	ipcData.microappCallback = emulatorCallback;
+	memcpy(data, &ipcData, sizeof(ipcData));
+	*dataSize = sizeof(ipcData);
+	return 0;
+}
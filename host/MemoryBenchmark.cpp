@@ -0,0 +1,209 @@
+/**
+ * Memory function benchmark.
+ *
+ * Compares the memory and string functions of the microapp (src/microapp.c) with plain byte loops, for sizes from 1
+ * to 256 bytes, with aligned and unaligned buffers. The results are also checked against the byte loops.
+ *
+ * The microapp functions are renamed in the host build (see HOST_FLAGS in config.mk), so they can be linked next to
+ * the C library.
+ *
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+extern "C" {
+uint8_t microapp_strlen(const char* str);
+int microapp_memcmp(const void* ptr1, const void* ptr2, uint16_t num);
+void* microapp_memcpy(void* dest, const void* src, uint16_t num);
+void* microapp_memmove(void* dest, const void* src, uint16_t num);
+void* microapp_memset(void* dest, int value, uint16_t num);
+}
+
+namespace {
+
+const uint16_t MAX_SIZE    = 256;
+const uint32_t ITERATIONS  = 200000;
+const uint16_t SIZES[]     = {1, 2, 3, 4, 7, 8, 15, 16, 31, 32, 48, 63, 64, 127, 128, 255, 256};
+const uint8_t MAX_STR_SIZE = 255;
+
+// The max string length of the microapp strlen, determined at start
+uint8_t maxStringSize = MAX_STR_SIZE;
+
+// The byte loops, as the microapp had them before.
+// The noinline attributes keep the compiler from optimizing the calls away.
+
+__attribute__((noinline)) uint8_t byteStrlen(const char* str) {
+	for (uint16_t i = 0; i < maxStringSize; ++i) {
+		if (str[i] == 0) {
+			return i;
+		}
+	}
+	return maxStringSize;
+}
+
+__attribute__((noinline)) int byteMemcmp(const void* ptr1, const void* ptr2, uint16_t num) {
+	const uint8_t* p = (const uint8_t*)ptr1;
+	const uint8_t* q = (const uint8_t*)ptr2;
+	for (uint16_t i = 0; i < num; ++i) {
+		if (p[i] != q[i]) {
+			return (p[i] < q[i]) ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns"))) void* byteMemcpy(
+		void* dest, const void* src, uint16_t num) {
+	const uint8_t* p = (const uint8_t*)src;
+	uint8_t* q       = (uint8_t*)dest;
+	for (uint16_t i = 0; i < num; ++i) {
+		q[i] = p[i];
+	}
+	return dest;
+}
+
+__attribute__((noinline, optimize("no-tree-loop-distribute-patterns"))) void* byteMemset(
+		void* dest, int value, uint16_t num) {
+	uint8_t* q = (uint8_t*)dest;
+	for (uint16_t i = 0; i < num; ++i) {
+		q[i] = value;
+	}
+	return dest;
+}
+
+alignas(4) uint8_t bufferA[MAX_SIZE + 8];
+alignas(4) uint8_t bufferB[MAX_SIZE + 8];
+alignas(4) uint8_t bufferC[MAX_SIZE + 8];
+
+int failures = 0;
+
+void check(bool condition, const char* function, uint16_t size, uint8_t offset) {
+	if (!condition) {
+		fprintf(stderr, "%s differs for size %u, offset %u\n", function, size, offset);
+		failures++;
+	}
+}
+
+// Results are accumulated here, so that the compiler does not optimize the calls away
+volatile uintptr_t sink;
+
+template <typename Function>
+double measure(Function function) {
+	auto start = std::chrono::steady_clock::now();
+	for (uint32_t i = 0; i < ITERATIONS; ++i) {
+		sink = sink + (uintptr_t)function();
+		// Keep the compiler from hoisting the call out of the loop
+		asm volatile("" ::: "memory");
+	}
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::nano>(end - start).count() / ITERATIONS;
+}
+
+void fillRandom(uint8_t* buf, uint16_t size) {
+	for (uint16_t i = 0; i < size; ++i) {
+		buf[i] = 1 + rand() % 255;
+	}
+}
+
+void verify(uint16_t size, uint8_t srcOffset, uint8_t destOffset) {
+	uint8_t* src = bufferA + srcOffset;
+	fillRandom(bufferA, sizeof(bufferA));
+	fillRandom(bufferB, sizeof(bufferB));
+	for (uint16_t i = 0; i < sizeof(bufferC); ++i) {
+		bufferC[i] = bufferB[i];
+	}
+
+	microapp_memcpy(bufferB + destOffset, src, size);
+	byteMemcpy(bufferC + destOffset, src, size);
+	check(byteMemcmp(bufferB, bufferC, sizeof(bufferB)) == 0, "memcpy", size, srcOffset);
+
+	check(microapp_memcmp(bufferB + destOffset, src, size) == 0, "memcmp", size, srcOffset);
+	bufferB[destOffset + size - 1] ^= 0x80;
+	check(microapp_memcmp(bufferB + destOffset, src, size) == byteMemcmp(bufferB + destOffset, src, size),
+		  "memcmp",
+		  size,
+		  srcOffset);
+
+	microapp_memset(bufferB + destOffset, size, size);
+	byteMemset(bufferC + destOffset, size, size);
+	check(byteMemcmp(bufferB, bufferC, sizeof(bufferB)) == 0, "memset", size, destOffset);
+
+	// Overlapping move, in both directions
+	for (uint16_t i = 0; i < sizeof(bufferC); ++i) {
+		bufferC[i] = bufferB[i];
+	}
+	microapp_memmove(bufferB + destOffset + 3, bufferB + destOffset, size);
+	for (int i = size - 1; i >= 0; --i) {
+		bufferC[destOffset + 3 + i] = bufferC[destOffset + i];
+	}
+	check(byteMemcmp(bufferB, bufferC, sizeof(bufferB)) == 0, "memmove", size, destOffset);
+	microapp_memmove(bufferB + destOffset, bufferB + destOffset + 3, size);
+	byteMemcpy(bufferC + destOffset, bufferC + destOffset + 3, size);
+	check(byteMemcmp(bufferB, bufferC, sizeof(bufferB)) == 0, "memmove", size, destOffset);
+
+	if (size < MAX_STR_SIZE) {
+		src[size] = 0;
+		check(microapp_strlen((const char*)src) == byteStrlen((const char*)src), "strlen", size, srcOffset);
+	}
+}
+
+}  // namespace
+
+int main() {
+	byteMemset(bufferA, 'a', sizeof(bufferA));
+	bufferA[MAX_STR_SIZE] = 0;
+	maxStringSize         = microapp_strlen((const char*)bufferA);
+
+	for (uint16_t size = 1; size <= MAX_SIZE; ++size) {
+		for (uint8_t srcOffset = 0; srcOffset < 4; ++srcOffset) {
+			for (uint8_t destOffset = 0; destOffset < 4; ++destOffset) {
+				verify(size, srcOffset, destOffset);
+			}
+		}
+	}
+	if (failures > 0) {
+		fprintf(stderr, "%i checks failed\n", failures);
+		return 1;
+	}
+
+	printf("Time per call in ns (byte loop / microapp), aligned and unaligned\n");
+	printf("%5s %17s %17s %17s %17s %17s\n", "size", "memcpy", "memcpy unaligned", "memcmp", "memset", "strlen");
+	for (uint16_t size : SIZES) {
+		fillRandom(bufferA, sizeof(bufferA));
+		for (uint16_t i = 0; i < sizeof(bufferB); ++i) {
+			bufferB[i] = bufferA[i];
+		}
+		bufferA[size < MAX_STR_SIZE ? size : MAX_STR_SIZE] = 0;
+		bufferB[size < MAX_STR_SIZE ? size : MAX_STR_SIZE] = 0;
+		const char* str = (const char*)bufferA;
+
+		double copyByte      = measure([&] { return byteMemcpy(bufferC, bufferA, size); });
+		double copy          = measure([&] { return microapp_memcpy(bufferC, bufferA, size); });
+		double copyUnaligned = measure([&] { return byteMemcpy(bufferC + 1, bufferA + 2, size); });
+		double copyUnalignedMicroapp = measure([&] { return microapp_memcpy(bufferC + 1, bufferA + 2, size); });
+		double compareByte   = measure([&] { return byteMemcmp(bufferA, bufferB, size); });
+		double compare       = measure([&] { return microapp_memcmp(bufferA, bufferB, size); });
+		double setByte       = measure([&] { return byteMemset(bufferC, 0x55, size); });
+		double set           = measure([&] { return microapp_memset(bufferC, 0x55, size); });
+		double lengthByte    = measure([&] { return byteStrlen(str); });
+		double length        = measure([&] { return microapp_strlen(str); });
+
+		printf("%5u %8.1f / %6.1f %8.1f / %6.1f %8.1f / %6.1f %8.1f / %6.1f %8.1f / %6.1f\n",
+			   size,
+			   copyByte,
+			   copy,
+			   copyUnaligned,
+			   copyUnalignedMicroapp,
+			   compareByte,
+			   compare,
+			   setByte,
+			   set,
+			   lengthByte,
+			   length);
+	}
+	return 0;
+}
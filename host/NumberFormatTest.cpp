@@ -0,0 +1,259 @@
+/**
+ * Number formatting test.
+ *
+ * Compares the output of the number formatting functions of the microapp (src/NumberFormat.cpp) with the printf of the
+ * C library, for edge cases and random values:
+ * - Integers must be equal.
+ * - Fixed point floats must be equal, except at exact ties: the C library rounds those half to even.
+ * - The shortest floats must read back as the same float, and must have no more digits than needed, or one more when
+ *   the shortest lies exactly halfway two floats.
+ *
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#include <NumberFormat.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace {
+
+const uint32_t RANDOM_ITERATIONS = 200000;
+
+uint32_t failures = 0;
+
+// Number of shortest floats that have one digit more than needed.
+uint32_t longerThanShortest = 0;
+
+// Deterministic, so that failures can be reproduced.
+uint32_t randomState = 12345;
+uint32_t random32() {
+	randomState ^= randomState << 13;
+	randomState ^= randomState >> 17;
+	randomState ^= randomState << 5;
+	return randomState;
+}
+
+uint64_t random64() {
+	return ((uint64_t)random32() << 32) | random32();
+}
+
+void fail(const char* what, const char* result, const char* expected) {
+	if (failures < 20) {
+		printf("FAIL %s: \"%s\", expected \"%s\"\n", what, result, expected);
+	}
+	failures++;
+}
+
+void check(const char* what, const char* result, uint8_t length, const char* expected) {
+	if (strcmp(result, expected) != 0 || length != strlen(expected)) {
+		fail(what, result, expected);
+	}
+}
+
+void checkInt(int32_t value) {
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	char expected[64];
+	char what[64];
+	uint8_t length;
+
+	snprintf(what, sizeof(what), "formatInt(%d)", value);
+	length = formatInt(buf, value);
+	snprintf(expected, sizeof(expected), "%d", value);
+	check(what, buf, length, expected);
+
+	uint32_t unsignedValue = value;
+	snprintf(what, sizeof(what), "formatUnsigned(%u)", unsignedValue);
+	length = formatUnsigned(buf, unsignedValue);
+	snprintf(expected, sizeof(expected), "%u", unsignedValue);
+	check(what, buf, length, expected);
+
+	length = formatUnsigned(buf, unsignedValue, 8);
+	snprintf(expected, sizeof(expected), "%o", unsignedValue);
+	check(what, buf, length, expected);
+
+	length = formatUnsigned(buf, unsignedValue, 16);
+	snprintf(expected, sizeof(expected), "%x", unsignedValue);
+	check(what, buf, length, expected);
+
+	length = formatHex(buf, unsignedValue, 8);
+	snprintf(expected, sizeof(expected), "%08X", unsignedValue);
+	check(what, buf, length, expected);
+
+	length = formatHex(buf, unsignedValue, 0, false);
+	snprintf(expected, sizeof(expected), "%x", unsignedValue);
+	check(what, buf, length, expected);
+
+	// Base 2 has no printf conversion: compare with the bits.
+	length = formatUnsigned(buf, unsignedValue, 2);
+	uint8_t bitCount = 1;
+	while (bitCount < 32 && (unsignedValue >> bitCount) != 0) {
+		bitCount++;
+	}
+	for (uint8_t i = 0; i < bitCount; ++i) {
+		expected[i] = ((unsignedValue >> (bitCount - 1 - i)) & 1) ? '1' : '0';
+	}
+	expected[bitCount] = 0;
+	check(what, buf, length, expected);
+}
+
+/**
+ * Whether value * 10^precision lies exactly halfway two integers.
+ */
+bool isTie(double value, uint8_t precision) {
+	// The C library prints the exact decimal expansion, which ends in a 5 at the first dropped decimal for a tie.
+	char exact[1200];
+	snprintf(exact, sizeof(exact), "%.1074f", fabs(value));
+	char* decimals = strchr(exact, '.') + 1 + precision;
+	if (*decimals != '5') {
+		return false;
+	}
+	for (char* c = decimals + 1; *c != 0; ++c) {
+		if (*c != '0') {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <typename T>
+void checkFloat(T value, uint8_t precision) {
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	char expected[400];
+	char what[64];
+	snprintf(what, sizeof(what), "formatFloat(%.9g, %u)", (double)value, precision);
+	uint8_t length = formatFloat(buf, value, precision);
+
+	if (isnan(value) || isinf(value)) {
+		snprintf(expected, sizeof(expected), "%f", (double)value);
+		check(what, buf, length, expected);
+		return;
+	}
+	snprintf(expected, sizeof(expected), "%.*f", precision, (double)value);
+	// At exact ties, we round away from zero: like the C library does for the next value away from zero.
+	if (strcmp(buf, expected) != 0 && isTie(value, precision)) {
+		double awayFromZero = nextafter((double)value, (value < 0) ? -INFINITY : INFINITY);
+		snprintf(expected, sizeof(expected), "%.*f", precision, awayFromZero);
+	}
+	// The integer part, after rounding, must fit in 32 bits.
+	if (fabs(strtod(expected, nullptr)) >= 4294967296.0) {
+		snprintf(expected, sizeof(expected), "%sovf", signbit(value) ? "-" : "");
+	}
+	check(what, buf, length, expected);
+}
+
+void checkFloatShortest(float value) {
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	char what[64];
+	snprintf(what, sizeof(what), "formatFloatShortest(%.9g)", value);
+	uint8_t length = formatFloatShortest(buf, value);
+	if (length != strlen(buf)) {
+		fail(what, buf, "length mismatch");
+		return;
+	}
+	if (isnan(value)) {
+		check(what, buf, length, "nan");
+		return;
+	}
+
+	// Must read back as the same float.
+	float readBack = strtof(buf, nullptr);
+	if (memcmp(&readBack, &value, sizeof(float)) != 0) {
+		char expected[64];
+		snprintf(expected, sizeof(expected), "%.9g", value);
+		fail(what, buf, expected);
+		return;
+	}
+	if (isinf(value)) {
+		return;
+	}
+
+	// Must have no more significant digits than the shortest %g that reads back.
+	uint8_t digitCount = 0;
+	bool leading       = true;
+	for (const char* c = buf; *c != 0 && *c != 'e'; ++c) {
+		if (*c >= '1' && *c <= '9') {
+			leading = false;
+		}
+		if (*c >= '0' && *c <= '9' && !leading) {
+			digitCount++;
+		}
+	}
+	// Trailing zeros of an integer are not significant.
+	if (strchr(buf, '.') == nullptr && strchr(buf, 'e') == nullptr) {
+		for (const char* c = buf + length - 1; c > buf && *c == '0' && digitCount > 0; --c) {
+			digitCount--;
+		}
+	}
+	char expected[400];
+	for (uint8_t precision = 1; precision < digitCount; ++precision) {
+		snprintf(expected, sizeof(expected), "%.*g", precision, value);
+		float shorter = strtof(expected, nullptr);
+		if (memcmp(&shorter, &value, sizeof(float)) == 0) {
+			// Grisu2 leaves out the boundaries halfway the neighbouring floats, so when the shortest lies exactly on
+			// a boundary, one more digit is used.
+			if (precision + 1 < digitCount) {
+				fail(what, buf, expected);
+			}
+			longerThanShortest++;
+			return;
+		}
+	}
+}
+
+void testIntegers() {
+	const int32_t values[] = {0, 1, -1, 9, 10, -10, 99, 100, 12345, -12345, 999999999, 1000000000, INT32_MAX, INT32_MIN};
+	for (int32_t value : values) {
+		checkInt(value);
+	}
+	for (uint32_t i = 0; i < RANDOM_ITERATIONS; ++i) {
+		// Mix in small values, which have fewer digits.
+		checkInt(random32() >> (random32() % 32));
+	}
+}
+
+void testFloats() {
+	const float values[] = {0.0f, -0.0f, 0.5f, 1.5f, 2.5f, -2.5f, 0.125f, 0.1f, 1.005f, 3.14159265f, 123456.789f,
+			9.9999999f, 0.9999999f, 4294967040.0f, 4294967296.0f, -4294967296.0f, 1e-10f, 1.17549435e-38f, 1e-45f,
+			3.40282347e38f, INFINITY, -INFINITY, NAN};
+	for (float value : values) {
+		for (uint8_t precision = 0; precision <= MAX_FLOAT_PRECISION; ++precision) {
+			checkFloat(value, precision);
+			checkFloat((double)value, precision);
+		}
+		checkFloatShortest(value);
+	}
+	for (uint32_t i = 0; i < RANDOM_ITERATIONS; ++i) {
+		uint32_t bits = random32();
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		checkFloatShortest(value);
+
+		// Mostly values that fit in 32 bits.
+		bits = (bits & 0x807FFFFF) | ((100 + random32() % 60) << 23);
+		memcpy(&value, &bits, sizeof(value));
+		checkFloat(value, random32() % (MAX_FLOAT_PRECISION + 1));
+
+		uint64_t doubleBits = (random64() & 0x800FFFFFFFFFFFFF) | ((uint64_t)(980 + random32() % 80) << 52);
+		double doubleValue;
+		memcpy(&doubleValue, &doubleBits, sizeof(doubleValue));
+		checkFloat(doubleValue, random32() % (MAX_FLOAT_PRECISION + 1));
+	}
+}
+
+}  // namespace
+
+int main() {
+	testIntegers();
+	printf("Integers: %s\n", failures ? "FAIL" : "OK");
+	uint32_t integerFailures = failures;
+	testFloats();
+	printf("Floats: %s\n", (failures > integerFailures) ? "FAIL" : "OK");
+	printf("Shortest floats with one digit more than needed: %u of %u\n", longerThanShortest, RANDOM_ITERATIONS);
+	if (failures) {
+		printf("%u failures\n", failures);
+		return 1;
+	}
+	return 0;
+}
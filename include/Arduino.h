@@ -1,6 +1,9 @@
 #pragma once
 
+#include <Log.h>
 #include <Serial.h>
+#include <Task.h>
+#include <Timer.h>
 #include <Wire.h>
 
 #ifdef __cplusplus
@@ -66,9 +69,23 @@ void loop();
 
 //
 // A delay in ms. Hence 1000 means a delay of one second.
+// The microapp yields to bluenet until the time of the delay has passed. Bluenet only resumes the microapp every so
+// often (MICROAPP_LOOP_INTERVAL_MS), so the delay ends at the first resume after the requested time.
+// Meanwhile, tasks (see Task.h) continue. In a task, delay() lets the other tasks and the loop continue.
 //
 void delay(uint32_t delay_ms);
 
+//
+// Number of milliseconds since the Crownstone started. Wraps around after about 50 days.
+// The time is requested from bluenet once per resume of the microapp, so calling this often is cheap.
+//
+unsigned long millis();
+
+//
+// Number of microseconds since the Crownstone started. Wraps around after about 71 minutes.
+//
+unsigned long micros();
+
 //
 // A bunch of functions that are mainly useful in either development mode, on a Crownstone that is embedded
 // electronically, etc., not so much for built-in Crownstones. It can also be the case that these functions are
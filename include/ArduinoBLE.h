@@ -1,11 +1,16 @@
 #pragma once
 
+#include <BleAttributeCache.h>
 #include <BleDevice.h>
 #include <BleScan.h>
 #include <BleService.h>
 #include <BleUtils.h>
 #include <BleMacAddress.h>
+#include <BleRequest.h>
+#include <BleScanCache.h>
+#include <BleScanFilter.h>
 #include <BleUuid.h>
+#include <RingBuffer.h>
 #include <Serial.h>
 #include <microapp.h>
 
@@ -33,6 +38,11 @@ enum BleFilterType {
 
 #define MAX_REMOTE_CHARACTERISTICS (MAX_REMOTE_SERVICES * MAX_CHARACTERISTICS_PER_SERVICE)
 
+// Number of scanned devices that are buffered until retrieved with BLE.available(). Must be a power of 2.
+#ifndef BLE_SCAN_BUFFER_SIZE
+#define BLE_SCAN_BUFFER_SIZE 4
+#endif
+
 /**
  * Main class for scanning, connecting and handling Bluetooth Low Energy devices
  *
@@ -46,6 +56,7 @@ private:
 	friend microapp_sdk_result_t removeBleEventHandlerRegistration(BleEventType);
 	friend bool registeredBleInterrupt(MicroappSdkBleType);
 	friend microapp_sdk_result_t registerBleInterrupt(MicroappSdkBleType);
+	friend bool discoverCachedService(microapp_sdk_ble_uuid_t);
 
 	Ble(){};
 
@@ -54,6 +65,8 @@ private:
 		bool initialized = false;
 		//! whether scans are handled
 		bool isScanning = false;
+		//! whether duplicate advertisements are handled
+		bool withDuplicates = true;
 		bool registeredScanInterrupts = false;
 		bool registeredCentralInterrupts = false;
 		bool registeredPeripheralInterrupts = false;
@@ -62,10 +75,19 @@ private:
 	// Address of the crownstone itself
 	MacAddress _address;
 
-	// Device only used for incoming scans
+	// Device only used for incoming scans that are passed to the BLEDeviceScanned event handler
 	// Is overwritten as new scans come in that pass the filter
 	BleDevice _scanDevice;
 
+	// Filters evaluated on incoming scans, before anything is copied
+	BleScanFilterChain _scanFilterChain;
+
+	// Recently handled scanned devices, used to ignore duplicate advertisements
+	BleScanCache _scanCache;
+
+	// Incoming scans are buffered here when there is no BLEDeviceScanned event handler, until retrieved via available()
+	RingBuffer<ble_scan_record_t, BLE_SCAN_BUFFER_SIZE> _scanBuffer;
+
 	// Remote device acting as peripheral
 	BleDevice _peripheral;
 	BleDevice _central;
@@ -83,6 +105,12 @@ private:
 	BleCharacteristic _remoteCharacteristics[MAX_REMOTE_CHARACTERISTICS];
 	uint8_t _remoteCharacteristicCount = 0;
 
+	// Requests to the remote peripheral that wait for their result
+	BleRequestTable& _requests = getBleRequestTable();
+
+	// Discovered services and characteristics of recently connected peripherals
+	BleAttributeCache _attributeCache;
+
 	// Event handlers set by the user
 	static constexpr uint8_t MAX_BLE_EVENT_HANDLER_REGISTRATIONS = 3;
 
@@ -127,6 +155,24 @@ private:
 	 */
 	microapp_sdk_result_t handleCentralEvent(microapp_sdk_ble_central_t* central);
 
+	/**
+	 * Add a discovered service or characteristic of the remote peripheral, from an event or from the attribute cache
+	 *
+	 * @param[in] eventDiscover the discovered service (with value handle 0) or characteristic
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if the service or characteristic cannot be added due to space limitations
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS upon success
+	 */
+	microapp_sdk_result_t onDiscover(microapp_sdk_ble_central_event_discover_t* eventDiscover);
+
+	/**
+	 * Restore the services and characteristics of the remote peripheral from the attribute cache, as if discovered.
+	 * When not cached, the discovery that follows is stored in the cache.
+	 *
+	 * @param[in] service the service to discover
+	 * @return true if restored from the cache
+	 */
+	bool discoverCached(microapp_sdk_ble_uuid_t service);
+
 	/**
 	 * Handles interrupts entering the BLE class from bluenet of the peripheral type
 	 *
@@ -213,7 +259,7 @@ public:
 	 *
 	 * @return the Bluetooth address of the BLE device as a string
 	 */
-	String address();
+	MacAddressString address();
 
 	/**
 	 * Query the RSSI of the connected BLE device
@@ -240,48 +286,48 @@ public:
 	 * Sends command to bluenet to call registered microapp callback function upon receiving advertisements
 	 * Resets reviously scanned devices.
 	 *
-	 * @param[in] withDuplicates  If true, returns duplicate advertisements. (Not implemented)
+	 * @param[in] withDuplicates  If false, ignores duplicate advertisements. See setDuplicateFilter().
 	 *
 	 * @return true on success
 	 * @return false on failure
 	 */
-	bool scan(bool withDuplicates = false);
+	bool scan(bool withDuplicates = true);
 
 	/**
 	 * Registers filter with name name and calls scan()
 	 *
 	 * @param[in] name            String containing the local name to filter on, advertised as either the complete or
 	 * shortened local name
-	 * @param[in] withDuplicates  If true, returns duplicate advertisements. (Not implemented)
+	 * @param[in] withDuplicates  If false, ignores duplicate advertisements. See setDuplicateFilter().
 	 *
 	 * @return true on success
 	 * @return false on failure
 	 */
-	bool scanForName(const char* name, bool withDuplicates = false);
+	bool scanForName(const char* name, bool withDuplicates = true);
 
 	/**
 	 * Registers filter with MAC address address and calls scan()
 	 *
 	 * @param[in] address         MAC address string of the format "AA:BB:CC:DD:EE:FF" to filter on, either lowercase or
 	 * uppercase letters.
-	 * @param[in] withDuplicates  If true, returns duplicate advertisements. (Not implemented)
+	 * @param[in] withDuplicates  If false, ignores duplicate advertisements. See setDuplicateFilter().
 	 *
 	 * @return true on success
 	 * @return false on failure
 	 */
-	bool scanForAddress(const char* address, bool withDuplicates = false);
+	bool scanForAddress(const char* address, bool withDuplicates = true);
 
 	/**
 	 * Registers filter with service data uuid uuid and calls scan()
 	 *
 	 * @param[in] uuid            16-bit UUID string, e.g. "180D" (Heart Rate), either lowercase or uppercase letters.
 	 * See https://www.bluetooth.com/specifications/assigned-numbers/
-	 * @param[in] withDuplicates  If true, returns duplicate advertisements. (Not implemented)
+	 * @param[in] withDuplicates  If false, ignores duplicate advertisements. See setDuplicateFilter().
 	 *
 	 * @return true on success
 	 * @return false on failure
 	 */
-	bool scanForUuid(const char* uuid, bool withDuplicates = false);
+	bool scanForUuid(const char* uuid, bool withDuplicates = true);
 
 	/**
 	 * Sends command to bluenet to stop calling registered microapp callback function upon receiving advertisements
@@ -289,11 +335,76 @@ public:
 	bool stopScan();
 
 	/**
-	 * Returns last scanned device which matched the filter
+	 * Returns the oldest scanned device which matched the filter, and which has not been returned before.
+	 *
+	 * Scanned devices are buffered (see BLE_SCAN_BUFFER_SIZE), unless a BLEDeviceScanned event handler is set.
 	 *
-	 * @return BleDevice object representing the discovered device
+	 * @return BleDevice object representing the discovered device, evaluates to false if there is none
 	 */
 	BleDevice& available();
+
+	/**
+	 * Get the filters that scanned devices have to pass, on top of the filter set by scanForName() and the like.
+	 *
+	 * Devices that do not pass are ignored before they are buffered or passed to the BLEDeviceScanned event handler.
+	 *
+	 * @return a reference (!) to the filter chain, to add filters and query their counters
+	 */
+	BleScanFilterChain& scanFilters();
+
+	/**
+	 * Configure when an advertisement of a device that was scanned before counts as duplicate.
+	 *
+	 * Only applies when scanning without duplicates. Duplicates are ignored before they are buffered or passed to
+	 * the BLEDeviceScanned event handler.
+	 *
+	 * @param[in] timeToLiveMs   Time in ms after which a device is reported again, rounded up to loop intervals.
+	 * @param[in] rssiThreshold  RSSI change in dB after which a device is reported again, 0 to ignore RSSI changes.
+	 */
+	void setDuplicateFilter(uint32_t timeToLiveMs, uint8_t rssiThreshold = 0);
+
+	/**
+	 * Query the number of advertisements that were ignored as duplicates
+	 *
+	 * @return the number of duplicate advertisements since scanning started
+	 */
+	uint16_t duplicateScanCount();
+
+	/**
+	 * Query the number of scanned devices that are buffered, and can be retrieved via available()
+	 *
+	 * @return the number of buffered scanned devices
+	 */
+	uint8_t scannedCount();
+
+	/**
+	 * Query the number of scanned devices that were dropped because the scan buffer was full
+	 *
+	 * @return the number of dropped scanned devices since scanning started
+	 */
+	uint16_t droppedScanCount();
+
+	/**
+	 * Query if a request to a remote peripheral, like BleCharacteristic::readValueAsync(), has not completed yet
+	 *
+	 * @param token the token returned when the request was sent
+	 * @return true if the handler of the request has not been called yet
+	 * @return false otherwise
+	 */
+	bool requestPending(BleRequestToken token);
+
+	/**
+	 * Stop waiting for a request to a remote peripheral: its handler will not be called
+	 *
+	 * @param token the token returned when the request was sent
+	 */
+	void cancelRequest(BleRequestToken token);
+
+	/**
+	 * Forget the discovered services and characteristics of all peripherals, so that they are discovered again on
+	 * the next connection. Needed when the services of a peripheral changed, for example after a firmware update.
+	 */
+	void clearAttributeCache();
 };
 
 #define BLE Ble::getInstance()
@@ -0,0 +1,126 @@
+/*
+ * Cache of the services and characteristics of remote peripherals, to skip discovery when reconnecting.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <BleMacAddress.h>
+#include <microapp.h>
+
+// Number of peripherals of which the discovered attributes are remembered.
+#ifndef BLE_ATTRIBUTE_CACHE_SIZE
+#define BLE_ATTRIBUTE_CACHE_SIZE 2
+#endif
+
+// Max number of services plus characteristics that are remembered per peripheral.
+#ifndef BLE_ATTRIBUTE_CACHE_MAX_ATTRIBUTES
+#define BLE_ATTRIBUTE_CACHE_MAX_ATTRIBUTES 8
+#endif
+
+/**
+ * Remembers the services and characteristics discovered on a peripheral, with their handles, by MAC address. When
+ * reconnecting to that peripheral, they are restored from the cache, and the discovery is skipped.
+ *
+ * Each peripheral has one entry: the discovery of the last requested service. When the cache is full, the entry that
+ * was used longest ago is replaced. A peripheral with more attributes than fit in an entry is not cached.
+ *
+ * The attributes are stored in the order of the discover events: a service, followed by its characteristics. The
+ * entries only hold plain values, so they could be written to flash as they are. UUIDs that are not standard refer
+ * to the registered UUIDs though, which are only valid while the microapp runs.
+ */
+class BleAttributeCache {
+private:
+	struct Attribute {
+		microapp_sdk_ble_uuid_t uuid;
+		//! 0 for a service.
+		uint16_t valueHandle;
+		uint16_t cccdHandle;
+		microapp_sdk_ble_characteristic_options_t options;
+	};
+
+	struct Entry {
+		uint8_t address[MAC_ADDRESS_LENGTH];
+		bool used = false;
+		//! The service that was requested to be discovered.
+		microapp_sdk_ble_uuid_t service;
+		//! Value of _useCount when the entry was last used.
+		uint16_t usedAt;
+		uint8_t attributeCount;
+		Attribute attributes[BLE_ATTRIBUTE_CACHE_MAX_ATTRIBUTES];
+	};
+
+	Entry _entries[BLE_ATTRIBUTE_CACHE_SIZE];
+
+	uint16_t _useCount = 0;
+
+	//! The entry that the discovery in progress is stored in, or nullptr.
+	Entry* _recording = nullptr;
+
+	Entry* get(const uint8_t* address);
+
+public:
+	/**
+	 * Find the attributes of a peripheral, and mark them as used.
+	 *
+	 * @param[in] address  Pointer to the MAC address of the peripheral.
+	 * @param[in] service  The service to discover.
+	 * @return the number of cached attributes, or 0 if the discovery of that service is not cached.
+	 */
+	uint8_t find(const uint8_t* address, microapp_sdk_ble_uuid_t service);
+
+	/**
+	 * Get a cached attribute of a peripheral, as the discover event it was stored from.
+	 *
+	 * @param[in] address         Pointer to the MAC address of the peripheral.
+	 * @param[in] index           Index of the attribute, see find().
+	 * @param[out] eventDiscover  The discover event.
+	 * @return false if there is no such attribute.
+	 */
+	bool getAttribute(const uint8_t* address, uint8_t index, microapp_sdk_ble_central_event_discover_t& eventDiscover);
+
+	/**
+	 * Start storing the discovery of a service on a peripheral. Replaces the entry of the peripheral, or the entry
+	 * that was used longest ago.
+	 */
+	void startRecording(const uint8_t* address, microapp_sdk_ble_uuid_t service);
+
+	/**
+	 * Store a discover event of the discovery in progress, if any.
+	 */
+	void record(microapp_sdk_ble_central_event_discover_t* eventDiscover);
+
+	/**
+	 * Finish storing the discovery in progress: the entry can be found from now on.
+	 */
+	void finishRecording();
+
+	/**
+	 * Stop storing the discovery in progress, for example when it failed. The entry stays empty.
+	 */
+	void cancelRecording();
+
+	/**
+	 * Forget the attributes of a peripheral, for example when its services changed.
+	 *
+	 * @param[in] address  Pointer to the MAC address of the peripheral.
+	 */
+	void remove(const uint8_t* address);
+
+	/**
+	 * Forget the attributes of all peripherals.
+	 */
+	void clear();
+};
+
+/**
+ * Restore the services and characteristics of the peripheral of the BLE class from the attribute cache, as if
+ * discovered. When not cached, the discovery that follows is stored.
+ *
+ * @return true if restored from the cache.
+ */
+bool discoverCachedService(microapp_sdk_ble_uuid_t service);
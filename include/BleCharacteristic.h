@@ -1,5 +1,6 @@
 #pragma once
 
+#include <BleRequest.h>
 #include <BleUuid.h>
 #include <BleUtils.h>
 #include <String.h>
@@ -40,6 +41,7 @@ private:
 	 */
 	friend class Ble;
 	friend class BleDevice;
+	friend class BleRequestTable;
 	friend class BleService;
 
 	// Constructor for remote characteristics
@@ -77,8 +79,6 @@ private:
 	uint16_t _cccdHandle  = 0;
 	uint16_t _cccdValue   = 0;
 
-	BleAsyncResult _asyncResult = BleAsyncNotWaiting;
-
 	Uuid _uuid;
 
 	/**
@@ -116,7 +116,7 @@ private:
 	 * @return CS_MICROAPP_SDK_ACK_ERR_EMPTY if BleCharacteristic not initialized
 	 * @return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED if BleCharacteristic is not remote but local
 	 * @return CS_MICROAPP_SDK_ACK_ERR_DISABLED if characteristic can't be written
-	 * @return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT if no (valid) WRITE event is received within timeout
+	 * @return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT if no WRITE event is received within timeout
 	 * @return microapp_sdk_result_t specifying other error
 	 */
 	microapp_sdk_result_t writeValueRemote(uint8_t* buffer, uint16_t length, uint32_t timeout = 5000);
@@ -132,29 +132,54 @@ private:
 	 * @return CS_MICROAPP_SDK_ACK_ERR_EMPTY if BleCharacteristic not initialized
 	 * @return CS_MICROAPP_SDK_ACK_ERR_DISABLED if characteristic can't be read
 	 * @return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED if BleCharacteristic is not remote but local
-	 * @return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT if no (valid) READ event is received within timeout
+	 * @return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT if no READ event is received within timeout
 	 * @return microapp_sdk_result_t specifying other error
 	 */
 	microapp_sdk_result_t readValueRemote(uint8_t* buffer, uint16_t length, uint32_t timeout = 5000);
 
-	microapp_sdk_result_t onRemoteWritten();
-	microapp_sdk_result_t onRemoteRead(microapp_sdk_ble_central_event_read_t* eventRead);
-	microapp_sdk_result_t onRemoteNotification(microapp_sdk_ble_central_event_notification_t* eventNotification);
+	/**
+	 * Queue a WRITE request for an attribute of a remote characteristic, without waiting for the WRITE event
+	 *
+	 * @param handle the value handle, or the cccd handle
+	 * @param buffer buffer to write, has to stay valid until the request completes
+	 * @param length length of the buffer, can be longer than fits in a single packet
+	 * @param handler called when the request completes, or nullptr to wait for it with the request table
+	 * @param[out] token the token of the request
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS when the request has been queued or sent
+	 * @return microapp_sdk_result_t specifying error
+	 */
+	microapp_sdk_result_t requestWriteRemote(
+			uint16_t handle, uint8_t* buffer, uint16_t length, BleRequestHandler handler, BleRequestToken& token);
 
-	microapp_sdk_result_t onLocalWritten(microapp_sdk_ble_peripheral_event_write_t* eventWrite);
-	microapp_sdk_result_t onLocalSubscribed();
-	microapp_sdk_result_t onLocalUnsubscribed();
-	microapp_sdk_result_t onLocalNotificationDone();
+	/**
+	 * Queue a READ request for a remote characteristic, without waiting for the READ events
+	 *
+	 * @param buffer buffer to read value to, has to stay valid until the request completes
+	 * @param length (max) length of buffer to write the read value to, can be longer than fits in a single event
+	 * @param handler called when the request completes, or nullptr to wait for it with the request table
+	 * @param[out] token the token of the request
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS when the request has been queued or sent
+	 * @return microapp_sdk_result_t specifying error
+	 */
+	microapp_sdk_result_t requestReadRemote(
+			uint8_t* buffer, uint16_t length, BleRequestHandler handler, BleRequestToken& token);
 
 	/**
-	 * Wait for an event from bluenet after a request made to bluenet
+	 * Write _cccdValue to the client characteristic configuration descriptor, to subscribe or unsubscribe
 	 *
 	 * @param timeout in milliseconds
-	 * @return CS_MICROAPP_SDK_ACK_SUCCESS if event was received with success
-	 * @return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT if event was not received within timeout
-	 * @return CS_MICROAPP_SDK_ACK_ERROR if event result with failure
+	 * @return true on success
+	 * @return false on failure
 	 */
-	microapp_sdk_result_t waitForAsyncResult(uint32_t timeout);
+	bool writeCccdRemote(uint32_t timeout);
+
+	microapp_sdk_result_t onRemoteRead(uint8_t* buffer, uint16_t length);
+	microapp_sdk_result_t onRemoteNotification(microapp_sdk_ble_central_event_notification_t* eventNotification);
+
+	microapp_sdk_result_t onLocalWritten(microapp_sdk_ble_peripheral_event_write_t* eventWrite);
+	microapp_sdk_result_t onLocalSubscribed();
+	microapp_sdk_result_t onLocalUnsubscribed();
+	microapp_sdk_result_t onLocalNotificationDone();
 
 	/**
 	 * Internal function for setting generic event handler
@@ -188,7 +213,7 @@ public:
 	 *
 	 * @return UUID of the BLE characteristic as a string
 	 */
-	String uuid();
+	UuidString uuid();
 
 	/**
 	 * Query the property mask of the specified BLECharacteristic
@@ -238,6 +263,30 @@ public:
 	 */
 	bool writeValue(uint8_t* buffer, uint16_t length);
 
+	/**
+	 * Read the value of a remote characteristic, without waiting for the result
+	 *
+	 * The value is read into the buffer, which has to stay valid until the handler is called. After a successful
+	 * read, valueLength() is the number of bytes read. Requests to the peripheral are queued, and sent one after the
+	 * other, so several reads and writes can be requested at once.
+	 *
+	 * @param[in] buffer byte array to read value into
+	 * @param[in] length size of buffer argument in bytes
+	 * @param[in] handler function to call when the read completes
+	 * @return token passed to the handler, or BLE_REQUEST_TOKEN_NONE if the request could not be sent
+	 */
+	BleRequestToken readValueAsync(uint8_t* buffer, uint16_t length, BleRequestHandler handler);
+
+	/**
+	 * Write the value of a remote characteristic, without waiting for the result
+	 *
+	 * @param buffer byte array to write value with, has to stay valid until the handler is called
+	 * @param length number of bytes of the buffer argument to write
+	 * @param[in] handler function to call when the write completes
+	 * @return token passed to the handler, or BLE_REQUEST_TOKEN_NONE if the request could not be sent
+	 */
+	BleRequestToken writeValueAsync(uint8_t* buffer, uint16_t length, BleRequestHandler handler);
+
 	/**
 	 * Set the event handler (callback) function that will be called when the specified event occurs
 	 *
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <BleAttributeCache.h>
+#include <BleRequest.h>
 #include <BleScan.h>
 #include <BleService.h>
 #include <BleMacAddress.h>
@@ -12,6 +14,9 @@
 #define MAX_REMOTE_SERVICES 2
 #endif
 
+// The local name of a device can be at most as long as the advertisement data.
+typedef FixedString<MAX_BLE_ADV_DATA_LENGTH> LocalNameString;
+
 // Forward declarations
 bool registeredBleInterrupt(MicroappSdkBleType bleType);
 microapp_sdk_result_t registerBleInterrupt(MicroappSdkBleType bleType);
@@ -33,6 +38,8 @@ private:
 	// raw scan data
 	uint8_t _scanData[MAX_BLE_ADV_DATA_LENGTH];
 	uint8_t _scanSize = 0;
+	// index of the AD structures in the raw scan data
+	BleScanIndex _scanIndex;
 
 	MacAddress _address;
 	rssi_t _rssi = 127;
@@ -107,7 +114,28 @@ private:
 	microapp_sdk_result_t getCharacteristic(uint16_t handle, BleCharacteristic** characteristic);
 
 	/**
-	 * Wait for an event from bluenet after a request made to bluenet
+	 * Send a CONNECT request to bluenet, without waiting for the CONNECT event
+	 *
+	 * @param handler called when the request completes, or nullptr to wait for it with the request table
+	 * @param[out] token the token of the request
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS when the request has been sent, or when already connected
+	 * @return microapp_sdk_result_t specifying error
+	 */
+	microapp_sdk_result_t requestConnect(BleRequestHandler handler, BleRequestToken& token);
+
+	/**
+	 * Send a DISCOVER request to bluenet, without waiting for the DISCOVER_DONE event
+	 *
+	 * @param serviceUuid string containing uuid of the service to be discovered
+	 * @param handler called when the request completes, or nullptr to wait for it with the request table
+	 * @param[out] token the token of the request
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS when the request has been sent, or when already discovered
+	 * @return microapp_sdk_result_t specifying error
+	 */
+	microapp_sdk_result_t requestDiscover(const char* serviceUuid, BleRequestHandler handler, BleRequestToken& token);
+
+	/**
+	 * Wait for an event from bluenet after a disconnect request made to bluenet
 	 *
 	 * @param timeout in milliseconds
 	 * @return true if event was received with success
@@ -148,7 +176,7 @@ public:
 	 *
 	 * @return string in the format "AA:BB:CC:DD:EE:FF".
 	 */
-	String address();
+	MacAddressString address();
 
 	/**
 	 * Get received signal strength of last scanned advertisement of the device.
@@ -168,6 +196,9 @@ public:
 	/**
 	 * Discover the attributes of a particular service on the BLE device
 	 *
+	 * When the service was discovered on an earlier connection to this device, the attributes are restored from the
+	 * attribute cache right away, without a request to bluenet.
+	 *
 	 * @param serviceUuid string containing uuid of the service to be discovered
 	 * @param timeout in milliseconds
 	 * @return true if successful
@@ -175,6 +206,18 @@ public:
 	 */
 	bool discoverService(const char* serviceUuid, uint32_t timeout = 5000);
 
+	/**
+	 * Discover the attributes of a particular service on the BLE device, without waiting for the result
+	 *
+	 * When the service has been discovered already, or is restored from the attribute cache, the handler is called at the
+	 * end of the loop.
+	 *
+	 * @param serviceUuid string containing uuid of the service to be discovered
+	 * @param handler function to call when the discovery completes
+	 * @return token passed to the handler, or BLE_REQUEST_TOKEN_NONE if the request could not be sent
+	 */
+	BleRequestToken discoverServiceAsync(const char* serviceUuid, BleRequestHandler handler);
+
 	/**
 	 * Query the numer of services discovered for the BLE device
 	 *
@@ -237,7 +280,7 @@ public:
 	 * @return string of the advertisement data in either the complete local name field or the shortened local name
 	 * field Returns empty string if the device does not advertise a local name.
 	 */
-	String localName();
+	LocalNameString localName();
 
 	/**
 	 * Query if a discovered BLE device is advertising a service UUID
@@ -260,7 +303,62 @@ public:
 	 * @param index (optional) the index of the service UUID. Defaults to 0
 	 * @return advertised service UUID (as a string)
 	 */
-	String advertisedServiceUuid(uint8_t index = 0);
+	UuidString advertisedServiceUuid(uint8_t index = 0);
+
+	/**
+	 * Query if a discovered BLE device is advertising manufacturer specific data
+	 *
+	 * @return true if the device is advertising manufacturer specific data
+	 * @return false otherwise
+	 */
+	bool hasManufacturerData();
+
+	/**
+	 * Query the length of the manufacturer specific data, including the 16-bit company id
+	 *
+	 * @return the length of the manufacturer specific data, or 0 if there is none
+	 */
+	uint8_t manufacturerDataLength();
+
+	/**
+	 * Copy the manufacturer specific data, including the 16-bit company id
+	 *
+	 * @param[out] value buffer to copy the data to
+	 * @param[in] length size of the buffer
+	 * @return the number of copied bytes
+	 */
+	uint8_t manufacturerData(uint8_t value[], uint8_t length);
+
+	/**
+	 * Query if a discovered BLE device is advertising service data, for a 16-bit, 32-bit or 128-bit service uuid
+	 *
+	 * @return true if the device is advertising service data
+	 * @return false otherwise
+	 */
+	bool hasServiceData();
+
+	/**
+	 * Query the service uuid of the advertised service data
+	 *
+	 * @return service uuid (as a string), empty if there is no service data
+	 */
+	UuidString serviceDataUuid();
+
+	/**
+	 * Query the length of the advertised service data, excluding the service uuid
+	 *
+	 * @return the length of the service data, or 0 if there is none
+	 */
+	uint8_t serviceDataLength();
+
+	/**
+	 * Copy the advertised service data, excluding the service uuid
+	 *
+	 * @param[out] value buffer to copy the data to
+	 * @param[in] length size of the buffer
+	 * @return the number of copied bytes
+	 */
+	uint8_t serviceData(uint8_t value[], uint8_t length);
 
 	/**
 	 * Connect to a BLE device
@@ -271,6 +369,16 @@ public:
 	 */
 	bool connect(uint32_t timeout = 5000);
 
+	/**
+	 * Connect to a BLE device, without waiting for the result
+	 *
+	 * When already connected, the handler is called at the end of the loop.
+	 *
+	 * @param handler function to call when the connection is made, or failed
+	 * @return token passed to the handler, or BLE_REQUEST_TOKEN_NONE if the request could not be sent
+	 */
+	BleRequestToken connectAsync(BleRequestHandler handler);
+
 	/**
 	 * Find an advertisement of type type in the scanned advertisement data
 	 *
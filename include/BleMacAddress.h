@@ -1,6 +1,7 @@
 #pragma once
 
 #include <BleUtils.h>
+#include <String.h>
 #include <microapp.h>
 
 // length of mac address is defined on bluenet side
@@ -8,6 +9,8 @@ extern const uint8_t MAC_ADDRESS_LENGTH;
 // format "AA:BB:CC:DD:EE:FF"
 const microapp_size_t MAC_ADDRESS_STRING_LENGTH = 17;
 
+typedef FixedString<MAC_ADDRESS_STRING_LENGTH> MacAddressString;
+
 /*
  * The MacAddress class stores a buffer containing a mac address
  * This class enables e.g. easy comparison of addresses, and getting a string version of the address
@@ -46,7 +49,8 @@ public:
 	MacAddress(const uint8_t* address, uint8_t size, uint8_t type);
 	MacAddress(const char* addressString);
 
-	const char* string();
+	// Returns an empty string if the address is not initialized.
+	MacAddressString string();
 	const uint8_t* bytes();
 	const uint8_t type();
 
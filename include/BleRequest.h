@@ -0,0 +1,262 @@
+/*
+ * Requests to a remote BLE peripheral, that complete with an event from bluenet.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <microapp.h>
+
+// Max number of requests to a remote peripheral that can be queued or wait for their result at the same time.
+#ifndef BLE_MAX_PENDING_REQUESTS
+#define BLE_MAX_PENDING_REQUESTS 4
+#endif
+
+// Time in ms to wait for the next part of a long value, before the read completes with the parts read so far.
+#ifndef BLE_READ_PART_TIMEOUT_MS
+#define BLE_READ_PART_TIMEOUT_MS 1000
+#endif
+
+class BleCharacteristic;
+
+/**
+ * Identifies a request, from when it is sent until its handler is called.
+ */
+typedef uint8_t BleRequestToken;
+
+// Returned instead of a token when the request could not be sent.
+const BleRequestToken BLE_REQUEST_TOKEN_NONE = 0;
+
+/**
+ * Called when a request completes, with CS_MICROAPP_SDK_ACK_SUCCESS or the error.
+ *
+ * Called from the BLE interrupt handler, so it can send the next request right away. A request that completes while
+ * it is sent, for example a connect when already connected, is completed at the end of setup or of the loop instead:
+ * the handler is never called before the token is returned.
+ */
+typedef void (*BleRequestHandler)(BleRequestToken token, microapp_sdk_result_t result);
+
+enum BleRequestType : uint8_t {
+	BleRequestNone = 0,
+	BleRequestConnect,
+	BleRequestDiscover,
+	BleRequestRead,
+	BleRequestWrite,
+};
+
+/**
+ * Requests that wait for their result, so that the event with the result can be passed on to the right handler.
+ *
+ * Bluenet handles one request to the peripheral at a time. Discover, read and write requests are queued, and the
+ * next one is sent as soon as the result of the previous one comes in, from the event handler. So bluenet stays busy,
+ * without waiting for the loop.
+ *
+ * A request with a handler is removed when the handler is called. A request without a handler is waited for with
+ * wait(), which removes it.
+ */
+class BleRequestTable {
+private:
+	enum RequestState : uint8_t {
+		REQUEST_QUEUED = 0,
+		REQUEST_SENT,
+		REQUEST_DONE,
+		//! Completed while it was sent: the handler is called by completeDeferred().
+		REQUEST_DEFERRED,
+	};
+
+	struct Request {
+		//! BLE_REQUEST_TOKEN_NONE when the entry is free.
+		BleRequestToken token = BLE_REQUEST_TOKEN_NONE;
+		BleRequestType type   = BleRequestNone;
+		RequestState state    = REQUEST_QUEUED;
+		microapp_sdk_result_t result;
+		uint16_t connectionHandle;
+		//! Attribute handle for reads and writes, 0 otherwise.
+		uint16_t handle;
+		//! Buffer to read into, or to write from.
+		uint8_t* buffer;
+		//! Size of the buffer to read into, or number of bytes to write.
+		uint16_t length;
+		//! Offset of the next part of the value, the number of bytes read so far.
+		uint16_t readOffset;
+		//! Time in ms at which the last part of the value came in.
+		uint32_t readPartMs;
+		//! Characteristic of which the value is read.
+		BleCharacteristic* characteristic;
+		//! Service to discover.
+		microapp_sdk_ble_uuid_t uuid;
+		BleRequestHandler handler;
+	};
+
+	Request _requests[BLE_MAX_PENDING_REQUESTS];
+
+	BleRequestToken _lastToken = BLE_REQUEST_TOKEN_NONE;
+
+	bool _hasDeferred = false;
+
+	Request* get(BleRequestToken token);
+
+	/**
+	 * Allocate an entry for a request.
+	 *
+	 * @return the request, or nullptr if there is no space.
+	 */
+	Request* allocate(BleRequestType type, uint16_t handle, BleRequestHandler handler);
+
+	/**
+	 * Send the oldest queued request, unless a request is in progress.
+	 */
+	void sendNext();
+
+	/**
+	 * Send a queued request to bluenet.
+	 *
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS when the request has been sent
+	 * @return microapp_sdk_result_t specifying the error returned by bluenet
+	 */
+	microapp_sdk_result_t sendQueued(Request& request);
+
+	/**
+	 * Queue a request, and send it if no other request is in progress.
+	 */
+	microapp_sdk_result_t queue(Request& request, BleRequestToken& token);
+
+public:
+	/**
+	 * Add a request that is not sent, for example to complete it right away.
+	 *
+	 * @return the token of the request, or BLE_REQUEST_TOKEN_NONE if there is no space.
+	 */
+	BleRequestToken add(BleRequestType type, uint16_t handle, BleRequestHandler handler);
+
+	/**
+	 * Send the request in the outgoing message buffer, and add it.
+	 *
+	 * When bluenet finishes the request right away, it completes with completeLater().
+	 *
+	 * @param[out] token the token of the request
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS when the request has been sent
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if too many requests wait for their result
+	 * @return microapp_sdk_result_t specifying the error returned by bluenet
+	 */
+	microapp_sdk_result_t send(BleRequestType type, uint16_t handle, BleRequestHandler handler, BleRequestToken& token);
+
+	/**
+	 * Queue a request to discover a service.
+	 *
+	 * @param[out] token the token of the request
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS when the request has been queued or sent
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if the queue is full
+	 * @return microapp_sdk_result_t specifying the error returned by bluenet
+	 */
+	microapp_sdk_result_t queueDiscover(
+			uint16_t connectionHandle, microapp_sdk_ble_uuid_t uuid, BleRequestHandler handler, BleRequestToken& token);
+
+	/**
+	 * Queue a request to read the value of a characteristic. A long value is read in several events, see addReadData().
+	 *
+	 * @param buffer buffer to read into, has to stay valid until the request completes
+	 * @param length size of the buffer
+	 * @param[out] token the token of the request
+	 * @return see queueDiscover()
+	 */
+	microapp_sdk_result_t queueRead(uint16_t connectionHandle, uint16_t handle, BleCharacteristic* characteristic,
+			uint8_t* buffer, uint16_t length, BleRequestHandler handler, BleRequestToken& token);
+
+	/**
+	 * Queue a request to write the value of an attribute. Bluenet writes a long value in parts.
+	 *
+	 * @param buffer buffer to write, has to stay valid until the request completes
+	 * @param length number of bytes to write
+	 * @param[out] token the token of the request
+	 * @return see queueDiscover()
+	 */
+	microapp_sdk_result_t queueWrite(uint16_t connectionHandle, uint16_t handle, uint8_t* buffer, uint16_t length,
+			BleRequestHandler handler, BleRequestToken& token);
+
+	/**
+	 * Find the request that waits for the result of an event.
+	 *
+	 * @return the token of the request, or BLE_REQUEST_TOKEN_NONE if there is none.
+	 */
+	BleRequestToken find(BleRequestType type, uint16_t handle);
+
+	/**
+	 * Copy the data of a read event to the buffer of the read request. Data that does not fit is dropped.
+	 *
+	 * Bluenet sends a value longer than the data of a read event in several events, with increasing offset, and does
+	 * not send the length of the value. The last part is shorter than the data of a read event, so it is empty when the
+	 * length is a multiple of it. A part at another offset than expected is ignored, as it belongs to an earlier read.
+	 *
+	 * @return true when this was the last part of the value
+	 */
+	bool addReadData(BleRequestToken token, microapp_sdk_ble_central_event_read_t* eventRead);
+
+	/**
+	 * Set the value of the characteristic to the data read, and complete the read request.
+	 *
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS, or the error the request completed with
+	 */
+	microapp_sdk_result_t completeRead(BleRequestToken token);
+
+	/**
+	 * Complete the reads of which the next part did not come in within BLE_READ_PART_TIMEOUT_MS, with the parts read
+	 * so far. In case bluenet does not send the empty last part of a value.
+	 */
+	void completeStalledReads();
+
+	/**
+	 * Set the result of a request, send the next queued request, and call the handler.
+	 */
+	void complete(BleRequestToken token, microapp_sdk_result_t result);
+
+	/**
+	 * Set the result of a request that completed while it was sent, before its token was returned to the caller.
+	 *
+	 * A request without handler completes right away. Otherwise, the handler is called by completeDeferred().
+	 */
+	void completeLater(BleRequestToken token, microapp_sdk_result_t result);
+
+	/**
+	 * Call the handlers of the requests that were completed with completeLater().
+	 */
+	void completeDeferred();
+
+	/**
+	 * Complete every request with the given result, for example when the connection is lost.
+	 */
+	void completeAll(microapp_sdk_result_t result);
+
+	/**
+	 * Wait for the result of a request without handler, and remove it.
+	 *
+	 * @param timeout in milliseconds
+	 * @return the result of the request
+	 * @return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT if the request did not complete within timeout
+	 */
+	microapp_sdk_result_t wait(BleRequestToken token, uint32_t timeout);
+
+	/**
+	 * Check if a request has not completed yet, or its handler has not been called yet.
+	 */
+	bool pending(BleRequestToken token);
+
+	/**
+	 * Remove a request: its handler will not be called.
+	 */
+	void remove(BleRequestToken token);
+
+	/**
+	 * Remove all requests.
+	 */
+	void clear();
+};
+
+/**
+ * Get the requests to the remote peripheral, which the BLE class sends.
+ */
+BleRequestTable& getBleRequestTable();
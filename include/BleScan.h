@@ -17,14 +17,77 @@ struct ble_ad_t {
 	const uint8_t* data = nullptr;
 };
 
+/**
+ * Compact copy of a scanned advertisement, as stored in the scan buffer
+ */
+struct ble_scan_record_t {
+	uint8_t address[MAC_ADDRESS_LENGTH];
+	uint8_t addressType;
+	rssi_t rssi;
+	uint8_t size;
+	uint8_t data[MAX_BLE_ADV_DATA_LENGTH];
+};
+
+// Number of GAP advertisement types that are indexed by BleScanIndex: the ones listed in GapAdvType
+const uint8_t BLE_SCAN_INDEX_SIZE = 13;
+
+/**
+ * Index of the AD structures in raw scan data, per GAP advertisement type
+ *
+ * The scan data is walked only once, after which the AD structure of a type listed in GapAdvType is found in
+ * constant time. Only the first AD structure of each type is indexed. The index holds offsets rather than pointers,
+ * so it stays valid when the scan data is copied along with it.
+ */
+class BleScanIndex {
+private:
+	// Offset plus one of the first AD structure of each type, 0 if there is none
+	uint8_t _offsets[BLE_SCAN_INDEX_SIZE] = {0};
+
+	/**
+	 * Get the index in _offsets for a GAP advertisement type
+	 *
+	 * @return the index, or -1 if the type is not indexed
+	 */
+	static int8_t getSlot(uint8_t type);
+
+public:
+	BleScanIndex(){};
+	BleScanIndex(const uint8_t* scanData, uint8_t scanSize);
+
+	/**
+	 * Walk the scan data and index its AD structures. A malformed AD structure ends the walk.
+	 */
+	void build(const uint8_t* scanData, uint8_t scanSize);
+
+	/**
+	 * Check whether a GAP advertisement type can be looked up with find()
+	 */
+	static bool indexed(GapAdvType type);
+
+	/**
+	 * Find the AD structure of a type in the scan data that was indexed
+	 *
+	 * @param[in] scanData      The scan data that was passed to build()
+	 * @param[in] type          GAP advertisement type, must be indexed
+	 * @param[out] foundData    ad containing a pointer to data and its length
+	 *
+	 * @return true             if the advertisement data of given type is found.
+	 * @return false            if the advertisement data of given type is not found.
+	 */
+	bool find(const uint8_t* scanData, GapAdvType type, ble_ad_t* foundData) const;
+};
+
 /**
  * Helper wrapper class for scan data
  * Does not contain the actual data but only a pointer to it
+ *
+ * Lookups are done via a BleScanIndex of the scan data
  */
 class BleScan {
 private:
 	friend class BleDevice;
 	friend class Ble;
+	friend class BleScanFilterChain;
 
 	BleScan(){}; // default constructor
 
@@ -32,6 +95,8 @@ private:
 	 * Tries to find an ad of specified GAP ad data type in the raw scan data
 	 * If found returns true and a ble_ad_t with ad type, length and pointer to its data
 	 *
+	 * Walks the scan data: prefer BleScanIndex when looking up more than one type.
+	 *
 	 * @param[in] type          GAP advertisement type
 	 * @param[out] foundData    ad containing a pointer to data and its length
 	 *
@@ -47,6 +112,11 @@ public:
 	 *
 	 * @return An ad with a pointer to the local name and its length (nullptr and 0 if not found, respectively)
 	 */
+	static ble_ad_t localName(const uint8_t* scanData, const BleScanIndex& index);
+
+	/**
+	 * Same as above, but indexes the scan data first: prefer the indexed version for more than one lookup.
+	 */
 	static ble_ad_t localName(const uint8_t* scanData, uint8_t scanSize);
 
 	/**
@@ -56,6 +126,11 @@ public:
 	 * @return true if found
 	 * @return false if not found
 	 */
+	static bool hasServiceUuid(const uint8_t* scanData, const BleScanIndex& index, uuid16_t uuid = 0);
+
+	/**
+	 * Same as above, but indexes the scan data first: prefer the indexed version for more than one lookup.
+	 */
 	static bool hasServiceUuid(const uint8_t* scanData, uint8_t scanSize, uuid16_t uuid = 0);
 
 	/**
@@ -63,14 +138,48 @@ public:
 	 *
 	 * @return the number of services advertised
 	 */
+	static uint8_t serviceUuidCount(const uint8_t* scanData, const BleScanIndex& index);
+
+	/**
+	 * Same as above, but indexes the scan data first: prefer the indexed version for more than one lookup.
+	 */
 	static uint8_t serviceUuidCount(const uint8_t* scanData, uint8_t scanSize);
 
 	/**
 	 * Return the uuid advertised by the device, indexed by the index parameter
 	 *
-	 * @param index (optional) index of the service uuid. Default 0
-	 * @return uuid indexed by index. Returns 0 if not found
+	 * @param uuidIndex (optional) index of the service uuid. Default 0
+	 * @return uuid indexed by uuidIndex. Returns 0 if not found
 	 */
-	static uuid16_t serviceUuid(const uint8_t* scanData, uint8_t scanSize, uint8_t index = 0);
+	static uuid16_t serviceUuid(const uint8_t* scanData, const BleScanIndex& index, uint8_t uuidIndex = 0);
 
+	/**
+	 * Same as above, but indexes the scan data first: prefer the indexed version for more than one lookup.
+	 */
+	static uuid16_t serviceUuid(const uint8_t* scanData, uint8_t scanSize, uint8_t uuidIndex = 0);
+
+	/**
+	 * Query the manufacturer specific data advertised in the scan
+	 *
+	 * @return An ad with a pointer to the data, starting with the 16-bit company id, and its length (nullptr and 0 if
+	 * not found, respectively)
+	 */
+	static ble_ad_t manufacturerData(const uint8_t* scanData, const BleScanIndex& index);
+
+	/**
+	 * Query the service data advertised in the scan, for a 16-bit, 32-bit or 128-bit service uuid
+	 *
+	 * @param uuidLength (optional) length of the service uuid in bytes: 2, 4, or 16. Default 0 means the first one
+	 * found, in that order
+	 * @return An ad with a pointer to the data, starting with the service uuid, and its length (nullptr and 0 if not
+	 * found, respectively). The type of the ad tells the length of the uuid.
+	 */
+	static ble_ad_t serviceData(const uint8_t* scanData, const BleScanIndex& index, uint8_t uuidLength = 0);
+
+	/**
+	 * Get the length of the service uuid at the start of a service data ad
+	 *
+	 * @return the length in bytes, or 0 if the ad is not a service data ad
+	 */
+	static uint8_t serviceDataUuidLength(const ble_ad_t& serviceData);
 };
@@ -0,0 +1,93 @@
+/*
+ * Cache of scanned devices, to filter out duplicate advertisements.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <BleMacAddress.h>
+#include <BleUtils.h>
+#include <microapp.h>
+
+// Number of device addresses that are remembered. Must be a power of 2.
+#ifndef BLE_SCAN_CACHE_SIZE
+#define BLE_SCAN_CACHE_SIZE 16
+#endif
+
+// Time after which an advertisement of a device is reported again, even if it is a duplicate.
+#ifndef BLE_SCAN_CACHE_DEFAULT_TTL_MS
+#define BLE_SCAN_CACHE_DEFAULT_TTL_MS 10000
+#endif
+
+/**
+ * Remembers the addresses of recently reported devices, so that duplicate advertisements can be ignored.
+ *
+ * Addresses are stored in a hash table with linear probing, so a lookup only compares a few entries. When all entries
+ * in the probe sequence of an address are taken, the entry that was reported longest ago is replaced.
+ *
+ * Time is measured in loop intervals (see getLoopTickCount()), so the time to live is rounded up to whole intervals.
+ */
+class BleScanCache {
+	static_assert((BLE_SCAN_CACHE_SIZE & (BLE_SCAN_CACHE_SIZE - 1)) == 0, "BLE_SCAN_CACHE_SIZE must be a power of 2");
+	static_assert(BLE_SCAN_CACHE_SIZE <= 128, "BLE_SCAN_CACHE_SIZE must be at most 128");
+
+private:
+	static constexpr uint8_t MAX_PROBES = (BLE_SCAN_CACHE_SIZE < 4) ? BLE_SCAN_CACHE_SIZE : 4;
+
+	struct Entry {
+		uint8_t address[MAC_ADDRESS_LENGTH];
+		bool used = false;
+		//! RSSI of the last reported advertisement.
+		rssi_t rssi;
+		//! Loop tick count of the last reported advertisement.
+		uint32_t reportedTick;
+	};
+
+	Entry _entries[BLE_SCAN_CACHE_SIZE];
+
+	uint32_t _timeToLiveTicks = 0;
+	uint8_t _rssiThreshold    = 0;
+	uint16_t _duplicateCount  = 0;
+
+	uint8_t getIndex(const uint8_t* address);
+
+public:
+	BleScanCache();
+
+	/**
+	 * Set the time after which a device is reported again.
+	 *
+	 * @param[in] timeToLiveMs  Time in ms, 0 to report every advertisement.
+	 */
+	void setTimeToLive(uint32_t timeToLiveMs);
+
+	/**
+	 * Set the RSSI change after which a device is reported again, even if the time to live has not passed yet.
+	 *
+	 * @param[in] rssiThreshold  RSSI change in dB, 0 to ignore RSSI changes.
+	 */
+	void setRssiThreshold(uint8_t rssiThreshold);
+
+	/**
+	 * Check if an advertisement is a duplicate of a recently reported one. If not, it is remembered as reported.
+	 *
+	 * @param[in] address  Pointer to the MAC address of the advertiser.
+	 * @param[in] rssi     RSSI of the advertisement.
+	 * @return true if the advertisement is a duplicate and should be ignored.
+	 */
+	bool isDuplicate(const uint8_t* address, rssi_t rssi);
+
+	/**
+	 * Forget all devices, and reset the duplicate count.
+	 */
+	void clear();
+
+	/**
+	 * Get the number of advertisements that were found to be duplicates since the last clear().
+	 */
+	uint16_t duplicateCount();
+};
@@ -0,0 +1,162 @@
+/*
+ * Filters for scanned devices, evaluated by the microapp.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <BleMacAddress.h>
+#include <BleScan.h>
+#include <BleUtils.h>
+#include <BleUuid.h>
+#include <microapp.h>
+
+#ifndef MAX_BLE_SCAN_FILTERS
+#define MAX_BLE_SCAN_FILTERS 4
+#endif
+
+// Max number of bytes an advertisement data filter compares, including a company id or service data uuid.
+#ifndef MAX_BLE_SCAN_FILTER_PREFIX_LENGTH
+#define MAX_BLE_SCAN_FILTER_PREFIX_LENGTH 8
+#endif
+
+// What a scan filter compares. Filters are evaluated in this order, cheapest first.
+enum BleScanFilterField {
+	BleScanFilterRssi = 0,
+	BleScanFilterAddress,
+	BleScanFilterAdvertisementData,
+};
+
+/**
+ * A single scan filter.
+ */
+struct ble_scan_filter_t {
+	BleScanFilterField field;
+	//! For advertisement data filters: the GAP advertisement type of the AD structure.
+	uint8_t adType;
+	//! For advertisement data filters: the number of bytes to compare.
+	uint8_t length;
+	union {
+		//! Lowest RSSI that passes.
+		rssi_t minRssi;
+		uint8_t address[MAC_ADDRESS_LENGTH];
+		//! The AD structure data has to start with these bytes.
+		uint8_t prefix[MAX_BLE_SCAN_FILTER_PREFIX_LENGTH];
+	};
+	//! Number of scanned devices that matched this filter.
+	uint16_t hitCount;
+};
+
+/**
+ * Chain of scan filters, evaluated on the raw scan data before a scan is copied or passed to the user.
+ *
+ * Filters that compare the same field (the RSSI, the address, or AD structures of the same type) are combined with a
+ * logical or, filters that compare different fields with a logical and. For example: address A or address B, and an
+ * RSSI of at least -70 dBm.
+ *
+ * This complements the single filter that bluenet can apply (see BLE.scanForName() and the like).
+ */
+class BleScanFilterChain {
+private:
+	ble_scan_filter_t _filters[MAX_BLE_SCAN_FILTERS];
+	uint8_t _filterCount    = 0;
+	uint16_t _rejectedCount = 0;
+
+	microapp_sdk_result_t add(const ble_scan_filter_t& filter);
+
+	static bool sameField(const ble_scan_filter_t& filter, const ble_scan_filter_t& other);
+
+	static bool matches(
+			const ble_scan_filter_t& filter,
+			const uint8_t* address,
+			rssi_t rssi,
+			const uint8_t* scanData,
+			uint8_t scanSize,
+			const BleScanIndex& scanIndex);
+
+public:
+	/**
+	 * Only pass devices with an RSSI of at least minRssi.
+	 *
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS on success
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if there is no space for another filter
+	 */
+	microapp_sdk_result_t addRssiFilter(rssi_t minRssi);
+
+	/**
+	 * Only pass devices with the given MAC address.
+	 *
+	 * @param[in] address  MAC address string of the format "AA:BB:CC:DD:EE:FF".
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS on success
+	 * @return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED if the address is not valid
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if there is no space for another filter
+	 */
+	microapp_sdk_result_t addAddressFilter(const char* address);
+
+	/**
+	 * Only pass devices that advertise an AD structure of the given type, of which the data starts with the given bytes.
+	 *
+	 * @param[in] type          GAP advertisement type of the AD structure.
+	 * @param[in] prefix        Bytes the data has to start with, may be nullptr if prefixLength is 0.
+	 * @param[in] prefixLength  Number of bytes in prefix.
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS on success
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if there is no space for another filter, or the prefix is too long
+	 */
+	microapp_sdk_result_t addAdvertisementDataFilter(GapAdvType type, const uint8_t* prefix, uint8_t prefixLength);
+
+	/**
+	 * Only pass devices that advertise manufacturer specific data of the given company, optionally followed by the
+	 * given bytes.
+	 *
+	 * @see addAdvertisementDataFilter()
+	 */
+	microapp_sdk_result_t addManufacturerDataFilter(
+			uint16_t companyId, const uint8_t* prefix = nullptr, uint8_t prefixLength = 0);
+
+	/**
+	 * Only pass devices that advertise service data of the given 16 bit service uuid, optionally followed by the given
+	 * bytes.
+	 *
+	 * @see addAdvertisementDataFilter()
+	 */
+	microapp_sdk_result_t addServiceDataFilter(uuid16_t uuid, const uint8_t* prefix = nullptr, uint8_t prefixLength = 0);
+
+	/**
+	 * Remove all filters, so that all devices pass.
+	 */
+	void clear();
+
+	/**
+	 * Evaluate the filters on a scanned device, and update the counters.
+	 *
+	 * @return true if the device passes all filters.
+	 */
+	bool passes(const uint8_t* address, rssi_t rssi, const uint8_t* scanData, uint8_t scanSize);
+
+	/**
+	 * Get the number of filters.
+	 */
+	uint8_t filterCount();
+
+	/**
+	 * Get the number of scanned devices that matched a filter.
+	 *
+	 * @param[in] index  Index of the filter, in the order in which the filters were added.
+	 * @return the number of hits, or 0 if there is no such filter.
+	 */
+	uint16_t hitCount(uint8_t index);
+
+	/**
+	 * Get the number of scanned devices that did not pass the filters.
+	 */
+	uint16_t rejectedCount();
+
+	/**
+	 * Reset the hit counts and the rejected count.
+	 */
+	void resetCounters();
+};
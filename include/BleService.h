@@ -88,7 +88,7 @@ public:
 	 *
 	 * @return UUID of the BLE service as a string
 	 */
-	String uuid();
+	UuidString uuid();
 
 	/**
 	 * Add a BleCharacteristic to the BLE service
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <BleUtils.h>
+#include <String.h>
 #include <microapp.h>
 
 // type for 16-bit uuid
@@ -9,11 +10,15 @@ typedef uint16_t uuid16_t;
 const microapp_size_t UUID_16BIT_BYTE_LENGTH = 2;
 // format "ABCD"
 const microapp_size_t UUID_16BIT_STRING_LENGTH = 4;
+// amount of bytes in a 32-bit uuid, which is converted to a 128-bit uuid
+const microapp_size_t UUID_32BIT_BYTE_LENGTH = 4;
 // amount of bytes in a 128-bit uuid
 const microapp_size_t UUID_128BIT_BYTE_LENGTH = 16;
 // format "12345678-ABCD-1234-5678-ABCDEF123456"
 const microapp_size_t UUID_128BIT_STRING_LENGTH = 36;
 
+typedef FixedString<UUID_128BIT_STRING_LENGTH> UuidString;
+
 class Uuid {
 private:
 	friend class Ble;
@@ -118,9 +123,10 @@ public:
 	bool custom();
 	bool valid();
 
-	const char* string();
+	// Returns an empty string if the uuid is not initialized.
+	UuidString string();
 	// return full string, even for 16-bit uuids
-	const char* fullString();
+	UuidString fullString();
 
 	const uint8_t* bytes();
 	const uint8_t* fullBytes();
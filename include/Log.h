@@ -0,0 +1,131 @@
+/*
+ * Log macros.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <Serial.h>
+#include <microapp.h>
+#include <stdint.h>
+
+/**
+ * Log a line at debug, info, warn or error level, for example:
+ *   LOGi("temperature=%.2f count=%u", temperature, count);
+ *
+ * The format is that of Serial.printf(), and must be a string literal. Logs below MICROAPP_LOG_LEVEL are compiled
+ * out, including their arguments.
+ *
+ * When MICROAPP_LOG_INTERNED is defined, the format string is not part of the binary. Instead, a log holds a 16-bit id
+ * of the format string, followed by the arguments in binary. Use `make log-strings` to extract the format strings to
+ * a json file, and scripts/microapp_log_strings.py to decode the logs with it.
+ */
+#if MICROAPP_LOG_LEVEL <= MICROAPP_LOG_DEBUG
+#define LOGd(format, ...) MICROAPP_LOG(format, ##__VA_ARGS__)
+#else
+#define LOGd(format, ...)
+#endif
+
+#if MICROAPP_LOG_LEVEL <= MICROAPP_LOG_INFO
+#define LOGi(format, ...) MICROAPP_LOG(format, ##__VA_ARGS__)
+#else
+#define LOGi(format, ...)
+#endif
+
+#if MICROAPP_LOG_LEVEL <= MICROAPP_LOG_WARN
+#define LOGw(format, ...) MICROAPP_LOG(format, ##__VA_ARGS__)
+#else
+#define LOGw(format, ...)
+#endif
+
+#if MICROAPP_LOG_LEVEL <= MICROAPP_LOG_ERROR
+#define LOGe(format, ...) MICROAPP_LOG(format, ##__VA_ARGS__)
+#else
+#define LOGe(format, ...)
+#endif
+
+#ifdef MICROAPP_LOG_INTERNED
+#define MICROAPP_LOG(format, ...)                                        \
+	do {                                                                 \
+		constexpr uint16_t logStringId = microappLogStringId(format);    \
+		microappLogInterned(logStringId, ##__VA_ARGS__);                 \
+	} while (0)
+#else
+#define MICROAPP_LOG(format, ...) Serial_::getInstance().printf(format "\n", ##__VA_ARGS__)
+#endif
+
+/**
+ * Get the id of a format string: the 32-bit FNV-1a hash, folded to 16 bits.
+ * Has to match scripts/microapp_log_strings.py.
+ */
+constexpr uint16_t microappLogStringId(const char* format) {
+	uint32_t hash = 2166136261u;
+	while (*format != 0) {
+		hash = (hash ^ (uint8_t)*format++) * 16777619u;
+	}
+	return (hash >> 16) ^ (hash & 0xFFFF);
+}
+
+/**
+ * Add an argument of an interned log: integers as 32-bit, floats as 32-bit float, strings as a size byte followed by
+ * the characters. Arguments that do not fit anymore are left out.
+ */
+inline void microappLogPut(uint8_t* buf, uint8_t& size, const void* value, uint8_t valueSize) {
+	if (size + valueSize > MICROAPP_SDK_MAX_ARRAY_SIZE) {
+		size = MICROAPP_SDK_MAX_ARRAY_SIZE;
+		return;
+	}
+	memcpy(buf + size, value, valueSize);
+	size += valueSize;
+}
+
+inline void microappLogArg(uint8_t* buf, uint8_t& size, int value) {
+	int32_t intValue = value;
+	microappLogPut(buf, size, &intValue, sizeof(intValue));
+}
+
+inline void microappLogArg(uint8_t* buf, uint8_t& size, unsigned int value) {
+	uint32_t intValue = value;
+	microappLogPut(buf, size, &intValue, sizeof(intValue));
+}
+
+inline void microappLogArg(uint8_t* buf, uint8_t& size, long value) {
+	int32_t intValue = value;
+	microappLogPut(buf, size, &intValue, sizeof(intValue));
+}
+
+inline void microappLogArg(uint8_t* buf, uint8_t& size, unsigned long value) {
+	uint32_t intValue = value;
+	microappLogPut(buf, size, &intValue, sizeof(intValue));
+}
+
+inline void microappLogArg(uint8_t* buf, uint8_t& size, double value) {
+	float floatValue = value;
+	microappLogPut(buf, size, &floatValue, sizeof(floatValue));
+}
+
+inline void microappLogArg(uint8_t* buf, uint8_t& size, const char* value) {
+	uint8_t length = (value == nullptr) ? 0 : strlen(value);
+	if (size + 1 + length > MICROAPP_SDK_MAX_ARRAY_SIZE) {
+		length = (size + 1 < MICROAPP_SDK_MAX_ARRAY_SIZE) ? MICROAPP_SDK_MAX_ARRAY_SIZE - size - 1 : 0;
+	}
+	microappLogPut(buf, size, &length, sizeof(length));
+	microappLogPut(buf, size, value, length);
+}
+
+/**
+ * Send an interned log: a single array log with the id of the format string, followed by the arguments.
+ */
+template <typename... Args>
+void microappLogInterned(uint16_t id, Args... args) {
+	uint8_t buf[MICROAPP_SDK_MAX_ARRAY_SIZE];
+	uint8_t size = 0;
+	microappLogPut(buf, size, &id, sizeof(id));
+	// Promote the arguments like they would be for printf().
+	(microappLogArg(buf, size, +args), ...);
+	Serial_::getInstance().println(buf, size);
+}
@@ -1,8 +1,22 @@
 #pragma once
 
+#include <RingBuffer.h>
 #include <microapp.h>
 
-#define MESH_MSG_BUFFER_LEN 5
+// Number of incoming mesh messages that are buffered until read. Must be a power of 2.
+#ifndef MESH_MSG_BUFFER_LEN
+#define MESH_MSG_BUFFER_LEN 8
+#endif
+
+// Number of outgoing mesh messages that can be queued until the end of the loop. Must be a power of 2.
+#ifndef MESH_SEND_QUEUE_LEN
+#define MESH_SEND_QUEUE_LEN 4
+#endif
+
+// Max number of queued mesh messages that are sent at the end of each loop, to stay within the request budget of a tick.
+#ifndef MESH_SEND_QUEUE_FLUSH_LIMIT
+#define MESH_SEND_QUEUE_FLUSH_LIMIT 4
+#endif
 
 struct MeshMsgBufferEntry {
 	bool filled = false;
@@ -11,6 +25,13 @@ struct MeshMsgBufferEntry {
 	uint8_t size;
 };
 
+struct MeshSendQueueEntry {
+	uint8_t stoneId;
+	bool doNotRelay;
+	uint8_t data[MAX_MICROAPP_MESH_PAYLOAD_SIZE];
+	uint8_t size;
+};
+
 /**
  * Wrapper class for mesh message
  * This class itself contains only pointers to the actual mesh message data,
@@ -35,6 +56,12 @@ public:
 
 typedef void (*ReceivedMeshMsgHandler)(MeshMsg);
 
+// What to do with an incoming mesh message when the buffer is full
+enum MeshDropPolicy {
+	MeshDropNew = 0,  // default
+	MeshDropOldest,
+};
+
 microapp_sdk_result_t handleMeshInterrupt(void* buf);
 
 /**
@@ -59,10 +86,15 @@ private:
 	void operator=(MeshClass const&);
 
 	/**
-	 * Buffer for storing incoming mesh messages
+	 * FIFO for storing incoming mesh messages
 	 * This is where the actual data is stored (for polling applications)
 	 */
-	MeshMsgBufferEntry _incomingMeshMsgBuffer[MESH_MSG_BUFFER_LEN];
+	RingBuffer<MeshMsgBufferEntry, MESH_MSG_BUFFER_LEN> _incomingMeshMsgBuffer;
+
+	/**
+	 * Whether to drop new or oldest messages when the buffer is full
+	 */
+	MeshDropPolicy _dropPolicy = MeshDropNew;
 
 	/**
 	 * Available mesh message passed to the user
@@ -70,6 +102,11 @@ private:
 	 */
 	MeshMsgBufferEntry _availableMeshMsg;
 
+	/**
+	 * FIFO for outgoing mesh messages, sent at the end of the loop
+	 */
+	RingBuffer<MeshSendQueueEntry, MESH_SEND_QUEUE_LEN> _sendQueue;
+
 	/**
 	 * Handler for registered callbacks for incoming mesh messages
 	 */
@@ -85,6 +122,14 @@ private:
 	 */
 	microapp_sdk_result_t handleIncomingMeshMsg(microapp_sdk_mesh_t* msg);
 
+	/**
+	 * Send a mesh message to bluenet right away.
+	 *
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS on success, or when the message was added to a batch
+	 * @return the error returned by bluenet otherwise
+	 */
+	microapp_sdk_result_t sendMeshMsgNow(const uint8_t* msg, uint8_t msgSize, uint8_t stoneId, bool doNotRelay);
+
 public:
 	static MeshClass& getInstance() {
 		// Guaranteed to be destroyed.
@@ -108,6 +153,17 @@ public:
 	 */
 	void setIncomingMeshMsgHandler(ReceivedMeshMsgHandler handler);
 
+	/**
+	 * Set what to do with an incoming message when the buffer is full: drop it (the default), or drop the oldest
+	 * buffered message.
+	 */
+	void setDropPolicy(MeshDropPolicy policy);
+
+	/**
+	 * Get the number of incoming messages that were dropped because the buffer was full.
+	 */
+	uint16_t droppedCount();
+
 	/**
 	 * Check if a new message is avalable to read with the readMeshMsg function.
 	 *
@@ -117,7 +173,7 @@ public:
 
 	/**
 	 * Read a mesh message
-	 * Pop a message from the incoming mesh message buffer.
+	 * Pop the oldest message from the incoming mesh message buffer.
 	 * Note that the returned pointer is not memory safe.
 	 * It should only be used in local context.
 	 * If the message content needs to be saved, the caller
@@ -130,12 +186,45 @@ public:
 	/**
 	 * Send a mesh message.
 	 *
+	 * When called from an interrupt handler (such as the incoming mesh message handler), the message is queued and
+	 * sent at the end of the loop. When the queue is full, the message is dropped. Otherwise, queued messages are sent
+	 * first.
+	 *
 	 * @param[in] msg         Pointer to the message.
 	 * @param[in] msgSize     Size of the message, currently max 7.
 	 * @param[in] stoneId     ID of the Crownstone to send the message to, or 0 to send it to every Crownstone.
 	 * @param[in] doNotRelay  When set to true, the mesh message will not be relayed, and thus only received by neighbouring nodes.
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS on success, or when the message was added to a batch
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if called from an interrupt handler and the queue is full
+	 * @return the error returned by bluenet otherwise
+	 */
+	microapp_sdk_result_t sendMeshMsg(uint8_t* msg, uint8_t msgSize, uint8_t stoneId = 0, bool doNotRelay = false);
+
+	/**
+	 * Queue a mesh message, to be sent at the end of the loop.
+	 *
+	 * This does not yield to bluenet, so it's cheap to call from interrupt handlers.
+	 *
+	 * @param[in] msg         Pointer to the message.
+	 * @param[in] msgSize     Size of the message, currently max 7.
+	 * @param[in] stoneId     ID of the Crownstone to send the message to, or 0 to send it to every Crownstone.
+	 * @param[in] doNotRelay  When set to true, the mesh message will not be relayed.
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS on success
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if the queue is full
+	 */
+	microapp_sdk_result_t queueMeshMsg(const uint8_t* msg, uint8_t msgSize, uint8_t stoneId = 0, bool doNotRelay = false);
+
+	/**
+	 * Get the number of queued mesh messages that have not been sent yet.
+	 */
+	uint8_t queuedMeshMsgCount();
+
+	/**
+	 * Send queued mesh messages, at most MESH_SEND_QUEUE_FLUSH_LIMIT of them, batched when possible.
+	 *
+	 * Called at the end of each loop.
 	 */
-	void sendMeshMsg(uint8_t* msg, uint8_t msgSize, uint8_t stoneId = 0, bool doNotRelay = false);
+	void flushMeshMsgQueue();
 
 	/**
 	 * Get own stone id
@@ -0,0 +1,156 @@
+/*
+ * Transport layer on top of mesh messages.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <Mesh.h>
+#include <microapp.h>
+
+// Max size of a message sent via the mesh transport. At most 95 bytes (16 fragments).
+#ifndef MESH_TRANSPORT_MAX_MESSAGE_SIZE
+#define MESH_TRANSPORT_MAX_MESSAGE_SIZE 32
+#endif
+
+// Number of fragmented messages that can be reassembled at the same time.
+#ifndef MESH_TRANSPORT_REASSEMBLY_SLOTS
+#define MESH_TRANSPORT_REASSEMBLY_SLOTS 2
+#endif
+
+// Time after which an incomplete fragmented message is dropped.
+#ifndef MESH_TRANSPORT_TIMEOUT_MS
+#define MESH_TRANSPORT_TIMEOUT_MS 5000
+#endif
+
+/**
+ * Every mesh frame of the transport starts with a header byte.
+ *
+ * Frame with records: header 0, followed by records of a size byte and the data.
+ * Fragment: the header has the fragment flag set, a message id and the fragment index. The first fragment is
+ * followed by the size of the whole message, all fragments by a part of the message.
+ */
+const uint8_t MESH_TRANSPORT_FRAGMENT_FLAG    = 0x80;
+const uint8_t MESH_TRANSPORT_MESSAGE_ID_SHIFT = 4;
+const uint8_t MESH_TRANSPORT_MESSAGE_ID_MASK  = 0x07;
+const uint8_t MESH_TRANSPORT_INDEX_MASK       = 0x0F;
+
+// Max size of a record that fits in a frame with records.
+const uint8_t MESH_TRANSPORT_MAX_RECORD_SIZE = MAX_MICROAPP_MESH_PAYLOAD_SIZE - 2;
+// Number of message bytes in the first fragment, and in the other fragments.
+const uint8_t MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE = MAX_MICROAPP_MESH_PAYLOAD_SIZE - 2;
+const uint8_t MESH_TRANSPORT_FRAGMENT_DATA_SIZE       = MAX_MICROAPP_MESH_PAYLOAD_SIZE - 1;
+
+static_assert(
+		MESH_TRANSPORT_MAX_MESSAGE_SIZE
+				<= MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE + MESH_TRANSPORT_INDEX_MASK * MESH_TRANSPORT_FRAGMENT_DATA_SIZE,
+		"MESH_TRANSPORT_MAX_MESSAGE_SIZE does not fit in 16 fragments");
+
+struct MeshReassemblyEntry {
+	bool used = false;
+	uint8_t stoneId;
+	uint8_t messageId;
+	//! Size of the message, 0 until the first fragment is received.
+	uint8_t size;
+	//! Bit i is set when fragment i is received.
+	uint16_t receivedFragments;
+	//! Loop tick count at which the first received fragment arrived.
+	uint32_t startTick;
+	uint8_t data[MESH_TRANSPORT_MAX_MESSAGE_SIZE];
+};
+
+void handleMeshTransportMsg(MeshMsg msg);
+
+/**
+ * Transport layer on top of mesh messages, to send fewer frames, and messages larger than a single frame.
+ *
+ * - Small messages to the same stone are packed together in one frame, which is sent when it is full, when a message
+ *   to another stone is sent, when flush() is called, or at the end of the loop.
+ * - Messages that do not fit in a frame are split into fragments, which the receiver reassembles. Incomplete messages
+ *   are dropped after a timeout.
+ *
+ * Both sender and receiver have to use the transport, and all mesh messages are expected to be sent via the transport.
+ */
+class MeshTransportClass {
+private:
+	friend void handleMeshTransportMsg(MeshMsg);
+
+	MeshTransportClass(){};
+	MeshTransportClass(MeshTransportClass const&);
+	void operator=(MeshTransportClass const&);
+
+	// Frame with records that is being filled
+	uint8_t _pendingFrame[MAX_MICROAPP_MESH_PAYLOAD_SIZE];
+	uint8_t _pendingSize    = 0;
+	uint8_t _pendingStoneId = 0;
+
+	uint8_t _nextMessageId = 0;
+
+	MeshReassemblyEntry _reassembly[MESH_TRANSPORT_REASSEMBLY_SLOTS];
+
+	ReceivedMeshMsgHandler _handler = nullptr;
+
+	uint16_t _sentFrameCount  = 0;
+	uint16_t _droppedMsgCount = 0;
+
+	microapp_sdk_result_t sendFrame(uint8_t* frame, uint8_t size, uint8_t stoneId);
+
+	void handleRecords(MeshMsg& frame);
+
+	void handleFragment(MeshMsg& frame);
+
+	MeshReassemblyEntry* getReassemblyEntry(uint8_t stoneId, uint8_t messageId);
+
+	void expireReassemblyEntries();
+
+	void countDroppedMsg();
+
+public:
+	static MeshTransportClass& getInstance() {
+		static MeshTransportClass instance;
+		return instance;
+	}
+
+	/**
+	 * Start listening to mesh messages, and pass the received messages to the handler.
+	 *
+	 * This sets the incoming message handler of Mesh.
+	 *
+	 * @return true if listening to the mesh succeeded
+	 */
+	bool listen(ReceivedMeshMsgHandler handler);
+
+	/**
+	 * Send a message, packed together with other small messages, or split into fragments.
+	 *
+	 * @param[in] msg      Pointer to the message.
+	 * @param[in] msgSize  Size of the message, at most MESH_TRANSPORT_MAX_MESSAGE_SIZE.
+	 * @param[in] stoneId  ID of the Crownstone to send the message to, or 0 to send it to every Crownstone.
+	 * @return CS_MICROAPP_SDK_ACK_SUCCESS on success
+	 * @return CS_MICROAPP_SDK_ACK_ERR_EMPTY if the message is empty
+	 * @return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE if the message is too large
+	 * @return the error returned by bluenet if one of the fragments could not be sent
+	 */
+	microapp_sdk_result_t send(const uint8_t* msg, uint8_t msgSize, uint8_t stoneId = 0);
+
+	/**
+	 * Send the frame with packed messages, if any. Also called at the end of every loop.
+	 */
+	void flush();
+
+	/**
+	 * Get the number of mesh frames that were sent successfully.
+	 */
+	uint16_t sentFrameCount();
+
+	/**
+	 * Get the number of received messages that were dropped, because they were incomplete or too large.
+	 */
+	uint16_t droppedMsgCount();
+};
+
+#define MeshTransport MeshTransportClass::getInstance()
@@ -12,6 +12,44 @@
 #include <microapp.h>
 #include <stdint.h>
 
+// Number of received bytes that can be buffered until read. Must be a power of 2.
+#ifndef MESSAGE_RECEIVE_BUFFER_SIZE
+#define MESSAGE_RECEIVE_BUFFER_SIZE 128
+#endif
+
+/**
+ * Header of each message of a frame, see MessageClass::beginFrame().
+ *
+ * The data of the message follows the header. The size of the frame is known once the message with the last flag is
+ * received: its offset plus the size of its data.
+ */
+struct __attribute__((packed)) message_frame_header_t {
+	//! Sequence number of the frame, the same for all messages of a frame.
+	uint8_t sequence;
+	//! Bitmask of MESSAGE_FRAME_FLAG_*.
+	uint8_t flags;
+	//! Offset of the data of this message in the frame.
+	uint16_t offset;
+};
+
+//! Set for the first message of a frame.
+const uint8_t MESSAGE_FRAME_FLAG_FIRST = 1 << 0;
+//! Set for the last message of a frame.
+const uint8_t MESSAGE_FRAME_FLAG_LAST  = 1 << 1;
+
+//! Number of frame bytes that fit in a single message.
+const uint8_t MESSAGE_FRAME_CHUNK_MAX_SIZE = MICROAPP_SDK_MESSAGE_SEND_MSG_MAX_SIZE - sizeof(message_frame_header_t);
+
+/**
+ * What to do with a received message that does not fit in the receive buffer.
+ */
+enum MessageAcceptPolicy {
+	//! Drop the whole message, so that only complete messages are buffered.
+	MessageAcceptWhole,
+	//! Buffer the part of the message that fits, and drop the rest.
+	MessageAcceptPartial,
+};
+
 /**
  * Handle an incoming data message.
  */
@@ -47,6 +85,43 @@ public:
 	 */
 	microapp_size_t write(void* data, microapp_size_t size);
 
+	/**
+	 * Start sending a frame: data that can be larger than a single message.
+	 *
+	 * The data written with writeChunk() is split in messages of MESSAGE_FRAME_CHUNK_MAX_SIZE bytes, each with a
+	 * message_frame_header_t. A message is only sent once it is full, or by endFrame(), so a frame of N bytes takes
+	 * N / MESSAGE_FRAME_CHUNK_MAX_SIZE (rounded up) yields, regardless of the number of writeChunk() calls.
+	 * See scripts/MessageFrameReassembler.py for the receiving side.
+	 *
+	 * @return  False if a frame has already been started.
+	 */
+	bool beginFrame();
+
+	/**
+	 * Add data to the frame.
+	 *
+	 * @param[in] data       Data to write.
+	 * @param[in] size       Size of the data in bytes.
+	 *
+	 * @return  Actual number of bytes that have been written, less than size when the frame is too large or sending
+	 *          failed.
+	 */
+	microapp_size_t writeChunk(const void* data, microapp_size_t size);
+
+	/**
+	 * Send the rest of the frame.
+	 *
+	 * @return  True if all messages of the frame have been sent.
+	 */
+	bool endFrame();
+
+	/**
+	 * Send data as a single frame, see beginFrame().
+	 *
+	 * @return  True if all messages of the frame have been sent.
+	 */
+	bool writeFrame(const void* data, microapp_size_t size);
+
 	/**
 	 * Returns number of bytes available to read.
 	 */
@@ -63,6 +138,42 @@ public:
 	 */
 	microapp_size_t readBytes(void* data, microapp_size_t size);
 
+	/**
+	 * Read bytes, until a terminator byte.
+	 * The terminator is removed from the buffer, but not copied to the data.
+	 *
+	 * @param[in] terminator Byte to stop at.
+	 * @param[in] data       Buffer to read to.
+	 * @param[in] size       Max number of bytes to read, the buffer must be at least of this size.
+	 *
+	 * @return  Actual number of bytes read, excluding the terminator.
+	 */
+	microapp_size_t readBytesUntil(char terminator, void* data, microapp_size_t size);
+
+	/**
+	 * Read a single byte.
+	 *
+	 * @return  The byte, or -1 if no bytes are available.
+	 */
+	int read();
+
+	/**
+	 * Get the next byte, without removing it from the buffer.
+	 *
+	 * @return  The byte, or -1 if no bytes are available.
+	 */
+	int peek();
+
+	/**
+	 * Set what to do with a received message that does not fit in the buffer, MessageAcceptWhole by default.
+	 */
+	void setAcceptPolicy(MessageAcceptPolicy policy);
+
+	/**
+	 * Get the number of received bytes that did not fit in the buffer.
+	 */
+	uint16_t droppedByteCount();
+
 	/**
 	 * Set a message handler.
 	 *
@@ -78,11 +189,35 @@ private:
 	//! Whether the interrupt handler has been registered.
 	bool _registeredInterrupt = false;
 
-	//! Buffer for received messages.
-	uint8_t _receiveBuffer[MICROAPP_SDK_MESSAGE_RECEIVED_MSG_MAX_SIZE];
+	static_assert((MESSAGE_RECEIVE_BUFFER_SIZE & (MESSAGE_RECEIVE_BUFFER_SIZE - 1)) == 0, "MESSAGE_RECEIVE_BUFFER_SIZE must be a power of 2");
+
+	//! Circular buffer for received messages.
+	uint8_t _receiveBuffer[MESSAGE_RECEIVE_BUFFER_SIZE];
+
+	//! Free running indices of the buffer: the interrupt handler only modifies the head, reading only modifies the tail.
+	volatile microapp_size_t _head = 0;
+	volatile microapp_size_t _tail = 0;
+
+	MessageAcceptPolicy _acceptPolicy = MessageAcceptWhole;
+
+	//! Number of received bytes that did not fit.
+	uint16_t _droppedByteCount = 0;
+
+	//! Data of the frame that has not been sent yet.
+	uint8_t _frameChunk[MESSAGE_FRAME_CHUNK_MAX_SIZE];
+	uint8_t _frameChunkSize = 0;
+
+	//! Offset of the data in _frameChunk, in the frame.
+	uint16_t _frameOffset = 0;
+
+	uint8_t _frameSequence = 0;
+
+	//! Whether a frame has been started, and whether all messages of it have been sent so far.
+	bool _frameStarted = false;
+	bool _frameSuccess = false;
 
-	//! Keeps up number of bytes available to read.
-	microapp_size_t _available = 0;
+	//! Send the data in _frameChunk.
+	bool sendFrameChunk(bool last);
 
 	//! The message handler.
 	MessageHandler _handler = nullptr;
@@ -0,0 +1,62 @@
+/*
+ * Number formatting.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Conversion of numbers to text, without the C library.
+ *
+ * Each function writes the text and a null terminator to buf, which must be at least MAX_NUMBER_STRING_LENGTH + 1
+ * bytes, and returns the length of the text.
+ */
+
+// Max length of the text of a number, excluding the null terminator: a 32-bit value in base 2.
+const uint8_t MAX_NUMBER_STRING_LENGTH = 32;
+
+// Max number of decimals of formatFloat().
+const uint8_t MAX_FLOAT_PRECISION = 9;
+
+/**
+ * Format a signed integer in base 10.
+ */
+uint8_t formatInt(char* buf, int32_t value);
+
+/**
+ * Format an unsigned integer.
+ *
+ * @param[in] base       Base, from 2 to 16.
+ * @param[in] upperCase  Whether to use upper case letters for digits above 9.
+ */
+uint8_t formatUnsigned(char* buf, uint32_t value, uint8_t base = 10, bool upperCase = false);
+
+/**
+ * Format an unsigned integer in base 16, padded with zeros to a minimal number of digits.
+ */
+uint8_t formatHex(char* buf, uint32_t value, uint8_t minDigits = 0, bool upperCase = true);
+
+/**
+ * Format a value in fixed point notation, with a given number of decimals, rounded half away from zero.
+ *
+ * Values of which the integer part does not fit in 32 bits are written as "ovf", like Arduino does. Infinity and not a
+ * number are written as "inf" and "nan".
+ *
+ * @param[in] precision  Number of decimals, at most MAX_FLOAT_PRECISION.
+ */
+uint8_t formatFloat(char* buf, float value, uint8_t precision);
+uint8_t formatFloat(char* buf, double value, uint8_t precision);
+
+/**
+ * Format a float with the fewest significant digits that read back as the same float.
+ *
+ * Fixed point notation is used for exponents from -5 up to 8, scientific notation otherwise, for example "0.1",
+ * "1234.5" and "1.5e-07".
+ */
+uint8_t formatFloatShortest(char* buf, float value);
@@ -0,0 +1,156 @@
+/*
+ * Ring buffer.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * Fixed capacity FIFO, with a single producer and a single consumer.
+ *
+ * The producer (typically an interrupt handler) only modifies the head, the consumer (typically the loop) only
+ * modifies the tail. This means no locking is needed when one side interrupts the other.
+ *
+ * Items can be written and read in place with reserve() / commit() and front() / release(), to avoid copying them.
+ *
+ * @tparam T         Type of the items.
+ * @tparam Capacity  Max number of items, must be a power of 2 and at most 128.
+ */
+template <typename T, uint8_t Capacity>
+class RingBuffer {
+	static_assert(Capacity > 0 && Capacity <= 128, "Capacity must be between 1 and 128");
+	static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of 2");
+
+private:
+	T _items[Capacity];
+
+	// Free running indices: the number of items is the difference, also when they wrap around.
+	volatile uint8_t _head = 0;
+	volatile uint8_t _tail = 0;
+
+	//! Number of items that did not fit.
+	uint16_t _overflowCount = 0;
+
+	//! Max number of items that have been in the buffer at the same time.
+	uint8_t _maxCount = 0;
+
+public:
+	/**
+	 * Get a pointer to the next item to write, without adding it yet.
+	 *
+	 * @return Pointer to the item, or nullptr when the buffer is full (the overflow count is then increased).
+	 */
+	T* reserve() {
+		if (full()) {
+			if (_overflowCount < UINT16_MAX) {
+				_overflowCount++;
+			}
+			return nullptr;
+		}
+		return &_items[_head & (Capacity - 1)];
+	}
+
+	/**
+	 * Get a pointer to the next item to write, without adding it yet. When the buffer is full, the oldest item is
+	 * removed to make space, and the overflow count is increased.
+	 *
+	 * Since the producer then modifies the tail, this should only be used when the consumer can not be interrupted
+	 * while it uses an item.
+	 *
+	 * @return Pointer to the item.
+	 */
+	T* reserveOverwrite() {
+		if (full()) {
+			if (_overflowCount < UINT16_MAX) {
+				_overflowCount++;
+			}
+			_tail = _tail + 1;
+		}
+		return &_items[_head & (Capacity - 1)];
+	}
+
+	/**
+	 * Add the item that was obtained with reserve().
+	 */
+	void commit() {
+		_head = _head + 1;
+		if (size() > _maxCount) {
+			_maxCount = size();
+		}
+	}
+
+	/**
+	 * Add a copy of an item.
+	 *
+	 * @return true when the item was added, false when the buffer is full.
+	 */
+	bool push(const T& item) {
+		T* slot = reserve();
+		if (slot == nullptr) {
+			return false;
+		}
+		*slot = item;
+		commit();
+		return true;
+	}
+
+	/**
+	 * Get a pointer to the oldest item, without removing it.
+	 *
+	 * @return Pointer to the item, or nullptr when the buffer is empty.
+	 */
+	T* front() {
+		if (empty()) {
+			return nullptr;
+		}
+		return &_items[_tail & (Capacity - 1)];
+	}
+
+	/**
+	 * Remove the oldest item.
+	 */
+	void release() {
+		if (!empty()) {
+			_tail = _tail + 1;
+		}
+	}
+
+	/**
+	 * Copy and remove the oldest item.
+	 *
+	 * @return true when an item was copied, false when the buffer is empty.
+	 */
+	bool pop(T& item) {
+		T* oldest = front();
+		if (oldest == nullptr) {
+			return false;
+		}
+		item = *oldest;
+		release();
+		return true;
+	}
+
+	/**
+	 * Remove all items. Should only be called by the consumer.
+	 */
+	void clear() { _tail = _head; }
+
+	uint8_t size() const { return (uint8_t)(_head - _tail); }
+	bool empty() const { return _head == _tail; }
+	bool full() const { return size() == Capacity; }
+	constexpr uint8_t capacity() const { return Capacity; }
+
+	uint16_t overflowCount() const { return _overflowCount; }
+	uint8_t maxCount() const { return _maxCount; }
+
+	void resetStatistics() {
+		_overflowCount = 0;
+		_maxCount      = size();
+	}
+};
@@ -2,8 +2,22 @@
 
 #include <String.h>
 #include <cs_MicroappStructs.h>
+#include <stdarg.h>
 #include <stdint.h>
 
+// Log levels, ordered like the serial verbosity of bluenet. Only logs of at least MICROAPP_LOG_LEVEL are compiled in.
+#define MICROAPP_LOG_DEBUG 2
+#define MICROAPP_LOG_INFO 3
+#define MICROAPP_LOG_WARN 4
+#define MICROAPP_LOG_ERROR 5
+#define MICROAPP_LOG_NONE 6
+
+// The level of the logs that are compiled in, for example -DMICROAPP_LOG_LEVEL=MICROAPP_LOG_WARN.
+// Calls to Serial are at info level: above that level, they are compiled out.
+#ifndef MICROAPP_LOG_LEVEL
+#define MICROAPP_LOG_LEVEL MICROAPP_LOG_DEBUG
+#endif
+
 class Serial_ {
 private:
 	Serial_(){};
@@ -22,7 +36,7 @@ private:
 	};
 
 	microapp_size_t _write(microapp_sdk_log_header_t* logRequest, Type type, MicroappSdkLogFlags flags);
-	microapp_size_t _write(String str, MicroappSdkLogFlags flags = CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
+	microapp_size_t _write(StringView str, MicroappSdkLogFlags flags = CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
 	microapp_size_t _write(const char* str, MicroappSdkLogFlags flags = CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
 	microapp_size_t _write(const uint8_t* buf, int length, MicroappSdkLogFlags flags = CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
 	microapp_size_t _write(char value, MicroappSdkLogFlags flags = CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
@@ -32,6 +46,21 @@ private:
 	microapp_size_t _write(int value, MicroappSdkLogFlags flags = CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
 	microapp_size_t _write(unsigned int value, MicroappSdkLogFlags flags = CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
 
+	// Line buffer: text that has not been sent yet.
+	char _line[MAX_STRING_SIZE + 1];
+	microapp_size_t _lineSize = 0;
+	bool _lineBuffered        = false;
+
+	// Add text to the line buffer, a newline or a full buffer sends the line.
+	microapp_size_t _append(const char* str, microapp_size_t length);
+	microapp_size_t _append(char value);
+	// Add text to the line buffer, padded to the given width.
+	microapp_size_t _appendPadded(const char* str, microapp_size_t length, uint8_t width, char pad, bool leftAlign);
+	// Add formatted text to the line buffer.
+	microapp_size_t _appendFormatted(const char* format, va_list args);
+	// Send the line buffer as a single log.
+	void _sendLine(MicroappSdkLogFlags flags);
+
 public:
 	static Serial_& getInstance() {
 		// Guaranteed to be destroyed.
@@ -56,6 +85,7 @@ public:
 	// Returns number of bytes written.
 	microapp_size_t write(char value);
 
+	// Floats are written as text, with 2 decimals.
 	microapp_size_t write(float value);
 
 	microapp_size_t write(double value);
@@ -76,7 +106,7 @@ public:
 	// Crownstones it is almost useless. It would be fun to write over Bluetooth RFCOMM.
 	//
 	// Returns number of bytes written.
-	microapp_size_t write(String str);
+	microapp_size_t write(StringView str);
 
 	// Write an array of bytes to serial.
 	// Returns number of bytes written.
@@ -98,7 +128,7 @@ public:
 
 	microapp_size_t print(const char* str);
 
-	microapp_size_t print(String str);
+	microapp_size_t print(StringView str);
 
 	microapp_size_t print(const uint8_t* buf, int length);
 
@@ -118,9 +148,54 @@ public:
 
 	microapp_size_t println(const char* str);
 
-	microapp_size_t println(String str);
+	microapp_size_t println(StringView str);
 
 	microapp_size_t println(const uint8_t* buf, int length);
+
+	// Write formatted text, see printf() of the C library.
+	// Supported are: %d %i %u %x %X %c %s %f %g %%, with flags '-' and '0', a width, a precision for %f (default 6),
+	// and the length modifiers 'l' and 'h'. %g prints the shortest text that reads back as the same float.
+	// Text is sent in logs of at most MAX_STRING_SIZE characters, a newline character ends a log.
+	// Returns number of characters written.
+	microapp_size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+
+	// When line buffered, print(), write() and printf() add text to a buffer instead of sending it right away.
+	// The line is sent as a single log at a newline (including println()), when the buffer is full, or by flush().
+	// Integers are then printed as text by the microapp as well.
+	// The buffer is flushed at the end of setup and of every loop.
+	void setLineBuffered(bool lineBuffered);
+
+	// Send the text in the line buffer.
+	void flush();
 };
 
+#if MICROAPP_LOG_LEVEL <= MICROAPP_LOG_INFO
 #define Serial Serial_::getInstance()
+#else
+/**
+ * Stand-in for Serial_ when the log level is above info: every call does nothing, so that the calls and their
+ * strings are optimized out.
+ */
+class SerialDisabled_ {
+public:
+	void begin() {}
+	explicit operator bool() const { return false; }
+	template <typename... Args>
+	microapp_size_t write(Args...) {
+		return 0;
+	}
+	template <typename... Args>
+	microapp_size_t print(Args...) {
+		return 0;
+	}
+	template <typename... Args>
+	microapp_size_t println(Args...) {
+		return 0;
+	}
+	microapp_size_t printf(const char*, ...) { return 0; }
+	void setLineBuffered(bool) {}
+	void flush() {}
+};
+
+#define Serial SerialDisabled_()
+#endif
@@ -29,11 +29,20 @@ public:
 
 	/**
 	 * Public functions for writing service data
-	 * Supported are string literals, String objects and byte arrays
+	 * Supported are string literals, strings and byte arrays
 	 */
 	void write(uint16_t appUuid, const char* str);
-	void write(uint16_t appUuid, String str);
+	void write(uint16_t appUuid, StringView str);
 	void write(uint16_t appUuid, uint8_t* buf, microapp_size_t size);
+
+	/**
+	 * Write a number as text, floats with a given number of decimals.
+	 */
+	void write(uint16_t appUuid, int value);
+	void write(uint16_t appUuid, unsigned int value);
+	void write(uint16_t appUuid, long value);
+	void write(uint16_t appUuid, unsigned long value);
+	void write(uint16_t appUuid, double value, uint8_t decimals = 2);
 };
 
 #define ServiceData ServiceData_::getInstance()
\ No newline at end of file
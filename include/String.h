@@ -1,27 +1,208 @@
 #pragma once
 
+#include <NumberFormat.h>
 #include <microapp.h>
 
-class String {
+// Capacity of String: the max number of characters, excluding the null terminator.
+#ifndef STRING_CAPACITY
+#define STRING_CAPACITY 64
+#endif
 
-	char* _str;         // actual buffer
-	unsigned int _len;  // length of string
+/**
+ * Read only reference to characters, which keeps the length, so that it doesn't have to be counted again.
+ *
+ * The view does not own the characters, they should stay valid while the view is used. The characters do not have to
+ * be null terminated.
+ */
+class StringView {
+private:
+	const char* _str        = "";
+	microapp_size_t _length = 0;
 
 public:
-	String(const char* str) {
-		_len = strlen(str);
-		_str = (char*)str;
+	StringView() {}
+
+	/**
+	 * View a null terminated string. A null pointer results in an empty view.
+	 */
+	StringView(const char* str);
+
+	StringView(const char* str, microapp_size_t length) : _str(str), _length(length) {}
+
+	const char* data() const { return _str; }
+
+	microapp_size_t length() const { return _length; }
+
+	bool isEmpty() const { return _length == 0; }
+
+	/**
+	 * Get the character at an index, or 0 when the index is out of range.
+	 */
+	char charAt(microapp_size_t index) const { return (index < _length) ? _str[index] : 0; }
+
+	char operator[](microapp_size_t index) const { return charAt(index); }
+
+	/**
+	 * Compare with another string, character by character.
+	 *
+	 * @return Negative when this string comes before the other, 0 when they are equal, positive otherwise.
+	 */
+	int compareTo(StringView other) const;
+
+	bool equals(StringView other) const;
+
+	bool operator==(StringView other) const { return equals(other); }
+
+	bool operator!=(StringView other) const { return !equals(other); }
+
+	bool startsWith(StringView prefix) const;
+
+	bool endsWith(StringView suffix) const;
+
+	/**
+	 * Find the first occurrence of a character or string, starting at an index.
+	 *
+	 * @return The index, or -1 when not found.
+	 */
+	int indexOf(char c, microapp_size_t from = 0) const;
+
+	int indexOf(StringView str, microapp_size_t from = 0) const;
+
+	/**
+	 * Find the last occurrence of a character.
+	 *
+	 * @return The index, or -1 when not found.
+	 */
+	int lastIndexOf(char c) const;
+
+	/**
+	 * Get a view of the characters from an index, up to but not including another index.
+	 */
+	StringView substring(microapp_size_t from, microapp_size_t to = UINT16_MAX) const;
+};
+
+/**
+ * Append characters to a null terminated string in a buffer of capacity + 1 bytes, as far as they fit.
+ *
+ * @param[in,out] length  Length of the string, updated to the new length.
+ * @return false when not all characters fit.
+ */
+bool appendToString(char* str, microapp_size_t& length, microapp_size_t capacity, StringView value);
+
+/**
+ * String with a buffer of a fixed capacity, so that it can live on the stack or in a class, without heap.
+ *
+ * The string is always null terminated, and keeps its length. Text that does not fit is cut off.
+ * Converts to a StringView, which is what most functions that take a string accept.
+ *
+ * @tparam Capacity  Max number of characters, excluding the null terminator.
+ */
+template <microapp_size_t Capacity>
+class FixedString {
+private:
+	char _str[Capacity + 1];
+	microapp_size_t _length = 0;
+
+public:
+	FixedString() { _str[0] = 0; }
+
+	FixedString(StringView str) : FixedString() { concat(str); }
+
+	FixedString(const char* str) : FixedString(StringView(str)) {}
+
+	FixedString(const char* str, microapp_size_t length) : FixedString(StringView(str, length)) {}
+
+	template <microapp_size_t OtherCapacity>
+	FixedString(const FixedString<OtherCapacity>& other) : FixedString(other.view()) {}
+
+	const char* c_str() const { return _str; }
+
+	microapp_size_t length() const { return _length; }
+
+	constexpr microapp_size_t capacity() const { return Capacity; }
+
+	bool isEmpty() const { return _length == 0; }
+
+	StringView view() const { return StringView(_str, _length); }
+
+	operator StringView() const { return view(); }
+
+	void clear() {
+		_length = 0;
+		_str[0] = 0;
 	}
 
-	// Make sure that the buffer containing str is of at least length len+1
-	// to save space for the 0 termination character
-	String(char* str, unsigned int len) {
-		_len      = len;
-		_str      = str;
-		_str[len] = 0;
+	/**
+	 * Append text, a character, or a number as text. Floats are written with a given number of decimals.
+	 *
+	 * @return false when the result did not fit, and was cut off.
+	 */
+	bool concat(StringView str) { return appendToString(_str, _length, Capacity, str); }
+
+	bool concat(char c) { return concat(StringView(&c, 1)); }
+
+	bool concat(int value) { return concat((long)value); }
+
+	bool concat(unsigned int value) { return concat((unsigned long)value); }
+
+	bool concat(long value) {
+		char buf[MAX_NUMBER_STRING_LENGTH + 1];
+		return concat(StringView(buf, formatInt(buf, value)));
 	}
 
-	const char* c_str() { return _str; }
+	bool concat(unsigned long value) {
+		char buf[MAX_NUMBER_STRING_LENGTH + 1];
+		return concat(StringView(buf, formatUnsigned(buf, value)));
+	}
+
+	bool concat(double value, uint8_t decimals = 2) {
+		char buf[MAX_NUMBER_STRING_LENGTH + 1];
+		return concat(StringView(buf, formatFloat(buf, value, decimals)));
+	}
+
+	template <typename T>
+	FixedString& operator+=(const T& value) {
+		concat(value);
+		return *this;
+	}
+
+	template <typename T>
+	FixedString operator+(const T& value) const {
+		FixedString result(*this);
+		result.concat(value);
+		return result;
+	}
 
-	unsigned int length() { return _len; }
+	// See StringView. A substring is a view of the characters of this string.
+
+	char charAt(microapp_size_t index) const { return view().charAt(index); }
+
+	char operator[](microapp_size_t index) const { return view().charAt(index); }
+
+	int compareTo(StringView other) const { return view().compareTo(other); }
+
+	bool equals(StringView other) const { return view().equals(other); }
+
+	bool operator==(StringView other) const { return view().equals(other); }
+
+	bool operator!=(StringView other) const { return !view().equals(other); }
+
+	bool startsWith(StringView prefix) const { return view().startsWith(prefix); }
+
+	bool endsWith(StringView suffix) const { return view().endsWith(suffix); }
+
+	int indexOf(char c, microapp_size_t from = 0) const { return view().indexOf(c, from); }
+
+	int indexOf(StringView str, microapp_size_t from = 0) const { return view().indexOf(str, from); }
+
+	int lastIndexOf(char c) const { return view().lastIndexOf(c); }
+
+	StringView substring(microapp_size_t from, microapp_size_t to = UINT16_MAX) const {
+		return view().substring(from, to);
+	}
 };
+
+/**
+ * The Arduino string. Unlike on Arduino, it has a fixed capacity: STRING_CAPACITY.
+ */
+typedef FixedString<STRING_CAPACITY> String;
@@ -0,0 +1,163 @@
+/*
+ * Task.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <microapp.h>
+#include <stdint.h>
+
+#ifdef MICROAPP_HOST_BUILD
+#include <ucontext.h>
+#endif
+
+// Max number of tasks that can run at the same time, besides setup() and loop().
+#ifndef TASK_MAX_COUNT
+#define TASK_MAX_COUNT 2
+#endif
+
+// Size of the stack of each task, in bytes. The stacks are only reserved when Tasks.start() is used.
+#ifndef TASK_STACK_SIZE
+#ifdef MICROAPP_HOST_BUILD
+// The host uses 64 bit words, and does not optimize for size.
+#define TASK_STACK_SIZE 16384
+#else
+#define TASK_STACK_SIZE 512
+#endif
+#endif
+
+typedef void (*TaskFunction)(void);
+
+// Returned instead of a task id when the task could not be started.
+const int8_t TASK_ID_NONE = -1;
+
+// Id of setup(), loop() and interrupt handlers, which run on the main stack.
+const int8_t TASK_ID_MAIN = -2;
+
+/**
+ * Cooperative tasks, each with a stack of its own.
+ *
+ * A task runs until it waits: in delay(), or in a function that waits for bluenet, like BleDevice::connect(). Then
+ * another task that is ready continues. The microapp only yields to bluenet when every task waits: while loop() waits
+ * in delay(), and at the end of each loop. So one task can, for example, poll a sensor while another waits for a BLE
+ * read.
+ *
+ * Tasks run when loop() (or setup()) waits, not from interrupt handlers. A task finishes when its function returns.
+ *
+ * Requests to bluenet, and the interrupt handlers that bluenet calls meanwhile, run on the main stack, so the stack
+ * of a task only has to fit the calls of the task itself. When a task overflows its stack, it's stopped.
+ */
+class TaskClass {
+public:
+	static TaskClass& getInstance() {
+		// Guaranteed to be destroyed.
+		static TaskClass instance;
+
+		// Instantiated on first use.
+		return instance;
+	}
+
+	/**
+	 * Start a task. It first runs when the caller waits.
+	 *
+	 * @return The id of the task, or TASK_ID_NONE when TASK_MAX_COUNT tasks are running already.
+	 */
+	int8_t start(TaskFunction function);
+
+	/**
+	 * Check if a task has not finished yet.
+	 */
+	bool isRunning(int8_t id);
+
+	/**
+	 * Get the id of the task that is running, or TASK_ID_MAIN outside of tasks.
+	 */
+	int8_t current() { return _current; }
+
+	/**
+	 * Whether the code runs in a task, rather than on the main stack.
+	 */
+	bool inTask() { return _current != TASK_ID_MAIN; }
+
+	/**
+	 * Give each task that is ready a turn, until it waits again. Does nothing when called from a task, or from an
+	 * interrupt handler. Called by delay(), and at the end of each loop.
+	 */
+	void run();
+
+	/**
+	 * Let the task wait until a time in ms (see millis()), and let the other tasks and the loop continue.
+	 * Called by delay() in a task.
+	 */
+	void sleepUntil(uint32_t wakeMs);
+
+	/**
+	 * Call a function on the main stack, from a task. Used for requests to bluenet.
+	 *
+	 * Weak, so that code that sends requests links without Task.cpp: it's only called when inTask().
+	 */
+	void runOnMainStack(void (*function)(void*), void* arg) __attribute__((weak));
+
+private:
+	TaskClass() {}
+	TaskClass(TaskClass const&);
+	void operator=(TaskClass const&);
+
+	enum TaskState : uint8_t {
+		TASK_FREE = 0,
+		TASK_READY,
+		TASK_SLEEPING,
+		TASK_CALLING_MAIN,
+	};
+
+#ifdef MICROAPP_HOST_BUILD
+	typedef ucontext_t TaskContext;
+#else
+	// The stack pointer, the registers are saved on the stack.
+	typedef void* TaskContext;
+#endif
+
+	struct TaskControlBlock {
+		TaskState state = TASK_FREE;
+		TaskFunction function;
+		TaskContext context;
+		// Lowest address of the stack.
+		uint32_t* stack;
+		// Time in ms at which a sleeping task wakes up.
+		uint32_t wakeMs;
+		// Function to call on the main stack.
+		void (*mainFunction)(void*);
+		void* mainArg;
+	};
+
+	TaskControlBlock _tasks[TASK_MAX_COUNT];
+
+	TaskContext _mainContext;
+
+	int8_t _current = TASK_ID_MAIN;
+
+	// Whether run() is running, so that it's not entered again.
+	bool _running = false;
+
+	/**
+	 * Continue a task, from the main stack, until it waits or finishes.
+	 */
+	void resume(int8_t id);
+
+	/**
+	 * Continue the main stack, from a task.
+	 */
+	void suspend();
+
+	/**
+	 * Entry point of every task.
+	 */
+	static void entry();
+};
+
+#define Tasks TaskClass::getInstance()
@@ -0,0 +1,107 @@
+/*
+ * Timer.
+ *
+ * Author: Crownstone Team
+ * Copyright: Crownstone (https://crownstone.rocks)
+ * Date: Oct 18, 2026
+ * License: LGPLv3+, Apache License 2.0, and/or MIT (triple-licensed)
+ */
+
+#pragma once
+
+#include <microapp.h>
+#include <stdint.h>
+
+// Max number of timers that can be scheduled at the same time.
+#ifndef TIMER_MAX_COUNT
+#define TIMER_MAX_COUNT 8
+#endif
+
+typedef void (*TimerCallback)(void);
+
+// Returned instead of a timer id when the timer could not be scheduled.
+const int8_t TIMER_ID_NONE = -1;
+
+/**
+ * Runs callbacks after some time, once or periodically, so that several periodic tasks can share one loop.
+ *
+ * Time is counted in loop ticks (see getLoopTickCount()), so a timer has a resolution of MICROAPP_LOOP_INTERVAL_MS,
+ * and a time is rounded up to a whole number of ticks, of at least 1.
+ *
+ * The callbacks are called at the end of each loop, in the order of their deadline, and timers with the same deadline
+ * in the order they were scheduled. So a loop() that takes several ticks, for example because it calls delay(), also
+ * delays the timers.
+ */
+class TimerClass {
+public:
+	static TimerClass& getInstance() {
+		// Guaranteed to be destroyed.
+		static TimerClass instance;
+
+		// Instantiated on first use.
+		return instance;
+	}
+
+	/**
+	 * Call a callback every interval, starting one interval from now.
+	 *
+	 * When the callback is late, the next call is one interval after the late call, rather than a catch up.
+	 *
+	 * @return The id of the timer, or TIMER_ID_NONE when TIMER_MAX_COUNT timers are scheduled already.
+	 */
+	int8_t every(uint32_t intervalMs, TimerCallback callback);
+
+	/**
+	 * Call a callback once, after a delay.
+	 *
+	 * @return The id of the timer, or TIMER_ID_NONE when TIMER_MAX_COUNT timers are scheduled already.
+	 */
+	int8_t after(uint32_t delayMs, TimerCallback callback);
+
+	/**
+	 * Stop a timer. Can be called from its own callback.
+	 *
+	 * @return false when there is no timer with this id.
+	 */
+	bool cancel(int8_t id);
+
+	/**
+	 * Check if a timer is still scheduled: a timer made with after() is no longer scheduled once it's called.
+	 */
+	bool isScheduled(int8_t id);
+
+	/**
+	 * Call the callbacks of the timers that are due. Called at the end of each loop.
+	 */
+	void run();
+
+private:
+	TimerClass() {}
+	TimerClass(TimerClass const&);
+	void operator=(TimerClass const&);
+
+	struct TimerEntry {
+		// Null when the entry is free.
+		TimerCallback callback = nullptr;
+		// Loop tick at which the callback is due.
+		uint32_t deadline;
+		// Interval in loop ticks, or 0 for a timer that runs once.
+		uint32_t period;
+		// Value of _scheduleCount when scheduled, to order timers with the same deadline.
+		uint16_t sequence;
+	};
+
+	TimerEntry _timers[TIMER_MAX_COUNT];
+
+	uint16_t _scheduleCount = 0;
+
+	int8_t schedule(uint32_t delayMs, bool periodic, TimerCallback callback);
+
+	/**
+	 * Get the id of the timer that is due with the earliest deadline, or TIMER_ID_NONE when no timer is due. Of timers
+	 * with the same deadline, the one that was scheduled first.
+	 */
+	int8_t nextDueTimer(uint32_t now);
+};
+
+#define Timer TimerClass::getInstance()
@@ -7,6 +7,9 @@
 #define WIRE_MAX_PAYLOAD_LENGTH MICROAPP_SDK_MAX_TWI_PAYLOAD_SIZE
 #define WIRE_MAX_STRING_LENGTH (MICROAPP_SDK_MAX_TWI_PAYLOAD_SIZE - 1)
 
+// Max number of bytes written plus read that fit in a single yield: a write and a read request in a batch.
+#define WIRE_MAX_TRANSFER_LENGTH (MICROAPP_SDK_BATCH_MAX_DATA_SIZE - 2 * (sizeof(microapp_sdk_twi_header_t) + 1))
+
 class WireBase_ {
 private:
 	// TODO: can be removed
@@ -24,6 +27,29 @@ private:
 	// Current pointer
 	int8_t _readPtr;
 
+	// Bytes written since beginTransmission(), sent by endTransmission()
+	uint8_t _writeBuf[WIRE_MAX_PAYLOAD_LENGTH];
+
+	// How much data is written
+	uint8_t _writeLen = 0;
+
+	// Whether write() is called between beginTransmission() and endTransmission()
+	bool _transmitting = false;
+
+	// Whether the written bytes are kept to be sent together with the next requestFrom()
+	bool _writePending = false;
+
+	// Whether more bytes were written than fit in a transmission
+	bool _writeOverflow = false;
+
+	// Send a write request. The boolean stop indicates if the bus needs to be released
+	microapp_sdk_result_t _sendWrite(uint8_t address, const uint8_t* buf, int length, bool stop);
+
+	// Write bytes, when there are any, followed by a read with a repeated start, and copy the result to the read
+	// buffer. The write and read are sent in a single yield when they fit in a batch.
+	// Returns number of bytes read.
+	int _transfer(uint8_t address, const uint8_t* writeBuf, int writeLen, int readLen, bool stop);
+
 protected:
 	WireBase_(char port) : _port(port) {}
 
@@ -50,14 +76,35 @@ public:
 
 	// Start a transmission
 	// The address is the address of the device you will send to.
+	// The bytes written until endTransmission() are buffered, and sent as a single TWI write.
 	void beginTransmission(const uint8_t address);
 
-	// Stop a transmission
-	void endTransmission();
+	// End a transmission: send the bytes written since beginTransmission().
+	// When stop is false, the bytes are sent together with the next requestFrom() to the same address, with a repeated
+	// start instead of a stop in between, in a single yield.
+	// Several transmissions between beginBatch() and commitBatch() are sent in a single yield.
+	// Returns 0 on success, 1 when more bytes were written than WIRE_MAX_PAYLOAD_LENGTH (nothing is sent then), and
+	// 4 on other errors, like on Arduino.
+	uint8_t endTransmission(bool stop = true);
 
 	// Request a number of bytes from a slave device
 	// The boolean stop indicates if the bus needs to be released
-	void requestFrom(const uint8_t address, const int size, bool stop = false);
+	// Returns number of bytes read.
+	int requestFrom(const uint8_t address, const int size, bool stop = false);
+
+	// Write a register address, then read a number of bytes starting at that register.
+	// Done in a single yield when 1 + length <= WIRE_MAX_TRANSFER_LENGTH.
+	// Returns number of bytes read into buf.
+	int writeThenRead(const uint8_t address, const uint8_t reg, uint8_t* buf, int length);
+
+	// Write bytes, then read bytes, with a repeated start in between.
+	// Done in a single yield when writeLength + readLength <= WIRE_MAX_TRANSFER_LENGTH.
+	// Returns number of bytes read into readBuf.
+	int writeThenRead(const uint8_t address, const uint8_t* writeBuf, int writeLength, uint8_t* readBuf, int readLength);
+
+	// Send a write that was kept by endTransmission(false), when it was not followed by a requestFrom().
+	// Called at the end of setup() and loop().
+	void flush();
 
 	// TODO: register callback and call from bluenet (this is as slave device)
 	// void onReceive(void *receiveEvent);
@@ -71,7 +118,7 @@ public:
 	// Write to i2c port.
 	//
 	// Returns number of bytes written.
-	int write(String str, int length);
+	int write(StringView str, int length);
 
 	// Write a string (as char array) to serial. The length will be obtained through searching for a null
 	// byte.
@@ -87,7 +134,7 @@ public:
 	int write(char value);
 
 	// Wire has both write and send defined
-	int send(String str, int length);
+	int send(StringView str, int length);
 	int send(const char* str);
 	int send(const uint8_t* buf, int length);
 	int send(char value);
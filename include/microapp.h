@@ -2,6 +2,8 @@
 
 // Get defaults from bluenet
 #include <cs_MicroappStructs.h>
+#include <microapp_batch.h>
+#include <microapp_time.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -18,7 +20,13 @@ struct interrupt_registration_t {
 	bool registered;
 };
 
+/*
+ * Max number of interrupt registrations (pins, BLE scans, mesh, etc.).
+ * Can be changed per microapp at build time, see MICROAPP_DEFINES in config.mk.
+ */
+#ifndef MAX_INTERRUPT_REGISTRATIONS
 #define MAX_INTERRUPT_REGISTRATIONS 6
+#endif
 
 extern interrupt_registration_t interruptRegistrations[MAX_INTERRUPT_REGISTRATIONS];
 
@@ -63,6 +71,28 @@ int memcmp(const void* ptr1, const void* ptr2, microapp_size_t num);
  */
 void* memcpy(void* dest, const void* src, microapp_size_t num);
 
+/**
+ * Copies num bytes from src to dest, where the buffers may overlap
+ *
+ * @param[in] dest   The starting address to copy data to
+ * @param[in] src    The starting address from where to copy data
+ * @param[in] num    The number of bytes to copy
+ *
+ * @return           A pointer to dest
+ */
+void* memmove(void* dest, const void* src, microapp_size_t num);
+
+/**
+ * Sets num bytes of dest to value
+ *
+ * @param[in] dest   The starting address of the bytes to set
+ * @param[in] value  The value to set, converted to uint8_t
+ * @param[in] num    The number of bytes to set
+ *
+ * @return           A pointer to dest
+ */
+void* memset(void* dest, int value, microapp_size_t num);
+
 /*
  * Get outgoing message buffer (can be used for sendMessage);
  */
@@ -77,6 +107,56 @@ uint8_t* getIncomingMessagePayload();
  */
 microapp_sdk_result_t sendMessage();
 
+/**
+ * Start a batch of requests.
+ *
+ * Until commitBatch() is called, requests whose result is not needed (logs, pin writes, setting the switch, sending
+ * mesh messages, TWI writes) are queued instead of sent, and immediately marked as CS_MICROAPP_SDK_ACK_SUCCESS. They
+ * are sent together, in a single yield to bluenet, when the batch is full, when commitBatch() is called, or before any
+ * other request or yield, so that the order of requests is preserved.
+ *
+ * A TWI read ends the batch: when it fits, it's sent in the same yield, and its result is copied back.
+ *
+ * @return CS_MICROAPP_SDK_ACK_SUCCESS on success
+ * @return CS_MICROAPP_SDK_ACK_ERR_BUSY if a batch has already been started
+ */
+microapp_sdk_result_t beginBatch();
+
+/**
+ * Send the queued requests and end the batch.
+ *
+ * @return CS_MICROAPP_SDK_ACK_SUCCESS if all requests in the batch succeeded
+ * @return CS_MICROAPP_SDK_ACK_ERR_EMPTY if no batch has been started
+ * @return microapp_sdk_result_t of the first batched request that failed
+ */
+microapp_sdk_result_t commitBatch();
+
+/**
+ * Get the number of interrupts that are being handled, 0 when not in an interrupt handler.
+ */
+uint8_t interruptDepth();
+
+/**
+ * Get the number of loop intervals (of MICROAPP_LOOP_INTERVAL_MS) that passed since the microapp started.
+ *
+ * This is the number of yields to bluenet outside of interrupt handlers: after each of them, bluenet resumes the
+ * microapp one loop interval later.
+ */
+uint32_t getLoopTickCount();
+
+/**
+ * Get the time since bluenet started.
+ *
+ * The time is requested from bluenet at most once per resume of the microapp, and cached until the next request or
+ * yield, so calling this often is cheap. When bluenet does not support time requests, the time is estimated from the
+ * loop ticks, with a resolution of MICROAPP_LOOP_INTERVAL_MS.
+ *
+ * @param[out] ms  Milliseconds since start, wraps around after about 50 days.
+ * @param[out] us  Microseconds within the last millisecond, from 0 to 999.
+ * @return true when the time comes from bluenet, false when it's estimated.
+ */
+bool getUptime(uint32_t* ms, uint16_t* us);
+
 /*
  * Returns the number of empty slots for bluenet.
  */
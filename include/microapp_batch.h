@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cs_MicroappStructs.h>
+
+/**
+ * Batched requests.
+ *
+ * A batch packs several requests back-to-back in a single outgoing payload, so that bluenet can handle all of them in
+ * one yield. Each entry in the batch data is a size byte, followed by the request itself, starting with its
+ * microapp_sdk_header_t. Bluenet writes the result of each request in the ack field of the entry, and the overall
+ * result in the ack field of the batch header.
+ *
+ * This message type is not part of the bluenet protocol (yet). When bluenet does not know it, the batch is answered
+ * with CS_MICROAPP_SDK_ACK_ERR_UNDEFINED, and the microapp falls back to sending the requests one by one.
+ */
+const uint8_t MICROAPP_SDK_TYPE_BATCH = 0xB0;
+
+const uint8_t MICROAPP_SDK_BATCH_HEADER_SIZE   = sizeof(microapp_sdk_header_t) + 1;
+const uint8_t MICROAPP_SDK_BATCH_MAX_DATA_SIZE = MICROAPP_SDK_MAX_PAYLOAD - MICROAPP_SDK_BATCH_HEADER_SIZE;
+
+struct __attribute__((packed)) microapp_sdk_batch_t {
+	microapp_sdk_header_t header;
+	uint8_t count;
+	uint8_t data[MICROAPP_SDK_BATCH_MAX_DATA_SIZE];
+};
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cs_MicroappStructs.h>
+
+/**
+ * Time request.
+ *
+ * Bluenet writes the time since it started in the request: whole milliseconds, and the microseconds within the last
+ * millisecond.
+ *
+ * This message type is not part of the bluenet protocol (yet). When bluenet does not know it, the request is answered
+ * with CS_MICROAPP_SDK_ACK_ERR_UNDEFINED, and the microapp estimates the time from the number of loop ticks instead.
+ */
+const uint8_t MICROAPP_SDK_TYPE_TIME = 0xB1;
+
+struct __attribute__((packed)) microapp_sdk_time_t {
+	microapp_sdk_header_t header;
+	uint32_t uptimeMs;
+	uint16_t uptimeUs;
+};
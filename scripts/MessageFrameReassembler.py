@@ -0,0 +1,84 @@
+#!/usr/bin/env python3
+
+"""
+Reassembles frames sent by a microapp with Message.beginFrame(), writeChunk() and endFrame().
+
+Each message of a frame starts with a header (see message_frame_header_t in include/Message.h):
+    uint8_t  sequence   Sequence number of the frame, the same for all messages of a frame.
+    uint8_t  flags      Bit 0: first message of the frame, bit 1: last message of the frame.
+    uint16_t offset     Offset of the data of this message in the frame (little endian).
+
+The messages of a frame arrive in order. A frame of which a message is missing is dropped.
+"""
+
+import argparse
+
+MESSAGE_FRAME_HEADER_SIZE = 4
+MESSAGE_FRAME_FLAG_FIRST = 1 << 0
+MESSAGE_FRAME_FLAG_LAST = 1 << 1
+
+
+class MessageFrameReassembler:
+    def __init__(self):
+        self.sequence = None
+        self.data = bytearray()
+        self.droppedFrames = 0
+
+    def put(self, message: bytes or list):
+        """
+        Handle a received message.
+        :param message:   the data of the message, including the frame header.
+        :return:          the data of the frame when this was its last message, else None.
+        """
+        if len(message) < MESSAGE_FRAME_HEADER_SIZE:
+            return None
+        sequence = message[0]
+        flags = message[1]
+        offset = message[2] | (message[3] << 8)
+        data = message[MESSAGE_FRAME_HEADER_SIZE:]
+
+        if flags & MESSAGE_FRAME_FLAG_FIRST:
+            if self.sequence is not None:
+                # The previous frame did not finish.
+                self.droppedFrames += 1
+            self.sequence = sequence
+            self.data = bytearray()
+        elif self.sequence is None:
+            # We missed the start of this frame.
+            return None
+
+        if sequence != self.sequence or offset != len(self.data):
+            # A message of this frame is missing.
+            self.droppedFrames += 1
+            self.sequence = None
+            return None
+
+        self.data += bytes(data)
+        if flags & MESSAGE_FRAME_FLAG_LAST:
+            self.sequence = None
+            return bytes(self.data)
+        return None
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='Reassemble frames from messages sent by a microapp.')
+    parser.add_argument('input',
+            help='File with a received message per line, in hex (as written by the host build with MICROAPP_HOST_MESSAGES).')
+    parser.add_argument('--expected-size', type=int,
+            help='Check that every frame has this size, and counts up from 0, as sent by examples/tests/message_frames.ino.')
+    args = parser.parse_args()
+
+    reassembler = MessageFrameReassembler()
+    with open(args.input, "r") as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+            frame = reassembler.put(bytes.fromhex(line))
+            if frame is None:
+                continue
+            print(f"Frame of {len(frame)} bytes: {frame.hex()}")
+            if args.expected_size is not None:
+                expected = bytes(i & 0xFF for i in range(args.expected_size))
+                print("frame OK" if frame == expected else "frame FAIL")
+    print(f"Dropped frames: {reassembler.droppedFrames}")
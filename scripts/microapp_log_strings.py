@@ -0,0 +1,138 @@
+#!/usr/bin/env python3
+
+"""
+Extracts the format strings of interned logs, and decodes interned logs (see include/Log.h).
+
+With MICROAPP_LOG_INTERNED defined, LOGd(), LOGi(), LOGw() and LOGe() send an array log holding the 16-bit id of the
+format string, followed by the arguments: integers as 32-bit, floats as 32-bit float, strings as a size byte followed
+by the characters. All little endian.
+
+    microapp_log_strings.py extract <output json> <source files>
+    microapp_log_strings.py decode <json> [<file with logs>]
+
+Decode reads lines with logs as hex bytes (for example "3A 7C 01 00 00 00"), from a file or stdin.
+Lines that are not interned logs are printed as they are.
+"""
+
+import argparse
+import codecs
+import json
+import re
+import struct
+import sys
+
+LOG_CALL_PATTERN = re.compile(r'\bLOG[diwe]\s*\(\s*((?:"(?:[^"\\]|\\.)*"\s*)+)')
+STRING_LITERAL_PATTERN = re.compile(r'"((?:[^"\\]|\\.)*)"')
+CONVERSION_PATTERN = re.compile(r'%([-0]*)(\d*)(?:\.(\d+))?[lh]*([diuxXcsfg%])')
+
+
+def logStringId(formatString: str) -> int:
+    """
+    Calculates the id of a format string, has to match microappLogStringId() in include/Log.h.
+    """
+    hash = 2166136261
+    for byte in formatString.encode('utf-8'):
+        hash = ((hash ^ byte) * 16777619) & 0xFFFFFFFF
+    return (hash >> 16) ^ (hash & 0xFFFF)
+
+
+def extract(outputFilename: str, sourceFilenames: list):
+    logStrings = {}
+    collisions = 0
+    for sourceFilename in sourceFilenames:
+        with open(sourceFilename, "r") as f:
+            source = f.read()
+        for match in LOG_CALL_PATTERN.finditer(source):
+            literals = STRING_LITERAL_PATTERN.findall(match.group(1))
+            formatString = codecs.decode("".join(literals), 'unicode_escape')
+            id = logStringId(formatString)
+            line = source.count("\n", 0, match.start()) + 1
+            if id in logStrings and logStrings[id]["format"] != formatString:
+                print(f"Id {id} of {sourceFilename}:{line} is already used for \"{logStrings[id]['format']}\" "
+                      f"({logStrings[id]['file']}:{logStrings[id]['line']}), change one of the format strings.")
+                collisions += 1
+                continue
+            logStrings[id] = {"format": formatString, "file": sourceFilename, "line": line}
+
+    with open(outputFilename, "w") as f:
+        json.dump({str(id): logString for id, logString in sorted(logStrings.items())}, f, indent=2)
+    print(f"Extracted {len(logStrings)} log strings to {outputFilename}")
+    if collisions:
+        sys.exit(1)
+
+
+def decodeLog(formatString: str, data: bytes) -> str:
+    """
+    Formats the arguments in data with the format string.
+    """
+    result = ""
+    position = 0
+    offset = 0
+    for match in CONVERSION_PATTERN.finditer(formatString):
+        result += formatString[position:match.start()]
+        position = match.end()
+        flags, width, precision, conversion = match.groups()
+        if conversion == '%':
+            result += '%'
+            continue
+        spec = f"%{flags}{width}" + (f".{precision}" if precision is not None else "")
+        if offset >= len(data):
+            result += "<missing>"
+            continue
+        if conversion == 's':
+            size = data[offset]
+            value = data[offset + 1:offset + 1 + size].decode('utf-8', errors='replace')
+            offset += 1 + size
+        elif conversion in 'fg':
+            value = struct.unpack_from("<f", data, offset)[0]
+            offset += 4
+        elif conversion in 'di':
+            value = struct.unpack_from("<i", data, offset)[0]
+            offset += 4
+        elif conversion == 'c':
+            value = chr(struct.unpack_from("<I", data, offset)[0] & 0xFF)
+            offset += 4
+        else:
+            value = struct.unpack_from("<I", data, offset)[0]
+            offset += 4
+        result += (spec + conversion) % value
+    return result + formatString[position:]
+
+
+def decode(logStringsFilename: str, inputFile):
+    with open(logStringsFilename, "r") as f:
+        logStrings = {int(id): logString["format"] for id, logString in json.load(f).items()}
+
+    for line in inputFile:
+        line = line.rstrip("\n")
+        try:
+            data = bytes.fromhex(line)
+        except ValueError:
+            data = b""
+        if len(data) < 2 or struct.unpack_from("<H", data)[0] not in logStrings:
+            print(line)
+            continue
+        print(decodeLog(logStrings[struct.unpack_from("<H", data)[0]], data[2:]))
+
+
+if __name__ == "__main__":
+    parser = argparse.ArgumentParser(description='Extract or decode interned microapp logs.')
+    subparsers = parser.add_subparsers(dest='command', required=True)
+
+    extractParser = subparsers.add_parser('extract', help='Extract the log strings from source files to a json file.')
+    extractParser.add_argument('output', help='The json file to write.')
+    extractParser.add_argument('sources', nargs='+', help='The source files.')
+
+    decodeParser = subparsers.add_parser('decode', help='Decode logs, read as hex lines.')
+    decodeParser.add_argument('logStrings', help='The json file with the log strings.')
+    decodeParser.add_argument('input', nargs='?', help='File with the logs, defaults to stdin.')
+
+    args = parser.parse_args()
+    if args.command == 'extract':
+        extract(args.output, args.sources)
+    else:
+        if args.input is None:
+            decode(args.logStrings, sys.stdin)
+        else:
+            with open(args.input, "r") as f:
+                decode(args.logStrings, f)
@@ -4,21 +4,56 @@
 
 /*
  * Implementation sends a message under the hood. The microapp itself is reponsible for looping for long enough.
- * A tick takes 100 ms. Hence the loop should be the delay in ms divided by 100.
+ * Each yield lasts until bluenet resumes the microapp, which is about a loop interval. Keep yielding until the delay
+ * has passed, so a delay is never shorter than requested. Meanwhile, tasks continue.
  */
 void delay(uint32_t delay_ms) {
-	const uint8_t bluenet_tick_duration_ms = 100;
-	uint32_t ticks                         = delay_ms / (bluenet_tick_duration_ms * MICROAPP_LOOP_FREQUENCY);
-	for (uint32_t i = 0; i < ticks; i++) {
+	uint32_t startMs;
+	uint16_t startUs;
+	bool accurate = getUptime(&startMs, &startUs);
+	if (Tasks.inTask()) {
+		Tasks.sleepUntil(startMs + delay_ms);
+		return;
+	}
+	Tasks.run();
+	// Without time from bluenet, the time only advances with the loop ticks, which is not the case within interrupts.
+	uint32_t maxYields = accurate ? UINT32_MAX : (delay_ms + MICROAPP_LOOP_INTERVAL_MS - 1) / MICROAPP_LOOP_INTERVAL_MS;
+	uint32_t elapsed   = 0;
+	for (uint32_t i = 0; i < maxYields && elapsed < delay_ms; i++) {
 		uint8_t* payload            = getOutgoingMessagePayload();
 		microapp_sdk_yield_t* yield = (microapp_sdk_yield_t*)(payload);
+		yield->header.ack           = CS_MICROAPP_SDK_ACK_NO_REQUEST;
 		yield->header.messageType   = CS_MICROAPP_SDK_TYPE_YIELD;
 		yield->type                 = CS_MICROAPP_SDK_YIELD_ASYNC;
 		yield->emptyInterruptSlots  = emptySlotsInStack();
 		sendMessage();
+		if (accurate) {
+			uint32_t nowMs;
+			uint16_t nowUs;
+			getUptime(&nowMs, &nowUs);
+			elapsed = nowMs - startMs;
+			if (elapsed >= delay_ms) {
+				break;
+			}
+		}
+		Tasks.run();
 	}
 }
 
+unsigned long millis() {
+	uint32_t ms;
+	uint16_t us;
+	getUptime(&ms, &us);
+	return ms;
+}
+
+unsigned long micros() {
+	uint32_t ms;
+	uint16_t us;
+	getUptime(&ms, &us);
+	return ms * 1000 + us;
+}
+
 bool pinExists(uint8_t pin) {
 	// First check, more checks on bluenet side
 	return (pin < NUMBER_OF_PINS);
@@ -44,17 +44,41 @@ microapp_sdk_result_t Ble::handleScanEvent(microapp_sdk_ble_scan_t* scanInterrup
 				return CS_MICROAPP_SDK_ACK_SUCCESS;
 			}
 
-			// Copy the scan data into the _scanDevice
-			MacAddress address(scanInterrupt->eventScan.address.address, MAC_ADDRESS_LENGTH, scanInterrupt->eventScan.address.type);
-			rssi_t rssi = scanInterrupt->eventScan.rssi;
-			_scanDevice = BleDevice(scanInterrupt->eventScan.data, scanInterrupt->eventScan.size, address, rssi);
+			microapp_sdk_ble_scan_event_t& scan = scanInterrupt->eventScan;
+			uint8_t scanSize                    = scan.size;
+			if (scanSize > MAX_BLE_ADV_DATA_LENGTH) {
+				scanSize = MAX_BLE_ADV_DATA_LENGTH;
+			}
+
+			if (!_scanFilterChain.passes(scan.address.address, scan.rssi, scan.data, scanSize)) {
+				return CS_MICROAPP_SDK_ACK_SUCCESS;
+			}
+			if (!_flags.withDuplicates && _scanCache.isDuplicate(scan.address.address, scan.rssi)) {
+				return CS_MICROAPP_SDK_ACK_SUCCESS;
+			}
 
 			// Call the event handler, if any.
 			auto handler = (DeviceEventHandler*)getBleEventHandler(BLEDeviceScanned);
 			if (handler != nullptr) {
+				// Copy the scan data into the _scanDevice
+				MacAddress address(scan.address.address, MAC_ADDRESS_LENGTH, scan.address.type);
+				_scanDevice = BleDevice(scan.data, scanSize, address, scan.rssi);
 				(*handler)(_scanDevice);
+				return CS_MICROAPP_SDK_ACK_SUCCESS;
 			}
 
+			// Otherwise buffer the scan, to be retrieved via available()
+			ble_scan_record_t* record = _scanBuffer.reserve();
+			if (record == nullptr) {
+				// Dropped, see droppedScanCount(). The interrupt itself was handled.
+				return CS_MICROAPP_SDK_ACK_SUCCESS;
+			}
+			memcpy(record->address, scan.address.address, MAC_ADDRESS_LENGTH);
+			record->addressType = scan.address.type;
+			record->rssi        = scan.rssi;
+			record->size        = scanSize;
+			memcpy(record->data, scan.data, scanSize);
+			_scanBuffer.commit();
 			return CS_MICROAPP_SDK_ACK_SUCCESS;
 		}
 		default: {
@@ -72,8 +96,9 @@ microapp_sdk_result_t Ble::handleCentralEvent(microapp_sdk_ble_central_t* centra
 	microapp_sdk_result_t result;
 	switch (central->type) {
 		case CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_CONNECT: {
+			BleRequestToken token = _requests.find(BleRequestConnect, 0);
 			if (central->eventConnect.result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-				_peripheral._asyncResult = BleAsyncFailure;
+				_requests.complete(token, (microapp_sdk_result_t)central->eventConnect.result);
 				return CS_MICROAPP_SDK_ACK_SUCCESS;
 			}
 			_peripheral.onConnect(central->connectionHandle);
@@ -83,6 +108,7 @@ microapp_sdk_result_t Ble::handleCentralEvent(microapp_sdk_ble_central_t* centra
 			if (handler != nullptr) {
 				(*handler)(_peripheral);
 			}
+			_requests.complete(token, CS_MICROAPP_SDK_ACK_SUCCESS);
 			return CS_MICROAPP_SDK_ACK_SUCCESS;
 		}
 		case CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_DISCONNECT: {
@@ -90,6 +116,9 @@ microapp_sdk_result_t Ble::handleCentralEvent(microapp_sdk_ble_central_t* centra
 			// clean up own member variables as well
 			_remoteServiceCount = 0;
 			_remoteCharacteristicCount = 0;
+			_attributeCache.cancelRecording();
+			// requests to the peripheral will not complete anymore
+			_requests.completeAll(CS_MICROAPP_SDK_ACK_ERROR);
 
 			// Call the event handler, if any.
 			auto handler = (DeviceEventHandler*)getBleEventHandler(BLEDisconnected);
@@ -99,62 +128,26 @@ microapp_sdk_result_t Ble::handleCentralEvent(microapp_sdk_ble_central_t* centra
 			return CS_MICROAPP_SDK_ACK_SUCCESS;
 		}
 		case CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_DISCOVER: {
-			if (central->eventDiscover.valueHandle == 0) {
-				// discovered a service
-				if (_remoteServiceCount >= MAX_REMOTE_SERVICES) {
-					return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
-				}
-				BleService service(&central->eventDiscover.uuid);
-				_remoteServices[_remoteServiceCount] = service;
-				// add to device
-				result = _peripheral.addDiscoveredService(&_remoteServices[_remoteServiceCount]);
-				if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-					return result;
-				}
-				_remoteServiceCount++;
-			}
-			else {
-				// discovered a characteristic
-				if (_remoteCharacteristicCount >= MAX_REMOTE_CHARACTERISTICS) {
-					return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
-				}
-				uint8_t properties = 0;
-				if (central->eventDiscover.options.read) {
-					properties |= BleCharacteristicProperties::BLERead;
-				}
-				if (central->eventDiscover.options.writeNoResponse) {
-					properties |= BleCharacteristicProperties::BLEWriteWithoutResponse;
-				}
-				if (central->eventDiscover.options.write) {
-					properties |= BleCharacteristicProperties::BLEWrite;
-				}
-				if (central->eventDiscover.options.notify) {
-					properties |= BleCharacteristicProperties::BLENotify;
-				}
-				if (central->eventDiscover.options.indicate) {
-					properties |= BleCharacteristicProperties::BLEIndicate;
-				}
-				BleCharacteristic characteristic(&central->eventDiscover.uuid, properties);
-				characteristic._valueHandle = central->eventDiscover.valueHandle;
-				characteristic._cccdHandle = central->eventDiscover.cccdHandle;
-				_remoteCharacteristics[_remoteCharacteristicCount] = characteristic;
-				// add to device
-				Uuid serviceUuid(central->eventDiscover.serviceUuid.uuid, central->eventDiscover.serviceUuid.type);
-				result = _peripheral.addDiscoveredCharacteristic(
-						&_remoteCharacteristics[_remoteCharacteristicCount], serviceUuid);
-				if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-					return result;
-				}
-				_remoteCharacteristicCount++;
+			result = onDiscover(&central->eventDiscover);
+			if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+				// an incomplete discovery is not cached
+				_attributeCache.cancelRecording();
+				return result;
 			}
+			_attributeCache.record(&central->eventDiscover);
 			return CS_MICROAPP_SDK_ACK_SUCCESS;
 		}
 		case CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_DISCOVER_DONE: {
+			BleRequestToken token = _requests.find(BleRequestDiscover, 0);
 			if (central->eventDiscoverDone.result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-				_peripheral._asyncResult = BleAsyncFailure;
+				_attributeCache.cancelRecording();
+				_requests.complete(token, (microapp_sdk_result_t)central->eventDiscoverDone.result);
 				return CS_MICROAPP_SDK_ACK_SUCCESS;
 			}
+			// the next connection to this peripheral skips discovery
+			_attributeCache.finishRecording();
 			_peripheral.onDiscoverDone();
+			_requests.complete(token, CS_MICROAPP_SDK_ACK_SUCCESS);
 			return CS_MICROAPP_SDK_ACK_SUCCESS;
 		}
 		case CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_WRITE: {
@@ -163,14 +156,9 @@ microapp_sdk_result_t Ble::handleCentralEvent(microapp_sdk_ble_central_t* centra
 			if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 				return result;
 			}
+			// complete the request, so a blocking function may return or the next request may be sent
 			result = (microapp_sdk_result_t)central->eventWrite.result;
-			if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-				// set async result
-				characteristic->_asyncResult = BleAsyncFailure;
-				return result;
-			}
-			// set async result so blocking function may return
-			result = characteristic->onRemoteWritten();
+			_requests.complete(_requests.find(BleRequestWrite, central->eventWrite.handle), result);
 			return result;
 		}
 		case CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_READ: {
@@ -179,13 +167,17 @@ microapp_sdk_result_t Ble::handleCentralEvent(microapp_sdk_ble_central_t* centra
 			if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 				return result;
 			}
-			result = (microapp_sdk_result_t)central->eventRead.result;
+			BleRequestToken token = _requests.find(BleRequestRead, central->eventRead.valueHandle);
+			result                = (microapp_sdk_result_t)central->eventRead.result;
 			if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-				characteristic->_asyncResult = BleAsyncFailure;
+				_requests.complete(token, result);
 				return result;
 			}
-			result = characteristic->onRemoteRead(&central->eventRead);
-			return result;
+			if (!_requests.addReadData(token, &central->eventRead)) {
+				// more parts of a long value follow
+				return CS_MICROAPP_SDK_ACK_SUCCESS;
+			}
+			return _requests.completeRead(token);
 		}
 		case CS_MICROAPP_SDK_BLE_CENTRAL_EVENT_NOTIFICATION: {
 			BleCharacteristic* characteristic;
@@ -211,6 +203,75 @@ microapp_sdk_result_t Ble::handleCentralEvent(microapp_sdk_ble_central_t* centra
 	}
 }
 
+microapp_sdk_result_t Ble::onDiscover(microapp_sdk_ble_central_event_discover_t* eventDiscover) {
+	microapp_sdk_result_t result;
+	if (eventDiscover->valueHandle == 0) {
+		// discovered a service
+		if (_remoteServiceCount >= MAX_REMOTE_SERVICES) {
+			return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+		}
+		BleService service(&eventDiscover->uuid);
+		_remoteServices[_remoteServiceCount] = service;
+		// add to device
+		result = _peripheral.addDiscoveredService(&_remoteServices[_remoteServiceCount]);
+		if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+			return result;
+		}
+		_remoteServiceCount++;
+	}
+	else {
+		// discovered a characteristic
+		if (_remoteCharacteristicCount >= MAX_REMOTE_CHARACTERISTICS) {
+			return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+		}
+		uint8_t properties = 0;
+		if (eventDiscover->options.read) {
+			properties |= BleCharacteristicProperties::BLERead;
+		}
+		if (eventDiscover->options.writeNoResponse) {
+			properties |= BleCharacteristicProperties::BLEWriteWithoutResponse;
+		}
+		if (eventDiscover->options.write) {
+			properties |= BleCharacteristicProperties::BLEWrite;
+		}
+		if (eventDiscover->options.notify) {
+			properties |= BleCharacteristicProperties::BLENotify;
+		}
+		if (eventDiscover->options.indicate) {
+			properties |= BleCharacteristicProperties::BLEIndicate;
+		}
+		BleCharacteristic characteristic(&eventDiscover->uuid, properties);
+		characteristic._valueHandle = eventDiscover->valueHandle;
+		characteristic._cccdHandle = eventDiscover->cccdHandle;
+		_remoteCharacteristics[_remoteCharacteristicCount] = characteristic;
+		// add to device
+		Uuid serviceUuid(eventDiscover->serviceUuid.uuid, eventDiscover->serviceUuid.type);
+		result = _peripheral.addDiscoveredCharacteristic(
+				&_remoteCharacteristics[_remoteCharacteristicCount], serviceUuid);
+		if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+			return result;
+		}
+		_remoteCharacteristicCount++;
+	}
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+bool Ble::discoverCached(microapp_sdk_ble_uuid_t service) {
+	const uint8_t* address = _peripheral._address.bytes();
+	uint8_t count          = _attributeCache.find(address, service);
+	if (count == 0) {
+		_attributeCache.startRecording(address, service);
+		return false;
+	}
+	microapp_sdk_ble_central_event_discover_t eventDiscover;
+	for (uint8_t i = 0; i < count; ++i) {
+		_attributeCache.getAttribute(address, i, eventDiscover);
+		onDiscover(&eventDiscover);
+	}
+	_peripheral.onDiscoverDone();
+	return true;
+}
+
 microapp_sdk_result_t Ble::handlePeripheralEvent(microapp_sdk_ble_peripheral_t* peripheral) {
 	microapp_sdk_result_t result;
 	switch (peripheral->type) {
@@ -346,8 +407,10 @@ bool Ble::begin() {
 void Ble::end() {
 	_address = MacAddress();
 	_scanDevice = BleDevice();
+	_scanBuffer.clear();
 	_peripheral = BleDevice();
 	_central = BleDevice();
+	_requests.clear();
 	_flags.initialized = false;
 	_flags.isScanning = false;
 	_flags.registeredCentralInterrupts = false;
@@ -442,11 +505,11 @@ bool Ble::disconnect(uint32_t timeout) {
 	}
 }
 
-String Ble::address() {
+MacAddressString Ble::address() {
 	if (!_flags.initialized) {
-		return String(nullptr);
+		return MacAddressString();
 	}
-	return String(_address.string());
+	return _address.string();
 }
 
 int8_t Ble::rssi() {
@@ -505,6 +568,9 @@ bool Ble::scan(bool withDuplicates) {
 	}
 	// Reset existing _scanDevice
 	_scanDevice = BleDevice();
+	_scanBuffer.clear();
+	_scanCache.clear();
+	_flags.withDuplicates = withDuplicates;
 	if (_flags.isScanning) {
 		return true;
 	}
@@ -530,6 +596,7 @@ bool Ble::scan(bool withDuplicates) {
 		return false;
 	}
 	_flags.isScanning = true;
+	_scanBuffer.resetStatistics();
 	return true;
 }
 
@@ -620,6 +687,7 @@ bool Ble::stopScan() {
 	}
 	// Reset existing _scanDevice
 	_scanDevice = BleDevice();
+	_scanBuffer.clear();
 
 	// send a message to bluenet asking it to stop forwarding ads to microapp
 	uint8_t* payload               = getOutgoingMessagePayload();
@@ -642,19 +710,56 @@ bool Ble::stopScan() {
 }
 
 BleDevice& Ble::available() {
-	if (!_flags.initialized || !_flags.isScanning ||
-		!_scanDevice || !_scanDevice._flags.isPeripheral) {
+	ble_scan_record_t* record = _scanBuffer.front();
+	if (!_flags.initialized || !_flags.isScanning || record == nullptr) {
 		// Reset peripheral device
 		_peripheral = BleDevice();
 		return _peripheral;
 	}
-	// Set main (persistent) device as the latest scanned device
-	_peripheral = _scanDevice;
-	// Reset scan device
-	_scanDevice = BleDevice();
+	// Set main (persistent) device as the oldest scanned device
+	MacAddress address(record->address, MAC_ADDRESS_LENGTH, record->addressType);
+	_peripheral = BleDevice(record->data, record->size, address, record->rssi);
+	_scanBuffer.release();
 	return _peripheral;
 }
 
+BleScanFilterChain& Ble::scanFilters() {
+	return _scanFilterChain;
+}
+
+void Ble::setDuplicateFilter(uint32_t timeToLiveMs, uint8_t rssiThreshold) {
+	_scanCache.setTimeToLive(timeToLiveMs);
+	_scanCache.setRssiThreshold(rssiThreshold);
+}
+
+uint16_t Ble::duplicateScanCount() {
+	return _scanCache.duplicateCount();
+}
+
+uint8_t Ble::scannedCount() {
+	return _scanBuffer.size();
+}
+
+uint16_t Ble::droppedScanCount() {
+	return _scanBuffer.overflowCount();
+}
+
+bool Ble::requestPending(BleRequestToken token) {
+	return _requests.pending(token);
+}
+
+void Ble::cancelRequest(BleRequestToken token) {
+	_requests.remove(token);
+}
+
+void Ble::clearAttributeCache() {
+	_attributeCache.clear();
+}
+
+bool discoverCachedService(microapp_sdk_ble_uuid_t service) {
+	return BLE.discoverCached(service);
+}
+
 microapp_sdk_result_t registerBleEventHandler(BleEventType eventType, BleEventHandler eventHandler) {
 	// Check if the type already exists.
 	for (int i = 0; i < BLE.MAX_BLE_EVENT_HANDLER_REGISTRATIONS; ++i) {
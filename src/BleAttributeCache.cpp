@@ -0,0 +1,125 @@
+#include <BleAttributeCache.h>
+
+namespace {
+
+bool sameUuid(const microapp_sdk_ble_uuid_t& a, const microapp_sdk_ble_uuid_t& b) {
+	return a.type == b.type && a.uuid == b.uuid;
+}
+
+}  // namespace
+
+BleAttributeCache::Entry* BleAttributeCache::get(const uint8_t* address) {
+	if (address == nullptr) {
+		return nullptr;
+	}
+	for (uint8_t i = 0; i < BLE_ATTRIBUTE_CACHE_SIZE; ++i) {
+		Entry& entry = _entries[i];
+		if (entry.used && memcmp(entry.address, address, MAC_ADDRESS_LENGTH) == 0) {
+			return &entry;
+		}
+	}
+	return nullptr;
+}
+
+uint8_t BleAttributeCache::find(const uint8_t* address, microapp_sdk_ble_uuid_t service) {
+	Entry* entry = get(address);
+	if (entry == nullptr || !sameUuid(entry->service, service)) {
+		return 0;
+	}
+	entry->usedAt = ++_useCount;
+	return entry->attributeCount;
+}
+
+bool BleAttributeCache::getAttribute(
+		const uint8_t* address, uint8_t index, microapp_sdk_ble_central_event_discover_t& eventDiscover) {
+	Entry* entry = get(address);
+	if (entry == nullptr || index >= entry->attributeCount) {
+		return false;
+	}
+	Attribute& attribute      = entry->attributes[index];
+	eventDiscover.uuid        = attribute.uuid;
+	eventDiscover.valueHandle = attribute.valueHandle;
+	eventDiscover.cccdHandle  = attribute.cccdHandle;
+	eventDiscover.options     = attribute.options;
+	// A characteristic belongs to the service before it.
+	eventDiscover.serviceUuid = attribute.uuid;
+	for (int8_t i = index; i >= 0; --i) {
+		if (entry->attributes[i].valueHandle == 0) {
+			eventDiscover.serviceUuid = entry->attributes[i].uuid;
+			break;
+		}
+	}
+	return true;
+}
+
+void BleAttributeCache::startRecording(const uint8_t* address, microapp_sdk_ble_uuid_t service) {
+	_recording = nullptr;
+	if (address == nullptr) {
+		return;
+	}
+	// Prefer the entry of the peripheral, then an empty entry, otherwise the one that was used longest ago.
+	Entry* replacement = get(address);
+	for (uint8_t i = 0; i < BLE_ATTRIBUTE_CACHE_SIZE && replacement == nullptr; ++i) {
+		if (!_entries[i].used) {
+			replacement = &_entries[i];
+		}
+	}
+	if (replacement == nullptr) {
+		replacement = &_entries[0];
+		for (uint8_t i = 1; i < BLE_ATTRIBUTE_CACHE_SIZE; ++i) {
+			Entry& entry = _entries[i];
+			// Compare the distance to the use count, as it wraps around.
+			if ((uint16_t)(_useCount - entry.usedAt) > (uint16_t)(_useCount - replacement->usedAt)) {
+				replacement = &entry;
+			}
+		}
+	}
+	memcpy(replacement->address, address, MAC_ADDRESS_LENGTH);
+	replacement->used           = false;
+	replacement->service        = service;
+	replacement->attributeCount = 0;
+	_recording                  = replacement;
+}
+
+void BleAttributeCache::record(microapp_sdk_ble_central_event_discover_t* eventDiscover) {
+	if (_recording == nullptr) {
+		return;
+	}
+	if (_recording->attributeCount >= BLE_ATTRIBUTE_CACHE_MAX_ATTRIBUTES) {
+		// Too many attributes to cache this peripheral.
+		_recording = nullptr;
+		return;
+	}
+	Attribute& attribute  = _recording->attributes[_recording->attributeCount++];
+	attribute.uuid        = eventDiscover->uuid;
+	attribute.valueHandle = eventDiscover->valueHandle;
+	attribute.cccdHandle  = eventDiscover->cccdHandle;
+	attribute.options     = eventDiscover->options;
+}
+
+void BleAttributeCache::finishRecording() {
+	if (_recording == nullptr) {
+		return;
+	}
+	_recording->used   = true;
+	_recording->usedAt = ++_useCount;
+	_recording         = nullptr;
+}
+
+void BleAttributeCache::cancelRecording() {
+	_recording = nullptr;
+}
+
+void BleAttributeCache::remove(const uint8_t* address) {
+	Entry* entry = get(address);
+	if (entry != nullptr) {
+		entry->used = false;
+	}
+}
+
+void BleAttributeCache::clear() {
+	for (uint8_t i = 0; i < BLE_ATTRIBUTE_CACHE_SIZE; ++i) {
+		_entries[i].used = false;
+	}
+	_recording = nullptr;
+}
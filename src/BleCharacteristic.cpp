@@ -137,38 +137,13 @@ microapp_sdk_result_t BleCharacteristic::writeValueRemote(uint8_t* buffer, uint1
 	if (!canWrite()) {
 		return CS_MICROAPP_SDK_ACK_ERR_DISABLED;
 	}
-	if (length > MAX_CHARACTERISTIC_VALUE_SIZE) {
-		length = MAX_CHARACTERISTIC_VALUE_SIZE;
-	}
-	// Indicate we are waiting for an async event with a result
-	// This has to be set before the sendMessage call
-	_asyncResult = BleAsyncWaiting;
-
-	microapp_sdk_result_t result;
-	uint8_t* payload                             = getOutgoingMessagePayload();
-	microapp_sdk_ble_t* bleRequest               = (microapp_sdk_ble_t*)(payload);
-	bleRequest->header.messageType               = CS_MICROAPP_SDK_TYPE_BLE;
-	bleRequest->header.ack                       = CS_MICROAPP_SDK_ACK_REQUEST;
-	bleRequest->type                             = CS_MICROAPP_SDK_BLE_CENTRAL;
-	bleRequest->central.type                     = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_WRITE;
-	bleRequest->central.requestWrite.buffer      = buffer;
-	bleRequest->central.requestWrite.size        = length;
-	bleRequest->central.requestWrite.handle      = _valueHandle;
-	bleRequest->central.connectionHandle         = 0;
-
-	sendMessage();
-	result = (microapp_sdk_result_t)bleRequest->header.ack;
-	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
-		// direct success
-		_asyncResult = BleAsyncNotWaiting;
-		return result;
-	}
-	if (result != CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
-		_asyncResult = BleAsyncNotWaiting;
+	BleRequestToken token;
+	microapp_sdk_result_t result = requestWriteRemote(_valueHandle, buffer, length, nullptr, token);
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 		return result;
 	}
 	// Block until write event happens
-	return waitForAsyncResult(timeout);
+	return getBleRequestTable().wait(token, timeout);
 }
 
 // Only defined for remote characteristics
@@ -182,63 +157,39 @@ microapp_sdk_result_t BleCharacteristic::readValueRemote(uint8_t* buffer, uint16
 	if (!canRead()) {
 		return CS_MICROAPP_SDK_ACK_ERR_DISABLED;
 	}
-	if (length > MAX_CHARACTERISTIC_VALUE_SIZE) {
-		length = MAX_CHARACTERISTIC_VALUE_SIZE;
-	}
-	// Set value pointer and max size
-	_value     = buffer;
-	_valueSize = length;
-
-	// Indicate we are waiting for an async event with a result
-	// This has to be set before the sendMessage call
-	_asyncResult = BleAsyncWaiting;
-
-	microapp_sdk_result_t result;
-	uint8_t* payload                            = getOutgoingMessagePayload();
-	microapp_sdk_ble_t* bleRequest              = (microapp_sdk_ble_t*)(payload);
-	bleRequest->header.messageType              = CS_MICROAPP_SDK_TYPE_BLE;
-	bleRequest->header.ack                      = CS_MICROAPP_SDK_ACK_REQUEST;
-	bleRequest->type                            = CS_MICROAPP_SDK_BLE_CENTRAL;
-	bleRequest->central.type                    = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_READ;
-	bleRequest->central.requestRead.valueHandle = _valueHandle;
-	bleRequest->central.connectionHandle        = 0;
-
-	sendMessage();
-	result = (microapp_sdk_result_t)bleRequest->header.ack;
-	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
-		// direct success
-		_asyncResult = BleAsyncNotWaiting;
-		return result;
-	}
-	if (result != CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
-		_asyncResult = BleAsyncNotWaiting;
+	BleRequestToken token;
+	microapp_sdk_result_t result = requestReadRemote(buffer, length, nullptr, token);
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 		return result;
 	}
 	// Block until read event happens
-	return waitForAsyncResult(timeout);
+	return getBleRequestTable().wait(token, timeout);
 }
 
-microapp_sdk_result_t BleCharacteristic::onRemoteWritten() {
-	if (!_flags.remote) {
-		return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
-	}
-	_asyncResult = BleAsyncSuccess;
-	return CS_MICROAPP_SDK_ACK_SUCCESS;
+// Only defined for remote characteristics
+microapp_sdk_result_t BleCharacteristic::requestWriteRemote(
+		uint16_t handle, uint8_t* buffer, uint16_t length, BleRequestHandler handler, BleRequestToken& token) {
+	// Bluenet writes values longer than fit in a single packet in parts.
+	return getBleRequestTable().queueWrite(BLE_CONNECTION_HANDLE_PLACEHOLDER, handle, buffer, length, handler, token);
+}
+
+// Only defined for remote characteristics
+microapp_sdk_result_t BleCharacteristic::requestReadRemote(
+		uint8_t* buffer, uint16_t length, BleRequestHandler handler, BleRequestToken& token) {
+	// Set max size, the value pointer is set when the read completes
+	_valueSize = length;
+	// Values longer than fit in a single event are read in parts, into the buffer
+	return getBleRequestTable().queueRead(
+			BLE_CONNECTION_HANDLE_PLACEHOLDER, _valueHandle, this, buffer, length, handler, token);
 }
 
-microapp_sdk_result_t BleCharacteristic::onRemoteRead(microapp_sdk_ble_central_event_read_t* eventRead) {
+microapp_sdk_result_t BleCharacteristic::onRemoteRead(uint8_t* buffer, uint16_t length) {
 	if (!_flags.remote) {
 		return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
 	}
-	// Data size is limited by valueSize of characteristic
-	uint8_t size = eventRead->size;
-	if (size > _valueSize) {
-		size = _valueSize;
-	}
-	// Copy data to value pointer
-	memcpy(_value, eventRead->data, size);
-	_valueLength = size;
-	_asyncResult = BleAsyncSuccess;
+	// The data is read into the buffer of the request already
+	_value       = buffer;
+	_valueLength = length;
 	return CS_MICROAPP_SDK_ACK_SUCCESS;
 }
 
@@ -282,31 +233,11 @@ microapp_sdk_result_t BleCharacteristic::onLocalNotificationDone() {
 	return CS_MICROAPP_SDK_ACK_SUCCESS;
 }
 
-microapp_sdk_result_t BleCharacteristic::waitForAsyncResult(uint32_t timeout) {
-	// Before calling this function, the asyncResult variable needs
-	// to be set to BleAsyncWaiting. It will even need to be set before
-	// the sendMessage call with the request to bluenet
-	int16_t tries = timeout / MICROAPP_LOOP_INTERVAL_MS;
-	while (_asyncResult == BleAsyncWaiting) {
-		// Yield. Upon an event from bluenet asyncResult will be set
-		delay(MICROAPP_LOOP_INTERVAL_MS);
-		if (--tries <= 0) {
-			return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT;
-		}
-	}
-	if (_asyncResult == BleAsyncFailure) {
-		_asyncResult = BleAsyncNotWaiting;
-		return CS_MICROAPP_SDK_ACK_ERROR;
-	}
-	_asyncResult = BleAsyncNotWaiting;
-	return CS_MICROAPP_SDK_ACK_SUCCESS;
-}
-
-String BleCharacteristic::uuid() {
+UuidString BleCharacteristic::uuid() {
 	if (!_flags.initialized) {
-		return String(nullptr);
+		return UuidString();
 	}
-	return String(_uuid.string());
+	return _uuid.string();
 }
 
 uint8_t BleCharacteristic::properties() {
@@ -362,6 +293,28 @@ bool BleCharacteristic::writeValue(uint8_t* buffer, uint16_t length) {
 	}
 }
 
+// Only defined for remote characteristics
+BleRequestToken BleCharacteristic::readValueAsync(uint8_t* buffer, uint16_t length, BleRequestHandler handler) {
+	if (!_flags.initialized || !_flags.remote || !canRead() || handler == nullptr) {
+		return BLE_REQUEST_TOKEN_NONE;
+	}
+	// Clear valueUpdated flag after set on notify
+	_flags.remoteValueUpdated = false;
+	BleRequestToken token;
+	requestReadRemote(buffer, length, handler, token);
+	return token;
+}
+
+// Only defined for remote characteristics
+BleRequestToken BleCharacteristic::writeValueAsync(uint8_t* buffer, uint16_t length, BleRequestHandler handler) {
+	if (!_flags.initialized || !_flags.remote || !canWrite() || handler == nullptr) {
+		return BLE_REQUEST_TOKEN_NONE;
+	}
+	BleRequestToken token;
+	requestWriteRemote(_valueHandle, buffer, length, handler, token);
+	return token;
+}
+
 
 microapp_sdk_result_t BleCharacteristic::setEventHandler(BleEventType eventType, BleEventHandler eventHandler) {
 	if (!_flags.initialized) {
@@ -467,36 +420,7 @@ bool BleCharacteristic::subscribe(uint32_t timeout) {
 		// Both are not allowed. Subscribing not possible
 		return false;
 	}
-	// Indicate we are waiting for an async event with a result
-	// This has to be set before the sendMessage call
-	_asyncResult = BleAsyncWaiting;
-
-	microapp_sdk_result_t result;
-	uint8_t* payload                     = getOutgoingMessagePayload();
-	microapp_sdk_ble_t* bleRequest       = (microapp_sdk_ble_t*)(payload);
-	bleRequest->header.messageType       = CS_MICROAPP_SDK_TYPE_BLE;
-	bleRequest->header.ack               = CS_MICROAPP_SDK_ACK_REQUEST;
-	bleRequest->type                     = CS_MICROAPP_SDK_BLE_CENTRAL;
-	bleRequest->central.type             = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_WRITE;
-	bleRequest->central.requestWrite.handle = _cccdHandle;
-	bleRequest->central.requestWrite.buffer = reinterpret_cast<uint8_t*>(&_cccdValue);
-	bleRequest->central.requestWrite.size = 2;
-	bleRequest->central.connectionHandle = BLE_CONNECTION_HANDLE_PLACEHOLDER;
-
-	sendMessage();
-	result = (microapp_sdk_result_t)bleRequest->header.ack;
-		result = (microapp_sdk_result_t)bleRequest->header.ack;
-	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
-		// direct success
-		_asyncResult = BleAsyncNotWaiting;
-		return true;
-	}
-	if (result != CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
-		_asyncResult = BleAsyncNotWaiting;
-		return false;
-	}
-	// Block until write event happens
-	return (waitForAsyncResult(timeout) == CS_MICROAPP_SDK_ACK_SUCCESS);
+	return writeCccdRemote(timeout);
 }
 
 bool BleCharacteristic::canUnsubscribe() {
@@ -517,35 +441,19 @@ bool BleCharacteristic::unsubscribe(uint32_t timeout) {
 	}
 	// Clear the notify and indicate bits both
 	_cccdValue = 0;
-	// Indicate we are waiting for an async event with a result
-	// This has to be set before the sendMessage call
-	_asyncResult = BleAsyncWaiting;
-
-	microapp_sdk_result_t result;
-	uint8_t* payload                     = getOutgoingMessagePayload();
-	microapp_sdk_ble_t* bleRequest       = (microapp_sdk_ble_t*)(payload);
-	bleRequest->header.messageType       = CS_MICROAPP_SDK_TYPE_BLE;
-	bleRequest->header.ack               = CS_MICROAPP_SDK_ACK_REQUEST;
-	bleRequest->type                     = CS_MICROAPP_SDK_BLE_CENTRAL;
-	bleRequest->central.type             = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_WRITE;
-	bleRequest->central.connectionHandle = BLE_CONNECTION_HANDLE_PLACEHOLDER;
-	bleRequest->central.requestWrite.handle = _cccdHandle;
-	bleRequest->central.requestWrite.buffer = reinterpret_cast<uint8_t*>(&_cccdValue);
-	bleRequest->central.requestWrite.size = 2;
+	return writeCccdRemote(timeout);
+}
 
-	sendMessage();
-	result = (microapp_sdk_result_t)bleRequest->header.ack;
-	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
-		// direct success
-		_asyncResult = BleAsyncNotWaiting;
-		return true;
-	}
-	if (result != CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
-		_asyncResult = BleAsyncNotWaiting;
+// Only defined for remote characteristics
+bool BleCharacteristic::writeCccdRemote(uint32_t timeout) {
+	BleRequestToken token;
+	microapp_sdk_result_t result =
+			requestWriteRemote(_cccdHandle, reinterpret_cast<uint8_t*>(&_cccdValue), 2, nullptr, token);
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 		return false;
 	}
 	// Block until write event happens
-	return (waitForAsyncResult(timeout) == CS_MICROAPP_SDK_ACK_SUCCESS);
+	return (getBleRequestTable().wait(token, timeout) == CS_MICROAPP_SDK_ACK_SUCCESS);
 }
 
 // Only defined for remote characteristics
@@ -7,7 +7,8 @@ BleDevice::BleDevice(uint8_t* scanData, uint8_t scanSize, MacAddress address, rs
 	if (_scanSize > sizeof(_scanData)) {
 		_scanSize = sizeof(_scanData);
 	}
-	memcpy(_scanData, scanData, scanSize);
+	memcpy(_scanData, scanData, _scanSize);
+	_scanIndex.build(_scanData, _scanSize);
 	_address                  = address;
 	_rssi                     = rssi;
 	_flags.isPeripheral = true;
@@ -29,10 +30,6 @@ BleDevice::operator bool() const {
 void BleDevice::onConnect(uint16_t connectionHandle) {
 	_flags.connected = true;
 	_connectionHandle = connectionHandle;
-	// set async result flag
-	if (_flags.isPeripheral) {
-		_asyncResult = BleAsyncSuccess;
-	}
 }
 
 // Defined for both central and peripheral devices
@@ -50,10 +47,6 @@ void BleDevice::onDisconnect() {
 
 void BleDevice::onDiscoverDone() {
 	_flags.discoveryDone = true;
-	// set async result flag
-	if (_flags.isPeripheral) {
-		_asyncResult = BleAsyncSuccess;
-	}
 }
 
 // Only defined for peripheral devices
@@ -97,13 +90,14 @@ bool BleDevice::waitForAsyncResult(uint32_t timeout) {
 	// Before calling this function, the asyncResult variable needs
 	// to be set to BleAsyncWaiting. It will even need to be set before
 	// the sendMessage call with the request to bluenet
-	int16_t tries = timeout / MICROAPP_LOOP_INTERVAL_MS;
+	uint32_t startMs = millis();
 	while (_asyncResult == BleAsyncWaiting) {
-		// Yield. Upon an event from bluenet asyncResult will be set
-		delay(MICROAPP_LOOP_INTERVAL_MS);
-		if (--tries <= 0) {
+		if (millis() - startMs >= timeout) {
+			_asyncResult = BleAsyncNotWaiting;
 			return false;
 		}
+		// Yield. Upon an event from bluenet asyncResult will be set
+		delay(MICROAPP_LOOP_INTERVAL_MS);
 	}
 	if (_asyncResult == BleAsyncFailure) {
 		_asyncResult = BleAsyncNotWaiting;
@@ -140,12 +134,13 @@ bool BleDevice::disconnect(uint32_t timeout) {
 	microapp_sdk_ble_t* bleRequest = (microapp_sdk_ble_t*)(payload);
 	bleRequest->header.messageType = CS_MICROAPP_SDK_TYPE_BLE;
 	bleRequest->header.ack         = CS_MICROAPP_SDK_ACK_REQUEST;
-	if (_flags.isCentral) {
+	// The role of the crownstone is the opposite of the role of this device
+	if (_flags.isPeripheral) {
 		bleRequest->type                     = CS_MICROAPP_SDK_BLE_CENTRAL;
 		bleRequest->central.type             = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_DISCONNECT;
 		bleRequest->central.connectionHandle = _connectionHandle;
 	}
-	else if (_flags.isPeripheral) {
+	else if (_flags.isCentral) {
 		bleRequest->type                        = CS_MICROAPP_SDK_BLE_PERIPHERAL;
 		bleRequest->peripheral.type             = CS_MICROAPP_SDK_BLE_PERIPHERAL_REQUEST_DISCONNECT;
 		bleRequest->peripheral.connectionHandle = _connectionHandle;
@@ -165,8 +160,8 @@ bool BleDevice::disconnect(uint32_t timeout) {
 }
 
 // Defined for both central and peripheral devices
-String BleDevice::address() {
-	return String(_address.string());
+MacAddressString BleDevice::address() {
+	return _address.string();
 }
 
 // Only defined for peripheral devices
@@ -184,48 +179,56 @@ bool BleDevice::discoverAttributes() {
 
 // Only defined for peripheral devices
 bool BleDevice::discoverService(const char* serviceUuid, uint32_t timeout) {
-	if (!_flags.initialized || !_flags.isPeripheral) {
+	BleRequestToken token;
+	microapp_sdk_result_t result = requestDiscover(serviceUuid, nullptr, token);
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 		return false;
 	}
-	if (_flags.discoveryDone) {
-		return true;
-	}
-	microapp_sdk_result_t result;
-	Uuid uuid(serviceUuid);
-	if (!uuid.registered()) {
-		result = uuid.registerCustom();
-		if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-			return false;
-		}
-	}
-	// Indicate we are waiting for an async event with a result
-	// This has to be set before the sendMessage call
-	_asyncResult = BleAsyncWaiting;
+	return (getBleRequestTable().wait(token, timeout) == CS_MICROAPP_SDK_ACK_SUCCESS);
+}
 
-	uint8_t* payload                                  = getOutgoingMessagePayload();
-	microapp_sdk_ble_t* bleRequest                    = (microapp_sdk_ble_t*)(payload);
-	bleRequest->header.messageType                    = CS_MICROAPP_SDK_TYPE_BLE;
-	bleRequest->header.ack                            = CS_MICROAPP_SDK_ACK_REQUEST;
-	bleRequest->type                                  = CS_MICROAPP_SDK_BLE_CENTRAL;
-	bleRequest->central.type                          = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_DISCOVER;
-	bleRequest->central.requestDiscover.uuidCount     = 1;
-	bleRequest->central.requestDiscover.uuids[0].type = uuid.getType();
-	bleRequest->central.requestDiscover.uuids[0].uuid = uuid.uuid16();
-	bleRequest->central.connectionHandle              = _connectionHandle;
+// Only defined for peripheral devices
+BleRequestToken BleDevice::discoverServiceAsync(const char* serviceUuid, BleRequestHandler handler) {
+	if (handler == nullptr) {
+		return BLE_REQUEST_TOKEN_NONE;
+	}
+	BleRequestToken token;
+	requestDiscover(serviceUuid, handler, token);
+	return token;
+}
 
-	sendMessage();
-	result = (microapp_sdk_result_t)bleRequest->header.ack;
-	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
-		// direct success
-		_asyncResult = BleAsyncNotWaiting;
-		return true;
+// Only defined for peripheral devices
+microapp_sdk_result_t BleDevice::requestDiscover(
+		const char* serviceUuid, BleRequestHandler handler, BleRequestToken& token) {
+	token = BLE_REQUEST_TOKEN_NONE;
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
 	}
-	if (result != CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
-		// direct failure
-		_asyncResult = BleAsyncNotWaiting;
-		return false;
+	BleRequestTable& requests = getBleRequestTable();
+	if (!_flags.discoveryDone) {
+		microapp_sdk_result_t result;
+		Uuid uuid(serviceUuid);
+		if (!uuid.registered()) {
+			result = uuid.registerCustom();
+			if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+				return result;
+			}
+		}
+		microapp_sdk_ble_uuid_t discoverUuid;
+		discoverUuid.type = uuid.getType();
+		discoverUuid.uuid = uuid.uuid16();
+		if (!_flags.connected || !discoverCachedService(discoverUuid)) {
+			// Sent after the requests that were queued before it
+			return requests.queueDiscover(_connectionHandle, discoverUuid, handler, token);
+		}
 	}
-	return waitForAsyncResult(timeout);
+	// already discovered, or restored from the attribute cache
+	token = requests.add(BleRequestDiscover, 0, handler);
+	if (token == BLE_REQUEST_TOKEN_NONE) {
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	requests.completeLater(token, CS_MICROAPP_SDK_ACK_SUCCESS);
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
 }
 
 // Only defined for peripheral devices
@@ -346,66 +349,147 @@ bool BleDevice::hasLocalName() {
 	if (!_flags.initialized || !_flags.isPeripheral) {
 		return false;
 	}
-	return (BleScan::localName(_scanData, _scanSize).len != 0);
+	return (BleScan::localName(_scanData, _scanIndex).len != 0);
 }
 
 // Only defined for peripheral devices
-String BleDevice::localName() {
+LocalNameString BleDevice::localName() {
 	if (!_flags.initialized || !_flags.isPeripheral) {
-		return String(nullptr);
+		return LocalNameString();
 	}
-	ble_ad_t localName = BleScan::localName(_scanData, _scanSize);
-	if (localName.len == 0) {
-		return String(nullptr);
-	}
-	static char localNameString[MAX_BLE_ADV_DATA_LENGTH + 1];
-	memcpy(localNameString, localName.data, localName.len);
-	localNameString[localName.len] = 0;
-	return String(localNameString);
+	ble_ad_t localName = BleScan::localName(_scanData, _scanIndex);
+	return LocalNameString(reinterpret_cast<const char*>(localName.data), localName.len);
 }
 
 bool BleDevice::hasAdvertisedServiceUuid() {
 	if (!_flags.initialized || !_flags.isPeripheral) {
 		return false;
 	}
-	return BleScan::hasServiceUuid(_scanData, _scanSize);
+	return BleScan::hasServiceUuid(_scanData, _scanIndex);
 }
 
 uint8_t BleDevice::advertisedServiceUuidCount() {
 	if (!_flags.initialized || !_flags.isPeripheral) {
 		return false;
 	}
-	return BleScan::serviceUuidCount(_scanData, _scanSize);
+	return BleScan::serviceUuidCount(_scanData, _scanIndex);
+}
+
+UuidString BleDevice::advertisedServiceUuid(uint8_t index) {
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return UuidString();
+	}
+	Uuid uuid = Uuid(BleScan::serviceUuid(_scanData, _scanIndex, index), CS_MICROAPP_SDK_BLE_UUID_STANDARD);
+	return uuid.string();
+}
+
+bool BleDevice::hasManufacturerData() {
+	return (manufacturerDataLength() != 0);
 }
 
-String BleDevice::advertisedServiceUuid(uint8_t index) {
+uint8_t BleDevice::manufacturerDataLength() {
 	if (!_flags.initialized || !_flags.isPeripheral) {
-		return String(nullptr);
+		return 0;
 	}
-	Uuid uuid = Uuid(BleScan::serviceUuid(_scanData, _scanSize, index), CS_MICROAPP_SDK_BLE_UUID_STANDARD);
-	return String(uuid.string());
+	return BleScan::manufacturerData(_scanData, _scanIndex).len;
+}
+
+uint8_t BleDevice::manufacturerData(uint8_t value[], uint8_t length) {
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return 0;
+	}
+	ble_ad_t ad = BleScan::manufacturerData(_scanData, _scanIndex);
+	if (length > ad.len) {
+		length = ad.len;
+	}
+	memcpy(value, ad.data, length);
+	return length;
+}
+
+bool BleDevice::hasServiceData() {
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return false;
+	}
+	return (BleScan::serviceData(_scanData, _scanIndex).data != nullptr);
+}
+
+UuidString BleDevice::serviceDataUuid() {
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return UuidString();
+	}
+	ble_ad_t ad = BleScan::serviceData(_scanData, _scanIndex);
+	if (ad.data == nullptr) {
+		return UuidString();
+	}
+	Uuid uuid(ad.data, BleScan::serviceDataUuidLength(ad));
+	return uuid.string();
+}
+
+uint8_t BleDevice::serviceDataLength() {
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return 0;
+	}
+	ble_ad_t ad = BleScan::serviceData(_scanData, _scanIndex);
+	return ad.len - BleScan::serviceDataUuidLength(ad);
+}
+
+uint8_t BleDevice::serviceData(uint8_t value[], uint8_t length) {
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return 0;
+	}
+	ble_ad_t ad        = BleScan::serviceData(_scanData, _scanIndex);
+	uint8_t uuidLength = BleScan::serviceDataUuidLength(ad);
+	if (length > ad.len - uuidLength) {
+		length = ad.len - uuidLength;
+	}
+	memcpy(value, ad.data + uuidLength, length);
+	return length;
 }
 
 // Only defined for peripheral devices
 bool BleDevice::connect(uint32_t timeout) {
-	if (!_flags.initialized || !_flags.isPeripheral) {
+	BleRequestToken token;
+	microapp_sdk_result_t result = requestConnect(nullptr, token);
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 		return false;
 	}
+	return (getBleRequestTable().wait(token, timeout) == CS_MICROAPP_SDK_ACK_SUCCESS);
+}
+
+// Only defined for peripheral devices
+BleRequestToken BleDevice::connectAsync(BleRequestHandler handler) {
+	if (handler == nullptr) {
+		return BLE_REQUEST_TOKEN_NONE;
+	}
+	BleRequestToken token;
+	requestConnect(handler, token);
+	return token;
+}
+
+// Only defined for peripheral devices
+microapp_sdk_result_t BleDevice::requestConnect(BleRequestHandler handler, BleRequestToken& token) {
+	token = BLE_REQUEST_TOKEN_NONE;
+	if (!_flags.initialized || !_flags.isPeripheral) {
+		return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+	}
+	BleRequestTable& requests = getBleRequestTable();
 	if (_flags.connected) {
 		// already connected
-		return true;
+		token = requests.add(BleRequestConnect, 0, handler);
+		if (token == BLE_REQUEST_TOKEN_NONE) {
+			return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+		}
+		requests.completeLater(token, CS_MICROAPP_SDK_ACK_SUCCESS);
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
 	}
 	microapp_sdk_result_t result;
 	// First register interrupts
 	if (!registeredBleInterrupt(CS_MICROAPP_SDK_BLE_CENTRAL)) {
 		result = registerBleInterrupt(CS_MICROAPP_SDK_BLE_CENTRAL);
 		if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
-			return false;
+			return result;
 		}
 	}
-	// Indicate we are waiting for an async event with a result
-	// This has to be set before the sendMessage call
-	_asyncResult = BleAsyncWaiting;
 
 	// Next, request connect
 	uint8_t* payload                                = getOutgoingMessagePayload();
@@ -418,18 +502,7 @@ bool BleDevice::connect(uint32_t timeout) {
 	bleRequest->central.requestConnect.address.type = _address.type();
 	memcpy(bleRequest->central.requestConnect.address.address, _address.bytes(), MAC_ADDRESS_LENGTH);
 
-	sendMessage();
-	result = (microapp_sdk_result_t)bleRequest->header.ack;
-	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
-		// direct success
-		_asyncResult = BleAsyncNotWaiting;
-		return true;
-	}
-	if (result != CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
-		_asyncResult = BleAsyncNotWaiting;
-		return false;
-	}
-	return waitForAsyncResult(timeout);
+	return requests.send(BleRequestConnect, 0, handler, token);
 }
 
 // Only defined for peripheral devices
@@ -437,6 +510,9 @@ bool BleDevice::findAdvertisementDataType(GapAdvType type, ble_ad_t* foundData)
 	if (!_flags.initialized || !_flags.isPeripheral) {
 		return false;
 	}
+	if (BleScanIndex::indexed(type)) {
+		return _scanIndex.find(_scanData, type, foundData);
+	}
 	return BleScan::findAdvertisementDataType(_scanData, _scanSize, type, foundData);
 }
 
@@ -48,13 +48,13 @@ bool MacAddress::convertStringToMac(const char* addressString, uint8_t* emptyAdd
 	return true;
 }
 
-const char* MacAddress::string() {
+MacAddressString MacAddress::string() {
 	if (!_initialized) {
-		return nullptr;
+		return MacAddressString();
 	}
-	static char addressString[MAC_ADDRESS_STRING_LENGTH + 1];
+	char addressString[MAC_ADDRESS_STRING_LENGTH + 1];
 	convertMacToString(_address, addressString);
-	return addressString;
+	return MacAddressString(addressString, MAC_ADDRESS_STRING_LENGTH);
 }
 
 const uint8_t* MacAddress::bytes() {
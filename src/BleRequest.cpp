@@ -0,0 +1,412 @@
+#include <Arduino.h>
+#include <BleCharacteristic.h>
+#include <BleRequest.h>
+
+BleRequestTable::Request* BleRequestTable::get(BleRequestToken token) {
+	if (token == BLE_REQUEST_TOKEN_NONE) {
+		return nullptr;
+	}
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		if (_requests[i].token == token) {
+			return &_requests[i];
+		}
+	}
+	return nullptr;
+}
+
+BleRequestTable::Request* BleRequestTable::allocate(BleRequestType type, uint16_t handle, BleRequestHandler handler) {
+	Request* request = nullptr;
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		if (_requests[i].token == BLE_REQUEST_TOKEN_NONE) {
+			request = &_requests[i];
+			break;
+		}
+	}
+	if (request == nullptr) {
+		return nullptr;
+	}
+	// Tokens are not reused while a request with that token waits.
+	do {
+		_lastToken++;
+	} while (_lastToken == BLE_REQUEST_TOKEN_NONE || get(_lastToken) != nullptr);
+
+	request->token          = _lastToken;
+	request->type           = type;
+	request->state          = REQUEST_QUEUED;
+	request->handle         = handle;
+	request->buffer         = nullptr;
+	request->length         = 0;
+	request->readOffset     = 0;
+	request->characteristic = nullptr;
+	request->handler        = handler;
+	return request;
+}
+
+BleRequestToken BleRequestTable::add(BleRequestType type, uint16_t handle, BleRequestHandler handler) {
+	Request* request = allocate(type, handle, handler);
+	return (request == nullptr) ? BLE_REQUEST_TOKEN_NONE : request->token;
+}
+
+microapp_sdk_result_t BleRequestTable::send(
+		BleRequestType type, uint16_t handle, BleRequestHandler handler, BleRequestToken& token) {
+	// The request has to be added before the sendMessage call, as the event with the result may come in meanwhile.
+	Request* request = allocate(type, handle, handler);
+	if (request == nullptr) {
+		token = BLE_REQUEST_TOKEN_NONE;
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	token                         = request->token;
+	request->state                = REQUEST_SENT;
+	microapp_sdk_header_t* header = (microapp_sdk_header_t*)getOutgoingMessagePayload();
+	sendMessage();
+	microapp_sdk_result_t result = (microapp_sdk_result_t)header->ack;
+	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
+		// direct success
+		completeLater(token, result);
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	if (result != CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
+		remove(token);
+		token = BLE_REQUEST_TOKEN_NONE;
+		return result;
+	}
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+microapp_sdk_result_t BleRequestTable::queueDiscover(
+		uint16_t connectionHandle, microapp_sdk_ble_uuid_t uuid, BleRequestHandler handler, BleRequestToken& token) {
+	Request* request = allocate(BleRequestDiscover, 0, handler);
+	if (request == nullptr) {
+		token = BLE_REQUEST_TOKEN_NONE;
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	request->connectionHandle = connectionHandle;
+	request->uuid             = uuid;
+	return queue(*request, token);
+}
+
+microapp_sdk_result_t BleRequestTable::queueRead(uint16_t connectionHandle, uint16_t handle,
+		BleCharacteristic* characteristic, uint8_t* buffer, uint16_t length, BleRequestHandler handler,
+		BleRequestToken& token) {
+	Request* request = allocate(BleRequestRead, handle, handler);
+	if (request == nullptr) {
+		token = BLE_REQUEST_TOKEN_NONE;
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	request->connectionHandle = connectionHandle;
+	request->characteristic   = characteristic;
+	request->buffer           = buffer;
+	request->length           = length;
+	return queue(*request, token);
+}
+
+microapp_sdk_result_t BleRequestTable::queueWrite(uint16_t connectionHandle, uint16_t handle, uint8_t* buffer,
+		uint16_t length, BleRequestHandler handler, BleRequestToken& token) {
+	Request* request = allocate(BleRequestWrite, handle, handler);
+	if (request == nullptr) {
+		token = BLE_REQUEST_TOKEN_NONE;
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	request->connectionHandle = connectionHandle;
+	request->buffer           = buffer;
+	request->length           = length;
+	return queue(*request, token);
+}
+
+microapp_sdk_result_t BleRequestTable::queue(Request& request, BleRequestToken& token) {
+	token = request.token;
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		if (_requests[i].token != BLE_REQUEST_TOKEN_NONE && _requests[i].state == REQUEST_SENT) {
+			// Sent when the request in progress completes.
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+	}
+	microapp_sdk_result_t result = sendQueued(request);
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		remove(token);
+		token = BLE_REQUEST_TOKEN_NONE;
+	}
+	return result;
+}
+
+microapp_sdk_result_t BleRequestTable::sendQueued(Request& request) {
+	uint8_t* payload                     = getOutgoingMessagePayload();
+	microapp_sdk_ble_t* bleRequest       = (microapp_sdk_ble_t*)(payload);
+	bleRequest->header.messageType       = CS_MICROAPP_SDK_TYPE_BLE;
+	bleRequest->header.ack               = CS_MICROAPP_SDK_ACK_REQUEST;
+	bleRequest->type                     = CS_MICROAPP_SDK_BLE_CENTRAL;
+	bleRequest->central.connectionHandle = request.connectionHandle;
+	switch (request.type) {
+		case BleRequestDiscover: {
+			bleRequest->central.type                      = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_DISCOVER;
+			bleRequest->central.requestDiscover.uuidCount = 1;
+			bleRequest->central.requestDiscover.uuids[0]  = request.uuid;
+			break;
+		}
+		case BleRequestRead: {
+			bleRequest->central.type                    = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_READ;
+			bleRequest->central.requestRead.valueHandle = request.handle;
+			break;
+		}
+		case BleRequestWrite: {
+			bleRequest->central.type                = CS_MICROAPP_SDK_BLE_CENTRAL_REQUEST_WRITE;
+			bleRequest->central.requestWrite.handle = request.handle;
+			bleRequest->central.requestWrite.buffer = request.buffer;
+			bleRequest->central.requestWrite.size   = request.length;
+			break;
+		}
+		default: {
+			return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+		}
+	}
+	// Set before the sendMessage call, as the event with the result may come in meanwhile.
+	request.state         = REQUEST_SENT;
+	BleRequestToken token = request.token;
+	sendMessage();
+	microapp_sdk_result_t result = (microapp_sdk_result_t)bleRequest->header.ack;
+	if (result == CS_MICROAPP_SDK_ACK_SUCCESS) {
+		// direct success
+		completeLater(token, result);
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	if (result == CS_MICROAPP_SDK_ACK_IN_PROGRESS) {
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	// Still busy with a request that is no longer waited for: try again when its event comes in.
+	Request* pending = get(token);
+	if (pending != nullptr && pending->state == REQUEST_SENT) {
+		pending->state = REQUEST_QUEUED;
+	}
+	if (result == CS_MICROAPP_SDK_ACK_ERR_BUSY) {
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	return result;
+}
+
+void BleRequestTable::sendNext() {
+	Request* next = nullptr;
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		Request& request = _requests[i];
+		if (request.token == BLE_REQUEST_TOKEN_NONE) {
+			continue;
+		}
+		if (request.state == REQUEST_SENT) {
+			return;
+		}
+		// Tokens wrap around, so compare the distance to the last token.
+		if (request.state == REQUEST_QUEUED
+			&& (next == nullptr || (uint8_t)(_lastToken - request.token) > (uint8_t)(_lastToken - next->token))) {
+			next = &request;
+		}
+	}
+	if (next == nullptr) {
+		return;
+	}
+	microapp_sdk_result_t result = sendQueued(*next);
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		// Completing it sends the request after it.
+		complete(next->token, result);
+	}
+}
+
+BleRequestToken BleRequestTable::find(BleRequestType type, uint16_t handle) {
+	Request* oldest = nullptr;
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		Request& request = _requests[i];
+		if (request.token == BLE_REQUEST_TOKEN_NONE || request.state != REQUEST_SENT || request.type != type
+			|| request.handle != handle) {
+			continue;
+		}
+		// Tokens wrap around, so compare the distance to the last token.
+		if (oldest == nullptr
+			|| (uint8_t)(_lastToken - request.token) > (uint8_t)(_lastToken - oldest->token)) {
+			oldest = &request;
+		}
+	}
+	return (oldest == nullptr) ? BLE_REQUEST_TOKEN_NONE : oldest->token;
+}
+
+bool BleRequestTable::addReadData(BleRequestToken token, microapp_sdk_ble_central_event_read_t* eventRead) {
+	Request* request = get(token);
+	if (request == nullptr || request->buffer == nullptr) {
+		return eventRead->size < sizeof(eventRead->data);
+	}
+	uint16_t offset = eventRead->offset;
+	if (offset != request->readOffset) {
+		// The rest of a read that completed already, for example after a timeout.
+		return false;
+	}
+	request->readOffset += eventRead->size;
+	request->readPartMs = millis();
+	if (offset < request->length) {
+		uint16_t size = eventRead->size;
+		if (size > request->length - offset) {
+			size = request->length - offset;
+		}
+		memcpy(request->buffer + offset, eventRead->data, size);
+	}
+	return eventRead->size < sizeof(eventRead->data);
+}
+
+microapp_sdk_result_t BleRequestTable::completeRead(BleRequestToken token) {
+	Request* request = get(token);
+	if (request == nullptr) {
+		// No longer waited for.
+		complete(token, CS_MICROAPP_SDK_ACK_SUCCESS);
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	// Data that did not fit in the buffer is dropped.
+	uint16_t length = (request->readOffset < request->length) ? request->readOffset : request->length;
+	microapp_sdk_result_t result = request->characteristic->onRemoteRead(request->buffer, length);
+	complete(token, result);
+	return result;
+}
+
+void BleRequestTable::completeStalledReads() {
+	uint32_t nowMs = millis();
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		Request& request = _requests[i];
+		// A read waits for a next part once it got a part.
+		if (request.token == BLE_REQUEST_TOKEN_NONE || request.state != REQUEST_SENT || request.type != BleRequestRead
+			|| request.readOffset == 0 || nowMs - request.readPartMs < BLE_READ_PART_TIMEOUT_MS) {
+			continue;
+		}
+		// Only one request is sent at a time. Completing it sends the next one.
+		completeRead(request.token);
+		return;
+	}
+}
+
+void BleRequestTable::complete(BleRequestToken token, microapp_sdk_result_t result) {
+	Request* request = get(token);
+	if (request == nullptr) {
+		// The event of a request that is no longer waited for: bluenet can handle the next request.
+		sendNext();
+		return;
+	}
+	if (request->state == REQUEST_DONE || request->state == REQUEST_DEFERRED) {
+		return;
+	}
+	if (request->handler == nullptr) {
+		// Picked up by wait().
+		request->state  = REQUEST_DONE;
+		request->result = result;
+		sendNext();
+		return;
+	}
+	// Free the entry first, so that the handler can send a new request.
+	BleRequestHandler handler = request->handler;
+	request->token            = BLE_REQUEST_TOKEN_NONE;
+	sendNext();
+	handler(token, result);
+}
+
+void BleRequestTable::completeLater(BleRequestToken token, microapp_sdk_result_t result) {
+	Request* request = get(token);
+	if (request == nullptr || request->handler == nullptr) {
+		complete(token, result);
+		return;
+	}
+	if (request->state == REQUEST_DONE || request->state == REQUEST_DEFERRED) {
+		return;
+	}
+	request->state  = REQUEST_DEFERRED;
+	request->result = result;
+	_hasDeferred    = true;
+	sendNext();
+}
+
+void BleRequestTable::completeDeferred() {
+	if (!_hasDeferred) {
+		return;
+	}
+	_hasDeferred = false;
+	// Handlers may add new requests: those are completed next time.
+	BleRequestToken tokens[BLE_MAX_PENDING_REQUESTS];
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		tokens[i] = (_requests[i].state == REQUEST_DEFERRED) ? _requests[i].token : BLE_REQUEST_TOKEN_NONE;
+	}
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		Request* request = get(tokens[i]);
+		if (request == nullptr || request->state != REQUEST_DEFERRED) {
+			// Removed by a handler meanwhile.
+			continue;
+		}
+		// Free the entry first, so that the handler can send a new request.
+		BleRequestHandler handler    = request->handler;
+		microapp_sdk_result_t result = request->result;
+		request->token               = BLE_REQUEST_TOKEN_NONE;
+		handler(tokens[i], result);
+	}
+}
+
+void BleRequestTable::completeAll(microapp_sdk_result_t result) {
+	// Handlers may add new requests: those are not completed.
+	// The queued requests go first, so that they are not sent when the request in progress completes.
+	BleRequestToken tokens[BLE_MAX_PENDING_REQUESTS];
+	uint8_t count = 0;
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		if (_requests[i].token != BLE_REQUEST_TOKEN_NONE && _requests[i].state == REQUEST_QUEUED) {
+			tokens[count++] = _requests[i].token;
+		}
+	}
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		if (_requests[i].token != BLE_REQUEST_TOKEN_NONE && _requests[i].state != REQUEST_QUEUED) {
+			tokens[count++] = _requests[i].token;
+		}
+	}
+	for (uint8_t i = 0; i < count; ++i) {
+		complete(tokens[i], result);
+	}
+}
+
+microapp_sdk_result_t BleRequestTable::wait(BleRequestToken token, uint32_t timeout) {
+	uint32_t startMs = millis();
+	Request* request = get(token);
+	while (request != nullptr && request->state != REQUEST_DONE) {
+		if (millis() - startMs >= timeout) {
+			remove(token);
+			return CS_MICROAPP_SDK_ACK_ERR_TIMEOUT;
+		}
+		// Yield. Upon an event from bluenet the request completes.
+		delay(MICROAPP_LOOP_INTERVAL_MS);
+		completeStalledReads();
+		request = get(token);
+	}
+	if (request == nullptr) {
+		return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
+	}
+	microapp_sdk_result_t result = request->result;
+	request->token               = BLE_REQUEST_TOKEN_NONE;
+	return result;
+}
+
+bool BleRequestTable::pending(BleRequestToken token) {
+	Request* request = get(token);
+	return request != nullptr && request->state != REQUEST_DONE;
+}
+
+void BleRequestTable::remove(BleRequestToken token) {
+	Request* request = get(token);
+	if (request == nullptr) {
+		return;
+	}
+	bool sent      = (request->state == REQUEST_SENT);
+	request->token = BLE_REQUEST_TOKEN_NONE;
+	if (sent) {
+		// Bluenet may still be busy with it, then the next request is sent when its event comes in.
+		sendNext();
+	}
+}
+
+void BleRequestTable::clear() {
+	for (uint8_t i = 0; i < BLE_MAX_PENDING_REQUESTS; ++i) {
+		_requests[i].token = BLE_REQUEST_TOKEN_NONE;
+	}
+}
+
+BleRequestTable& getBleRequestTable() {
+	// Not part of the BLE class, so that completeDeferred() can be called at the end of every loop without it.
+	static BleRequestTable table;
+	return table;
+}
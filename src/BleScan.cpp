@@ -1,11 +1,70 @@
 #include <BleScan.h>
 
-ble_ad_t BleScan::localName(const uint8_t* scanData, uint8_t scanSize) {
+BleScanIndex::BleScanIndex(const uint8_t* scanData, uint8_t scanSize) {
+	build(scanData, scanSize);
+}
+
+int8_t BleScanIndex::getSlot(uint8_t type) {
+	switch (type) {
+		case GapAdvType::Flags:
+		case GapAdvType::IncompleteList16BitServiceUuids:
+		case GapAdvType::CompleteList16BitServiceUuids:
+		case GapAdvType::IncompleteList32BitServiceUuids:
+		case GapAdvType::CompleteList32BitServiceUuids:
+		case GapAdvType::IncompleteList128BitServiceUuids:
+		case GapAdvType::CompleteList128BitServiceUuids:
+		case GapAdvType::ShortenedLocalName:
+		case GapAdvType::CompleteLocalName: return type - GapAdvType::Flags;
+		case GapAdvType::ServiceData16BitUuid: return 9;
+		case GapAdvType::ServiceData32BitUuid: return 10;
+		case GapAdvType::ServiceData128BitUuid: return 11;
+		case GapAdvType::ManufacturerSpecificData: return 12;
+		default: return -1;
+	}
+}
+
+void BleScanIndex::build(const uint8_t* scanData, uint8_t scanSize) {
+	memset(_offsets, 0, sizeof(_offsets));
+	uint8_t i = 0;
+	while (i + 1 < scanSize) {
+		uint8_t fieldLen  = scanData[i];
+		uint8_t fieldType = scanData[i + 1];
+		if (fieldLen == 0 || i + 1 + fieldLen > scanSize) {
+			return;
+		}
+		int8_t slot = getSlot(fieldType);
+		if (slot >= 0 && _offsets[slot] == 0) {
+			_offsets[slot] = i + 1;
+		}
+		i += fieldLen + 1;
+	}
+}
+
+bool BleScanIndex::indexed(GapAdvType type) {
+	return (getSlot(type) >= 0);
+}
+
+bool BleScanIndex::find(const uint8_t* scanData, GapAdvType type, ble_ad_t* foundData) const {
+	foundData->type = 0;
+	foundData->data = nullptr;
+	foundData->len  = 0;
+	int8_t slot     = getSlot(type);
+	if (slot < 0 || _offsets[slot] == 0) {
+		return false;
+	}
+	uint8_t i       = _offsets[slot] - 1;
+	foundData->data = &scanData[i + 2];
+	foundData->len  = scanData[i] - 1;
+	foundData->type = (uint8_t)type;
+	return true;
+}
+
+ble_ad_t BleScan::localName(const uint8_t* scanData, const BleScanIndex& index) {
 	ble_ad_t localName;
-	if (findAdvertisementDataType(scanData, scanSize, GapAdvType::CompleteLocalName, &localName)) {
+	if (index.find(scanData, GapAdvType::CompleteLocalName, &localName)) {
 		return localName; // filled
 	}
-	else if (findAdvertisementDataType(scanData, scanSize, GapAdvType::ShortenedLocalName, &localName)) {
+	else if (index.find(scanData, GapAdvType::ShortenedLocalName, &localName)) {
 		return localName; // filled
 	}
 	else {
@@ -13,6 +72,10 @@ ble_ad_t BleScan::localName(const uint8_t* scanData, uint8_t scanSize) {
 	}
 }
 
+ble_ad_t BleScan::localName(const uint8_t* scanData, uint8_t scanSize) {
+	return localName(scanData, BleScanIndex(scanData, scanSize));
+}
+
 bool BleScan::findAdvertisementDataType(const uint8_t* scanData, uint8_t scanSize, GapAdvType type, ble_ad_t* foundData) {
 	uint8_t i       = 0;
 	foundData->type = 0;
@@ -35,20 +98,20 @@ bool BleScan::findAdvertisementDataType(const uint8_t* scanData, uint8_t scanSiz
 	return false;
 }
 
-bool BleScan::hasServiceUuid(const uint8_t* scanData, uint8_t scanSize, uuid16_t uuid) {
+bool BleScan::hasServiceUuid(const uint8_t* scanData, const BleScanIndex& index, uuid16_t uuid) {
 	GapAdvType serviceUuidListTypes[2] = {
 			GapAdvType::IncompleteList16BitServiceUuids,
 			GapAdvType::CompleteList16BitServiceUuids};
 	ble_ad_t ad;
 	for (uint8_t i = 0; i < sizeof(serviceUuidListTypes) / sizeof(serviceUuidListTypes[0]); i++) {
-		if (findAdvertisementDataType(scanData, scanSize, serviceUuidListTypes[i], &ad)) {
+		if (index.find(scanData, serviceUuidListTypes[i], &ad)) {
 			// uuid == 0 means any uuid
 			if (uuid == 0 && ad.len >= sizeof(uuid)) {
 				return true;
 			}
 			// check ad for uuid
 			uuid16_t scanUuid;
-			for (uint8_t j = 0; j < ad.len; j += sizeof(uuid)) {
+			for (uint8_t j = 0; j + 1 < ad.len; j += sizeof(uuid)) {
 				scanUuid = ((ad.data[j + 1] << 8) | ad.data[j]);
 				if (uuid == scanUuid) {
 					return true;
@@ -59,35 +122,79 @@ bool BleScan::hasServiceUuid(const uint8_t* scanData, uint8_t scanSize, uuid16_t
 	return false;
 }
 
-uint8_t BleScan::serviceUuidCount(const uint8_t* scanData, uint8_t scanSize) {
+bool BleScan::hasServiceUuid(const uint8_t* scanData, uint8_t scanSize, uuid16_t uuid) {
+	return hasServiceUuid(scanData, BleScanIndex(scanData, scanSize), uuid);
+}
+
+uint8_t BleScan::serviceUuidCount(const uint8_t* scanData, const BleScanIndex& index) {
 	GapAdvType serviceUuidListTypes[2] = {
 			GapAdvType::IncompleteList16BitServiceUuids,
 			GapAdvType::CompleteList16BitServiceUuids};
 	ble_ad_t ad;
 	uint8_t count = 0;
 	for (uint8_t i = 0; i < sizeof(serviceUuidListTypes) / sizeof(serviceUuidListTypes[0]); i++) {
-		if (findAdvertisementDataType(scanData, scanSize, serviceUuidListTypes[i], &ad)) {
+		if (index.find(scanData, serviceUuidListTypes[i], &ad)) {
 			count += ad.len / UUID_16BIT_BYTE_LENGTH;
 		}
 	}
 	return count;
 }
 
-uuid16_t BleScan::serviceUuid(const uint8_t* scanData, uint8_t scanSize, uint8_t index) {
+uint8_t BleScan::serviceUuidCount(const uint8_t* scanData, uint8_t scanSize) {
+	return serviceUuidCount(scanData, BleScanIndex(scanData, scanSize));
+}
+
+uuid16_t BleScan::serviceUuid(const uint8_t* scanData, const BleScanIndex& index, uint8_t uuidIndex) {
 	GapAdvType serviceUuidListTypes[2] = {
 			GapAdvType::IncompleteList16BitServiceUuids,
 			GapAdvType::CompleteList16BitServiceUuids};
 	ble_ad_t ad;
-	uint8_t count = 0;
 	for (uint8_t i = 0; i < sizeof(serviceUuidListTypes) / sizeof(serviceUuidListTypes[0]); i++) {
-		if (findAdvertisementDataType(scanData, scanSize, serviceUuidListTypes[i], &ad)) {
-			for (uint8_t j = 0; j < ad.len; j += 2) {
-				if (count == index) {
-					return ((ad.data[j + 1] << 8) | ad.data[j]);
-				}
-				count++;
+		if (index.find(scanData, serviceUuidListTypes[i], &ad)) {
+			uint8_t count = ad.len / UUID_16BIT_BYTE_LENGTH;
+			if (uuidIndex < count) {
+				uint8_t j = uuidIndex * UUID_16BIT_BYTE_LENGTH;
+				return ((ad.data[j + 1] << 8) | ad.data[j]);
 			}
+			uuidIndex -= count;
 		}
 	}
 	return 0;
 }
+
+uuid16_t BleScan::serviceUuid(const uint8_t* scanData, uint8_t scanSize, uint8_t uuidIndex) {
+	return serviceUuid(scanData, BleScanIndex(scanData, scanSize), uuidIndex);
+}
+
+ble_ad_t BleScan::manufacturerData(const uint8_t* scanData, const BleScanIndex& index) {
+	ble_ad_t manufacturerData;
+	index.find(scanData, GapAdvType::ManufacturerSpecificData, &manufacturerData);
+	return manufacturerData;
+}
+
+ble_ad_t BleScan::serviceData(const uint8_t* scanData, const BleScanIndex& index, uint8_t uuidLength) {
+	GapAdvType serviceDataTypes[3] = {
+			GapAdvType::ServiceData16BitUuid,
+			GapAdvType::ServiceData32BitUuid,
+			GapAdvType::ServiceData128BitUuid};
+	ble_ad_t ad;
+	for (uint8_t i = 0; i < sizeof(serviceDataTypes) / sizeof(serviceDataTypes[0]); i++) {
+		ad.type = serviceDataTypes[i];
+		if (uuidLength != 0 && uuidLength != serviceDataUuidLength(ad)) {
+			continue;
+		}
+		if (index.find(scanData, serviceDataTypes[i], &ad) && ad.len >= serviceDataUuidLength(ad)) {
+			return ad;
+		}
+	}
+	return ble_ad_t();
+}
+
+uint8_t BleScan::serviceDataUuidLength(const ble_ad_t& serviceData) {
+	switch (serviceData.type) {
+		case GapAdvType::ServiceData16BitUuid: return UUID_16BIT_BYTE_LENGTH;
+		case GapAdvType::ServiceData32BitUuid: return UUID_32BIT_BYTE_LENGTH;
+		case GapAdvType::ServiceData128BitUuid: return UUID_128BIT_BYTE_LENGTH;
+		default: return 0;
+	}
+}
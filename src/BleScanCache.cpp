@@ -0,0 +1,69 @@
+#include <BleScanCache.h>
+
+BleScanCache::BleScanCache() {
+	setTimeToLive(BLE_SCAN_CACHE_DEFAULT_TTL_MS);
+}
+
+void BleScanCache::setTimeToLive(uint32_t timeToLiveMs) {
+	_timeToLiveTicks = (timeToLiveMs + MICROAPP_LOOP_INTERVAL_MS - 1) / MICROAPP_LOOP_INTERVAL_MS;
+}
+
+void BleScanCache::setRssiThreshold(uint8_t rssiThreshold) {
+	_rssiThreshold = rssiThreshold;
+}
+
+uint8_t BleScanCache::getIndex(const uint8_t* address) {
+	// Every byte of the address affects the lower bits, which are used as index.
+	uint8_t hash = 0;
+	for (uint8_t i = 0; i < MAC_ADDRESS_LENGTH; ++i) {
+		hash = hash * 31 + address[i];
+	}
+	return hash & (BLE_SCAN_CACHE_SIZE - 1);
+}
+
+bool BleScanCache::isDuplicate(const uint8_t* address, rssi_t rssi) {
+	uint32_t now       = getLoopTickCount();
+	uint8_t index      = getIndex(address);
+	Entry* replacement = nullptr;
+	for (uint8_t probe = 0; probe < MAX_PROBES; ++probe) {
+		Entry& entry = _entries[(index + probe) & (BLE_SCAN_CACHE_SIZE - 1)];
+		if (entry.used && memcmp(entry.address, address, MAC_ADDRESS_LENGTH) == 0) {
+			int16_t rssiChange = (int16_t)rssi - entry.rssi;
+			if (rssiChange < 0) {
+				rssiChange = -rssiChange;
+			}
+			bool expired     = (now - entry.reportedTick >= _timeToLiveTicks);
+			bool rssiChanged = (_rssiThreshold != 0 && rssiChange >= _rssiThreshold);
+			if (!expired && !rssiChanged) {
+				if (_duplicateCount < UINT16_MAX) {
+					_duplicateCount++;
+				}
+				return true;
+			}
+			entry.rssi         = rssi;
+			entry.reportedTick = now;
+			return false;
+		}
+		// Prefer an empty entry, otherwise the one that was reported longest ago.
+		if (replacement == nullptr || (replacement->used && !entry.used)
+			|| (replacement->used && now - entry.reportedTick > now - replacement->reportedTick)) {
+			replacement = &entry;
+		}
+	}
+	memcpy(replacement->address, address, MAC_ADDRESS_LENGTH);
+	replacement->used         = true;
+	replacement->rssi         = rssi;
+	replacement->reportedTick = now;
+	return false;
+}
+
+void BleScanCache::clear() {
+	for (uint8_t i = 0; i < BLE_SCAN_CACHE_SIZE; ++i) {
+		_entries[i].used = false;
+	}
+	_duplicateCount = 0;
+}
+
+uint16_t BleScanCache::duplicateCount() {
+	return _duplicateCount;
+}
@@ -0,0 +1,183 @@
+#include <BleScanFilter.h>
+
+microapp_sdk_result_t BleScanFilterChain::add(const ble_scan_filter_t& filter) {
+	if (_filterCount >= MAX_BLE_SCAN_FILTERS) {
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	_filters[_filterCount]          = filter;
+	_filters[_filterCount].hitCount = 0;
+	_filterCount++;
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+microapp_sdk_result_t BleScanFilterChain::addRssiFilter(rssi_t minRssi) {
+	ble_scan_filter_t filter;
+	filter.field   = BleScanFilterRssi;
+	filter.minRssi = minRssi;
+	return add(filter);
+}
+
+microapp_sdk_result_t BleScanFilterChain::addAddressFilter(const char* address) {
+	MacAddress mac(address);
+	if (!mac) {
+		return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
+	}
+	ble_scan_filter_t filter;
+	filter.field = BleScanFilterAddress;
+	memcpy(filter.address, mac.bytes(), MAC_ADDRESS_LENGTH);
+	return add(filter);
+}
+
+microapp_sdk_result_t BleScanFilterChain::addAdvertisementDataFilter(
+		GapAdvType type, const uint8_t* prefix, uint8_t prefixLength) {
+	if (prefixLength > MAX_BLE_SCAN_FILTER_PREFIX_LENGTH) {
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	ble_scan_filter_t filter;
+	filter.field  = BleScanFilterAdvertisementData;
+	filter.adType = type;
+	filter.length = prefixLength;
+	memcpy(filter.prefix, prefix, prefixLength);
+	return add(filter);
+}
+
+microapp_sdk_result_t BleScanFilterChain::addManufacturerDataFilter(
+		uint16_t companyId, const uint8_t* prefix, uint8_t prefixLength) {
+	// The company id is sent little endian, in front of the data.
+	uint8_t data[MAX_BLE_SCAN_FILTER_PREFIX_LENGTH];
+	if (prefixLength + sizeof(companyId) > sizeof(data)) {
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	data[0] = companyId & 0xFF;
+	data[1] = companyId >> 8;
+	memcpy(data + sizeof(companyId), prefix, prefixLength);
+	return addAdvertisementDataFilter(GapAdvType::ManufacturerSpecificData, data, prefixLength + sizeof(companyId));
+}
+
+microapp_sdk_result_t BleScanFilterChain::addServiceDataFilter(
+		uuid16_t uuid, const uint8_t* prefix, uint8_t prefixLength) {
+	// The uuid is sent little endian, in front of the data.
+	uint8_t data[MAX_BLE_SCAN_FILTER_PREFIX_LENGTH];
+	if (prefixLength + sizeof(uuid) > sizeof(data)) {
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	data[0] = uuid & 0xFF;
+	data[1] = uuid >> 8;
+	memcpy(data + sizeof(uuid), prefix, prefixLength);
+	return addAdvertisementDataFilter(GapAdvType::ServiceData16BitUuid, data, prefixLength + sizeof(uuid));
+}
+
+void BleScanFilterChain::clear() {
+	_filterCount   = 0;
+	_rejectedCount = 0;
+}
+
+bool BleScanFilterChain::sameField(const ble_scan_filter_t& filter, const ble_scan_filter_t& other) {
+	if (filter.field != other.field) {
+		return false;
+	}
+	return (filter.field != BleScanFilterAdvertisementData || filter.adType == other.adType);
+}
+
+bool BleScanFilterChain::matches(
+		const ble_scan_filter_t& filter,
+		const uint8_t* address,
+		rssi_t rssi,
+		const uint8_t* scanData,
+		uint8_t scanSize,
+		const BleScanIndex& scanIndex) {
+	switch (filter.field) {
+		case BleScanFilterRssi: {
+			return (rssi >= filter.minRssi);
+		}
+		case BleScanFilterAddress: {
+			return (memcmp(address, filter.address, MAC_ADDRESS_LENGTH) == 0);
+		}
+		case BleScanFilterAdvertisementData: {
+			ble_ad_t ad;
+			bool found;
+			if (BleScanIndex::indexed((GapAdvType)filter.adType)) {
+				found = scanIndex.find(scanData, (GapAdvType)filter.adType, &ad);
+			}
+			else {
+				found = BleScan::findAdvertisementDataType(scanData, scanSize, (GapAdvType)filter.adType, &ad);
+			}
+			if (!found) {
+				return false;
+			}
+			return (ad.len >= filter.length && memcmp(ad.data, filter.prefix, filter.length) == 0);
+		}
+		default: {
+			return false;
+		}
+	}
+}
+
+bool BleScanFilterChain::passes(const uint8_t* address, rssi_t rssi, const uint8_t* scanData, uint8_t scanSize) {
+	// The scan data is only indexed when there are advertisement data filters.
+	BleScanIndex scanIndex;
+	bool indexed = false;
+
+	// Evaluate the fields from cheap to expensive.
+	for (uint8_t field = BleScanFilterRssi; field <= BleScanFilterAdvertisementData; ++field) {
+		for (uint8_t i = 0; i < _filterCount; ++i) {
+			if (_filters[i].field != field) {
+				continue;
+			}
+			// Only evaluate the first filter of each group of filters that compare the same field.
+			bool firstOfGroup = true;
+			for (uint8_t j = 0; j < i; ++j) {
+				if (sameField(_filters[j], _filters[i])) {
+					firstOfGroup = false;
+					break;
+				}
+			}
+			if (!firstOfGroup) {
+				continue;
+			}
+			if (field == BleScanFilterAdvertisementData && !indexed) {
+				scanIndex.build(scanData, scanSize);
+				indexed = true;
+			}
+			bool groupMatched = false;
+			for (uint8_t j = i; j < _filterCount; ++j) {
+				if (sameField(_filters[j], _filters[i]) && matches(_filters[j], address, rssi, scanData, scanSize, scanIndex)) {
+					if (_filters[j].hitCount < UINT16_MAX) {
+						_filters[j].hitCount++;
+					}
+					groupMatched = true;
+					break;
+				}
+			}
+			if (!groupMatched) {
+				if (_rejectedCount < UINT16_MAX) {
+					_rejectedCount++;
+				}
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+uint8_t BleScanFilterChain::filterCount() {
+	return _filterCount;
+}
+
+uint16_t BleScanFilterChain::hitCount(uint8_t index) {
+	if (index >= _filterCount) {
+		return 0;
+	}
+	return _filters[index].hitCount;
+}
+
+uint16_t BleScanFilterChain::rejectedCount() {
+	return _rejectedCount;
+}
+
+void BleScanFilterChain::resetCounters() {
+	for (uint8_t i = 0; i < _filterCount; ++i) {
+		_filters[i].hitCount = 0;
+	}
+	_rejectedCount = 0;
+}
@@ -103,11 +103,11 @@ microapp_sdk_result_t BleService::addDiscoveredCharacteristic(BleCharacteristic*
 	return CS_MICROAPP_SDK_ACK_SUCCESS;
 }
 
-String BleService::uuid() {
+UuidString BleService::uuid() {
 	if (!_flags.initialized) {
-		return String(nullptr);
+		return UuidString();
 	}
-	return String(_uuid.string());
+	return _uuid.string();
 }
 
 // Only for local services
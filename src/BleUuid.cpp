@@ -32,6 +32,12 @@ Uuid::Uuid(const uint8_t* uuid, uint8_t length) {
 		_length = UUID_16BIT_BYTE_LENGTH;
 		_type = CS_MICROAPP_SDK_BLE_UUID_STANDARD;
 	}
+	else if (length == UUID_32BIT_BYTE_LENGTH) {
+		// 32-bit uuids use the same base uuid as 16-bit uuids
+		memcpy(_uuid, BASE_UUID_128BIT, UUID_128BIT_BYTE_LENGTH);
+		memcpy(_uuid + BASE_UUID_OFFSET_16BIT, uuid, length);
+		_length = UUID_128BIT_BYTE_LENGTH;
+	}
 	else {
 		return;
 	}
@@ -111,35 +117,35 @@ bool Uuid::valid() {
 	return _initialized;
 }
 
-const char* Uuid::string() {
+UuidString Uuid::string() {
 	if (!_initialized) {
-		return nullptr;
+		return UuidString();
 	}
 	if (_length == UUID_128BIT_BYTE_LENGTH) {
-		static char uuidString128[UUID_128BIT_STRING_LENGTH + 1];
+		char uuidString128[UUID_128BIT_STRING_LENGTH + 1];
 		convertUuid128BitToString(_uuid, uuidString128);
-		return uuidString128;
+		return UuidString(uuidString128, UUID_128BIT_STRING_LENGTH);
 	}
 	else if (_length == UUID_16BIT_BYTE_LENGTH) {
-		static char uuidString16[UUID_16BIT_STRING_LENGTH + 1];
+		char uuidString16[UUID_16BIT_STRING_LENGTH + 1];
 		convertUuid16BitToString(_uuid + BASE_UUID_OFFSET_16BIT, uuidString16);
-		return uuidString16;
+		return UuidString(uuidString16, UUID_16BIT_STRING_LENGTH);
 	}
 	else {
-		return nullptr;
+		return UuidString();
 	}
 }
 
-const char* Uuid::fullString() {
+UuidString Uuid::fullString() {
 	if (!_initialized) {
-		return nullptr;
+		return UuidString();
 	}
 	if (_length != UUID_128BIT_BYTE_LENGTH && _length != UUID_16BIT_BYTE_LENGTH) {
-		return nullptr;
+		return UuidString();
 	}
-	static char uuidString128[UUID_128BIT_STRING_LENGTH + 1];
+	char uuidString128[UUID_128BIT_STRING_LENGTH + 1];
 	convertUuid128BitToString(_uuid, uuidString128);
-	return uuidString128;
+	return UuidString(uuidString128, UUID_128BIT_STRING_LENGTH);
 }
 
 const uint8_t* Uuid::bytes() {
@@ -46,26 +46,26 @@ microapp_sdk_result_t MeshClass::handleIncomingMeshMsg(microapp_sdk_mesh_t* msg)
 		_registeredIncomingMeshMsgHandler(handlerMsg);
 		return CS_MICROAPP_SDK_ACK_SUCCESS;
 	}
-	// Add msg to buffer or discard if full
-	// Q: is it not more logical to discard oldest?
-	// that will lead to more memcpy calls however
-	bool full = true;
-	int i;
-	for (i = 0; i < MESH_MSG_BUFFER_LEN; i++) {
-		if (!_incomingMeshMsgBuffer[i].filled) {
-			full = false;
-			break;
+	// Add msg to buffer, or discard a message if full
+	MeshMsgBufferEntry* copy;
+	if (_dropPolicy == MeshDropOldest) {
+		copy = _incomingMeshMsgBuffer.reserveOverwrite();
+	}
+	else {
+		copy = _incomingMeshMsgBuffer.reserve();
+		if (copy == nullptr) {
+			return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
 		}
 	}
-	if (full) {
-		// discard message
-		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	uint8_t size = msg->size;
+	if (size > MAX_MICROAPP_MESH_PAYLOAD_SIZE) {
+		size = MAX_MICROAPP_MESH_PAYLOAD_SIZE;
 	}
-	MeshMsgBufferEntry& copy = _incomingMeshMsgBuffer[i];
-	copy.stoneId             = msg->stoneId;
-	copy.size                = msg->size;
-	memcpy(copy.data, msg->data, msg->size);
-	copy.filled = true;
+	copy->stoneId = msg->stoneId;
+	copy->size    = size;
+	memcpy(copy->data, msg->data, size);
+	copy->filled = true;
+	_incomingMeshMsgBuffer.commit();
 
 	return CS_MICROAPP_SDK_ACK_SUCCESS;
 }
@@ -74,32 +74,46 @@ void MeshClass::setIncomingMeshMsgHandler(void (*handler)(MeshMsg)) {
 	_registeredIncomingMeshMsgHandler = handler;
 }
 
+void MeshClass::setDropPolicy(MeshDropPolicy policy) {
+	_dropPolicy = policy;
+}
+
+uint16_t MeshClass::droppedCount() {
+	return _incomingMeshMsgBuffer.overflowCount();
+}
+
 bool MeshClass::available() {
-	for (int i = 0; i < MESH_MSG_BUFFER_LEN; i++) {
-		if (_incomingMeshMsgBuffer[i].filled) {
-			return true;
-		}
-	}
-	return false;
+	return !_incomingMeshMsgBuffer.empty();
 }
 
 void MeshClass::readMeshMsg(MeshMsg* msg) {
-	for (int i = MESH_MSG_BUFFER_LEN - 1; i >= 0; i--) {
-		if (_incomingMeshMsgBuffer[i].filled) {
-			// copy message data to another location where it can't be overwritten by incoming messages
-			// (do not check if _availableMeshMsg was already filled, just overwrite)
-			_availableMeshMsg.filled = true;
-			memcpy(_availableMeshMsg.data, _incomingMeshMsgBuffer[i].data, MAX_MICROAPP_MESH_PAYLOAD_SIZE);
-			// create a mesh message to return to the user
-			*msg = MeshMsg(_incomingMeshMsgBuffer[i].stoneId, _availableMeshMsg.data, _incomingMeshMsgBuffer[i].size);
-			// free the incoming buffer entry
-			_incomingMeshMsgBuffer[i].filled = false;
-			return;
-		}
+	MeshMsgBufferEntry* oldest = _incomingMeshMsgBuffer.front();
+	if (oldest == nullptr) {
+		return;
+	}
+	// copy message data to another location where it can't be overwritten by incoming messages
+	// (do not check if _availableMeshMsg was already filled, just overwrite)
+	_availableMeshMsg.filled = true;
+	memcpy(_availableMeshMsg.data, oldest->data, oldest->size);
+	// create a mesh message to return to the user
+	*msg = MeshMsg(oldest->stoneId, _availableMeshMsg.data, oldest->size);
+	// free the incoming buffer entry
+	_incomingMeshMsgBuffer.release();
+}
+
+microapp_sdk_result_t MeshClass::sendMeshMsg(uint8_t* msg, uint8_t msgSize, uint8_t stoneId, bool doNotRelay) {
+	if (interruptDepth() > 0) {
+		// Never wait for bluenet in an interrupt handler, not even when the queue is full.
+		return queueMeshMsg(msg, msgSize, stoneId, doNotRelay);
+	}
+	// Keep the order of messages
+	while (!_sendQueue.empty()) {
+		flushMeshMsgQueue();
 	}
+	return sendMeshMsgNow(msg, msgSize, stoneId, doNotRelay);
 }
 
-void MeshClass::sendMeshMsg(uint8_t* msg, uint8_t msgSize, uint8_t stoneId, bool doNotRelay) {
+microapp_sdk_result_t MeshClass::sendMeshMsgNow(const uint8_t* msg, uint8_t msgSize, uint8_t stoneId, bool doNotRelay) {
 	uint8_t* payload                 = getOutgoingMessagePayload();
 	microapp_sdk_mesh_t* meshRequest = reinterpret_cast<microapp_sdk_mesh_t*>(payload);
 	meshRequest->header.ack          = CS_MICROAPP_SDK_ACK_REQUEST;
@@ -115,7 +129,54 @@ void MeshClass::sendMeshMsg(uint8_t* msg, uint8_t msgSize, uint8_t stoneId, bool
 	meshRequest->size = msgSizeSent;
 	memcpy(meshRequest->data, msg, msgSizeSent);
 
-	sendMessage();
+	microapp_sdk_result_t result = sendMessage();
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		return result;
+	}
+	if (meshRequest->header.ack == CS_MICROAPP_SDK_ACK_REQUEST) {
+		// Added to a batch: a failure is returned by commitBatch()
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	return (microapp_sdk_result_t)meshRequest->header.ack;
+}
+
+microapp_sdk_result_t MeshClass::queueMeshMsg(const uint8_t* msg, uint8_t msgSize, uint8_t stoneId, bool doNotRelay) {
+	MeshSendQueueEntry* entry = _sendQueue.reserve();
+	if (entry == nullptr) {
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+	if (msgSize > MAX_MICROAPP_MESH_PAYLOAD_SIZE) {
+		msgSize = MAX_MICROAPP_MESH_PAYLOAD_SIZE;
+	}
+	entry->stoneId    = stoneId;
+	entry->doNotRelay = doNotRelay;
+	entry->size       = msgSize;
+	memcpy(entry->data, msg, msgSize);
+	_sendQueue.commit();
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+uint8_t MeshClass::queuedMeshMsgCount() {
+	return _sendQueue.size();
+}
+
+void MeshClass::flushMeshMsgQueue() {
+	if (_sendQueue.empty()) {
+		return;
+	}
+	// Send all messages in a single yield, if no batch has been started already
+	bool batched = (beginBatch() == CS_MICROAPP_SDK_ACK_SUCCESS);
+	for (uint8_t i = 0; i < MESH_SEND_QUEUE_FLUSH_LIMIT; ++i) {
+		MeshSendQueueEntry* entry = _sendQueue.front();
+		if (entry == nullptr) {
+			break;
+		}
+		sendMeshMsgNow(entry->data, entry->size, entry->stoneId, entry->doNotRelay);
+		_sendQueue.release();
+	}
+	if (batched) {
+		commitBatch();
+	}
 }
 
 short MeshClass::id() {
@@ -0,0 +1,221 @@
+#include <MeshTransport.h>
+
+const uint32_t MESH_TRANSPORT_TIMEOUT_TICKS =
+		(MESH_TRANSPORT_TIMEOUT_MS + MICROAPP_LOOP_INTERVAL_MS - 1) / MICROAPP_LOOP_INTERVAL_MS;
+
+void handleMeshTransportMsg(MeshMsg msg) {
+	if (msg.size == 0) {
+		return;
+	}
+	if (msg.dataPtr[0] & MESH_TRANSPORT_FRAGMENT_FLAG) {
+		MeshTransport.handleFragment(msg);
+	}
+	else {
+		MeshTransport.handleRecords(msg);
+	}
+}
+
+bool MeshTransportClass::listen(ReceivedMeshMsgHandler handler) {
+	_handler = handler;
+	Mesh.setIncomingMeshMsgHandler(handleMeshTransportMsg);
+	return Mesh.listen();
+}
+
+microapp_sdk_result_t MeshTransportClass::sendFrame(uint8_t* frame, uint8_t size, uint8_t stoneId) {
+	microapp_sdk_result_t result = Mesh.sendMeshMsg(frame, size, stoneId);
+	if (result == CS_MICROAPP_SDK_ACK_SUCCESS && _sentFrameCount < UINT16_MAX) {
+		_sentFrameCount++;
+	}
+	return result;
+}
+
+microapp_sdk_result_t MeshTransportClass::send(const uint8_t* msg, uint8_t msgSize, uint8_t stoneId) {
+	if (msgSize == 0) {
+		return CS_MICROAPP_SDK_ACK_ERR_EMPTY;
+	}
+	if (msgSize > MESH_TRANSPORT_MAX_MESSAGE_SIZE) {
+		return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+	}
+
+	if (msgSize <= MESH_TRANSPORT_MAX_RECORD_SIZE) {
+		// Pack the message as record in the pending frame.
+		if (_pendingSize != 0 && (_pendingStoneId != stoneId || _pendingSize + 1 + msgSize > MAX_MICROAPP_MESH_PAYLOAD_SIZE)) {
+			flush();
+		}
+		if (_pendingSize == 0) {
+			_pendingFrame[0] = 0;
+			_pendingSize     = 1;
+			_pendingStoneId  = stoneId;
+		}
+		_pendingFrame[_pendingSize] = msgSize;
+		memcpy(&_pendingFrame[_pendingSize + 1], msg, msgSize);
+		_pendingSize += 1 + msgSize;
+		if (_pendingSize + 2 > MAX_MICROAPP_MESH_PAYLOAD_SIZE) {
+			// No other record fits anymore.
+			flush();
+		}
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+
+	// Keep the order of messages.
+	flush();
+
+	uint8_t messageId = _nextMessageId;
+	_nextMessageId    = (_nextMessageId + 1) & MESH_TRANSPORT_MESSAGE_ID_MASK;
+
+	// Send all fragments in a single yield, unless the caller already started a batch.
+	uint16_t sentFrameCount      = _sentFrameCount;
+	bool batched                 = (beginBatch() == CS_MICROAPP_SDK_ACK_SUCCESS);
+	microapp_sdk_result_t result = CS_MICROAPP_SDK_ACK_SUCCESS;
+
+	uint8_t frame[MAX_MICROAPP_MESH_PAYLOAD_SIZE];
+	uint8_t offset = 0;
+	for (uint8_t index = 0; offset < msgSize && result == CS_MICROAPP_SDK_ACK_SUCCESS; ++index) {
+		frame[0] = MESH_TRANSPORT_FRAGMENT_FLAG | (messageId << MESH_TRANSPORT_MESSAGE_ID_SHIFT) | index;
+		uint8_t headerSize = 1;
+		uint8_t dataSize   = MESH_TRANSPORT_FRAGMENT_DATA_SIZE;
+		if (index == 0) {
+			frame[headerSize++] = msgSize;
+			dataSize            = MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE;
+		}
+		if (dataSize > msgSize - offset) {
+			dataSize = msgSize - offset;
+		}
+		memcpy(&frame[headerSize], msg + offset, dataSize);
+		result = sendFrame(frame, headerSize + dataSize, stoneId);
+		offset += dataSize;
+	}
+	if (batched) {
+		microapp_sdk_result_t batchResult = commitBatch();
+		if (batchResult != CS_MICROAPP_SDK_ACK_SUCCESS) {
+			// The batched frames were counted when they were added to the batch.
+			_sentFrameCount = sentFrameCount;
+			result          = batchResult;
+		}
+	}
+	return result;
+}
+
+void MeshTransportClass::flush() {
+	if (_pendingSize == 0) {
+		return;
+	}
+	sendFrame(_pendingFrame, _pendingSize, _pendingStoneId);
+	_pendingSize = 0;
+}
+
+void MeshTransportClass::handleRecords(MeshMsg& frame) {
+	uint8_t offset = 1;
+	while (offset < frame.size) {
+		uint8_t recordSize = frame.dataPtr[offset];
+		if (recordSize == 0 || offset + 1 + recordSize > frame.size) {
+			// Malformed record
+			return;
+		}
+		if (_handler != nullptr) {
+			_handler(MeshMsg(frame.stoneId, &frame.dataPtr[offset + 1], recordSize));
+		}
+		offset += 1 + recordSize;
+	}
+}
+
+void MeshTransportClass::countDroppedMsg() {
+	if (_droppedMsgCount < UINT16_MAX) {
+		_droppedMsgCount++;
+	}
+}
+
+void MeshTransportClass::expireReassemblyEntries() {
+	uint32_t now = getLoopTickCount();
+	for (uint8_t i = 0; i < MESH_TRANSPORT_REASSEMBLY_SLOTS; ++i) {
+		if (_reassembly[i].used && now - _reassembly[i].startTick >= MESH_TRANSPORT_TIMEOUT_TICKS) {
+			_reassembly[i].used = false;
+			countDroppedMsg();
+		}
+	}
+}
+
+MeshReassemblyEntry* MeshTransportClass::getReassemblyEntry(uint8_t stoneId, uint8_t messageId) {
+	MeshReassemblyEntry* replacement = nullptr;
+	for (uint8_t i = 0; i < MESH_TRANSPORT_REASSEMBLY_SLOTS; ++i) {
+		MeshReassemblyEntry& entry = _reassembly[i];
+		if (entry.used && entry.stoneId == stoneId && entry.messageId == messageId) {
+			return &entry;
+		}
+		// Prefer an empty entry, otherwise the oldest one.
+		if (replacement == nullptr || (replacement->used && !entry.used)
+			|| (replacement->used && entry.startTick < replacement->startTick)) {
+			replacement = &entry;
+		}
+	}
+	if (replacement->used) {
+		countDroppedMsg();
+	}
+	replacement->used              = true;
+	replacement->stoneId           = stoneId;
+	replacement->messageId         = messageId;
+	replacement->size              = 0;
+	replacement->receivedFragments = 0;
+	replacement->startTick         = getLoopTickCount();
+	return replacement;
+}
+
+void MeshTransportClass::handleFragment(MeshMsg& frame) {
+	expireReassemblyEntries();
+
+	uint8_t header    = frame.dataPtr[0];
+	uint8_t messageId = (header >> MESH_TRANSPORT_MESSAGE_ID_SHIFT) & MESH_TRANSPORT_MESSAGE_ID_MASK;
+	uint8_t index     = header & MESH_TRANSPORT_INDEX_MASK;
+
+	uint8_t* data    = frame.dataPtr + 1;
+	uint8_t dataSize = frame.size - 1;
+	uint8_t offset   = 0;
+	uint8_t msgSize  = 0;
+	if (index == 0) {
+		if (dataSize < 1) {
+			return;
+		}
+		msgSize = data[0];
+		data++;
+		dataSize--;
+	}
+	else {
+		offset = MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE + (index - 1) * MESH_TRANSPORT_FRAGMENT_DATA_SIZE;
+	}
+	if (offset + dataSize > MESH_TRANSPORT_MAX_MESSAGE_SIZE || msgSize > MESH_TRANSPORT_MAX_MESSAGE_SIZE) {
+		countDroppedMsg();
+		return;
+	}
+
+	MeshReassemblyEntry* entry = getReassemblyEntry(frame.stoneId, messageId);
+	if (index == 0) {
+		entry->size = msgSize;
+	}
+	memcpy(entry->data + offset, data, dataSize);
+	entry->receivedFragments |= (1 << index);
+
+	if (entry->size == 0) {
+		// Size is not known until the first fragment is received.
+		return;
+	}
+	uint8_t fragmentCount = 1;
+	if (entry->size > MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE) {
+		fragmentCount += (entry->size - MESH_TRANSPORT_FIRST_FRAGMENT_DATA_SIZE + MESH_TRANSPORT_FRAGMENT_DATA_SIZE - 1)
+						 / MESH_TRANSPORT_FRAGMENT_DATA_SIZE;
+	}
+	if (entry->receivedFragments != (1 << fragmentCount) - 1) {
+		return;
+	}
+	entry->used = false;
+	if (_handler != nullptr) {
+		_handler(MeshMsg(entry->stoneId, entry->data, entry->size));
+	}
+}
+
+uint16_t MeshTransportClass::sentFrameCount() {
+	return _sentFrameCount;
+}
+
+uint16_t MeshTransportClass::droppedMsgCount() {
+	return _droppedMsgCount;
+}
@@ -59,14 +59,37 @@ microapp_sdk_result_t MessageClass::handleInterrupt(void* interrupt) {
 				return CS_MICROAPP_SDK_ACK_SUCCESS;
 			}
 
-			size_t totalSize = _available + message->receivedMessage.size;
-			if (totalSize > sizeof(_receiveBuffer)) {
-				// This won't fit in the buffer.
-				return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+			microapp_size_t size = message->receivedMessage.size;
+			if (size > MICROAPP_SDK_MESSAGE_RECEIVED_MSG_MAX_SIZE) {
+				size = MICROAPP_SDK_MESSAGE_RECEIVED_MSG_MAX_SIZE;
+			}
+			microapp_size_t space   = MESSAGE_RECEIVE_BUFFER_SIZE - available();
+			microapp_size_t dropped = 0;
+			if (size > space) {
+				dropped = (_acceptPolicy == MessageAcceptPartial) ? size - space : size;
+			}
+			if (_droppedByteCount <= UINT16_MAX - dropped) {
+				_droppedByteCount += dropped;
+			}
+			else {
+				_droppedByteCount = UINT16_MAX;
 			}
+			size -= dropped;
 
-			memcpy(_receiveBuffer + _available, message->receivedMessage.data, message->receivedMessage.size);
-			_available += message->receivedMessage.size;
+			// Copy in at most two parts, when the data wraps around the end of the buffer.
+			microapp_size_t offset        = _head & (MESSAGE_RECEIVE_BUFFER_SIZE - 1);
+			microapp_size_t firstPartSize = MESSAGE_RECEIVE_BUFFER_SIZE - offset;
+			if (firstPartSize > size) {
+				firstPartSize = size;
+			}
+			memcpy(_receiveBuffer + offset, message->receivedMessage.data, firstPartSize);
+			memcpy(_receiveBuffer, message->receivedMessage.data + firstPartSize, size - firstPartSize);
+			_head = _head + size;
+
+			if (dropped != 0) {
+				// This didn't (completely) fit in the buffer.
+				return CS_MICROAPP_SDK_ACK_ERR_NO_SPACE;
+			}
 			return CS_MICROAPP_SDK_ACK_SUCCESS;
 		}
 		default: {
@@ -76,26 +99,62 @@ microapp_sdk_result_t MessageClass::handleInterrupt(void* interrupt) {
 }
 
 microapp_size_t MessageClass::available() {
-	return _available;
+	return _head - _tail;
 }
 
 microapp_size_t MessageClass::readBytes(void* data, microapp_size_t size) {
-	if (_available < size) {
-		size = _available;
+	if (available() < size) {
+		size = available();
 	}
 
-	// Copy data to the buffer.
-	memcpy(data, _receiveBuffer, size);
-
-	// Shift the data in the buffer, in case there is more available.
-	for (int i = 0; i < _available - size; ++i) {
-		_receiveBuffer[i] = _receiveBuffer[i + size];
+	// Copy data to the buffer, in at most two parts, when the data wraps around the end of the buffer.
+	microapp_size_t offset        = _tail & (MESSAGE_RECEIVE_BUFFER_SIZE - 1);
+	microapp_size_t firstPartSize = MESSAGE_RECEIVE_BUFFER_SIZE - offset;
+	if (firstPartSize > size) {
+		firstPartSize = size;
 	}
+	memcpy(data, _receiveBuffer + offset, firstPartSize);
+	memcpy(static_cast<uint8_t*>(data) + firstPartSize, _receiveBuffer, size - firstPartSize);
 
-	_available -= size;
+	_tail = _tail + size;
 	return size;
 }
 
+microapp_size_t MessageClass::readBytesUntil(char terminator, void* data, microapp_size_t size) {
+	uint8_t* dest         = static_cast<uint8_t*>(data);
+	microapp_size_t count = 0;
+	while (count < size) {
+		int value = read();
+		if (value < 0 || value == (uint8_t)terminator) {
+			break;
+		}
+		dest[count++] = value;
+	}
+	return count;
+}
+
+int MessageClass::read() {
+	int value = peek();
+	if (value >= 0) {
+		_tail = _tail + 1;
+	}
+	return value;
+}
+
+int MessageClass::peek() {
+	if (available() == 0) {
+		return -1;
+	}
+	return _receiveBuffer[_tail & (MESSAGE_RECEIVE_BUFFER_SIZE - 1)];
+}
+
+void MessageClass::setAcceptPolicy(MessageAcceptPolicy policy) {
+	_acceptPolicy = policy;
+}
+
+uint16_t MessageClass::droppedByteCount() {
+	return _droppedByteCount;
+}
 
 microapp_size_t MessageClass::write(void* data, microapp_size_t size) {
 	uint8_t* payload                = getOutgoingMessagePayload();
@@ -117,6 +176,91 @@ microapp_size_t MessageClass::write(void* data, microapp_size_t size) {
 	return size;
 }
 
+bool MessageClass::beginFrame() {
+	if (_frameStarted) {
+		return false;
+	}
+	_frameStarted   = true;
+	_frameSuccess   = true;
+	_frameChunkSize = 0;
+	_frameOffset    = 0;
+	_frameSequence++;
+	return true;
+}
+
+microapp_size_t MessageClass::writeChunk(const void* data, microapp_size_t size) {
+	if (!_frameStarted) {
+		return 0;
+	}
+	auto bytes              = static_cast<const uint8_t*>(data);
+	microapp_size_t written = 0;
+	while (written < size && _frameSuccess) {
+		if (_frameChunkSize == sizeof(_frameChunk)) {
+			// Only send a full chunk when there is more data, so that the last chunk can be sent with the last flag.
+			if (_frameOffset > UINT16_MAX - 2 * sizeof(_frameChunk) || !sendFrameChunk(false)) {
+				break;
+			}
+		}
+		microapp_size_t chunkSize = sizeof(_frameChunk) - _frameChunkSize;
+		if (chunkSize > size - written) {
+			chunkSize = size - written;
+		}
+		memcpy(_frameChunk + _frameChunkSize, bytes + written, chunkSize);
+		_frameChunkSize += chunkSize;
+		written += chunkSize;
+	}
+	return written;
+}
+
+bool MessageClass::endFrame() {
+	if (!_frameStarted) {
+		return false;
+	}
+	_frameStarted = false;
+	if (!_frameSuccess) {
+		// The receiver can not reassemble the frame anyway.
+		return false;
+	}
+	return sendFrameChunk(true);
+}
+
+bool MessageClass::writeFrame(const void* data, microapp_size_t size) {
+	if (!beginFrame()) {
+		return false;
+	}
+	bool success = (writeChunk(data, size) == size);
+	return endFrame() && success;
+}
+
+bool MessageClass::sendFrameChunk(bool last) {
+	uint8_t* payload                = getOutgoingMessagePayload();
+	microapp_sdk_message_t* request = reinterpret_cast<microapp_sdk_message_t*>(payload);
+	request->header.messageType     = MicroappSdkType::CS_MICROAPP_SDK_TYPE_MESSAGE;
+	request->header.ack             = CS_MICROAPP_SDK_ACK_REQUEST;
+	request->type                   = CS_MICROAPP_SDK_MSG_REQUEST_SEND_MSG;
+
+	auto header      = reinterpret_cast<message_frame_header_t*>(request->sendMessage.data);
+	header->sequence = _frameSequence;
+	header->flags    = 0;
+	if (_frameOffset == 0) {
+		header->flags |= MESSAGE_FRAME_FLAG_FIRST;
+	}
+	if (last) {
+		header->flags |= MESSAGE_FRAME_FLAG_LAST;
+	}
+	header->offset = _frameOffset;
+	memcpy(request->sendMessage.data + sizeof(message_frame_header_t), _frameChunk, _frameChunkSize);
+	request->sendMessage.size = sizeof(message_frame_header_t) + _frameChunkSize;
+
+	if (sendMessage() != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		_frameSuccess = false;
+		return false;
+	}
+	_frameOffset += _frameChunkSize;
+	_frameChunkSize = 0;
+	return true;
+}
+
 bool MessageClass::setHandler(MessageHandler handler) {
 	_handler = handler;
 	return true;
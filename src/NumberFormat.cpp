@@ -0,0 +1,416 @@
+#include <NumberFormat.h>
+
+// Only 32-bit divisions and single precision floats are used: the Cortex-M4 does those in hardware, while 64-bit
+// divisions and doubles would need library functions.
+
+namespace {
+
+const uint32_t POWERS_OF_10[] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000};
+
+uint8_t writeString(char* buf, const char* str) {
+	uint8_t length = 0;
+	while (str[length] != 0) {
+		buf[length] = str[length];
+		length++;
+	}
+	buf[length] = 0;
+	return length;
+}
+
+/**
+ * Write the digits of a value, zero padded to a minimal number of digits. Does not write a null terminator.
+ */
+uint8_t writeDigits(char* buf, uint32_t value, uint8_t base, bool upperCase, uint8_t minDigits) {
+	char digits[MAX_NUMBER_STRING_LENGTH];
+	uint8_t count = 0;
+	do {
+		uint8_t digit   = value % base;
+		digits[count++] = (digit < 10) ? '0' + digit : (upperCase ? 'A' : 'a') + digit - 10;
+		value /= base;
+	} while (value != 0);
+	while (count < minDigits && count < MAX_NUMBER_STRING_LENGTH) {
+		digits[count++] = '0';
+	}
+
+	for (uint8_t i = 0; i < count; ++i) {
+		buf[i] = digits[count - 1 - i];
+	}
+	return count;
+}
+
+/**
+ * Format mantissa * 2^exponent in fixed point notation, exactly.
+ */
+uint8_t formatFixed(char* buf, bool negative, uint64_t mantissa, int16_t exponent, uint8_t precision) {
+	if (precision > MAX_FLOAT_PRECISION) {
+		precision = MAX_FLOAT_PRECISION;
+	}
+
+	uint32_t integerPart = 0;
+	uint64_t fraction    = 0;
+	uint8_t fractionBits = 0;
+	bool overflow        = false;
+	if (exponent >= 0) {
+		overflow    = (exponent >= 32 || mantissa > (UINT32_MAX >> exponent));
+		integerPart = overflow ? 0 : (uint32_t)(mantissa << exponent);
+	}
+	else {
+		uint16_t shift = -exponent;
+		if (shift < 64) {
+			overflow    = ((mantissa >> shift) > UINT32_MAX);
+			integerPart = (uint32_t)(mantissa >> shift);
+			fraction    = mantissa & ((1ULL << shift) - 1);
+		}
+		else {
+			fraction = mantissa;
+		}
+		// Keep 4 bits of headroom to multiply by 10. The bits that are dropped do not affect the decimals.
+		if (shift > 60) {
+			fraction = (shift - 60 < 64) ? fraction >> (shift - 60) : 0;
+			shift    = 60;
+		}
+		fractionBits = shift;
+	}
+
+	uint32_t decimals = 0;
+	if (!overflow) {
+		uint64_t mask = (1ULL << fractionBits) - 1;
+		for (uint8_t i = 0; i < precision; ++i) {
+			fraction *= 10;
+			decimals = decimals * 10 + (uint32_t)(fraction >> fractionBits);
+			fraction &= mask;
+		}
+		// Round half away from zero.
+		if (fractionBits > 0 && fraction >= (1ULL << (fractionBits - 1))) {
+			decimals++;
+			if (decimals == POWERS_OF_10[precision]) {
+				decimals = 0;
+				overflow = (integerPart == UINT32_MAX);
+				integerPart++;
+			}
+		}
+	}
+
+	uint8_t length = 0;
+	if (negative) {
+		buf[length++] = '-';
+	}
+	if (overflow) {
+		return length + writeString(buf + length, "ovf");
+	}
+	length += writeDigits(buf + length, integerPart, 10, false, 1);
+	if (precision > 0) {
+		buf[length++] = '.';
+		length += writeDigits(buf + length, decimals, 10, false, precision);
+	}
+	buf[length] = 0;
+	return length;
+}
+
+/**
+ * Grisu2, as described in "Printing Floating-Point Numbers Quickly and Accurately with Integers" by Florian Loitsch,
+ * for floats. With 64-bit integers for the 24-bit mantissa of a float, the result is practically always the shortest.
+ */
+
+//! A floating point number f * 2^e, with a 64-bit mantissa.
+struct DiyFp {
+	uint64_t f;
+	int16_t e;
+};
+
+DiyFp normalize(DiyFp value) {
+	while ((value.f & (1ULL << 63)) == 0) {
+		value.f <<= 1;
+		value.e--;
+	}
+	return value;
+}
+
+//! Multiply, keeping the upper 64 bits of the mantissa, rounded.
+DiyFp multiply(DiyFp x, DiyFp y) {
+	uint64_t a   = x.f >> 32;
+	uint64_t b   = x.f & 0xFFFFFFFF;
+	uint64_t c   = y.f >> 32;
+	uint64_t d   = y.f & 0xFFFFFFFF;
+	uint64_t ac  = a * c;
+	uint64_t bc  = b * c;
+	uint64_t ad  = a * d;
+	uint64_t bd  = b * d;
+	uint64_t tmp = (bd >> 32) + (ad & 0xFFFFFFFF) + (bc & 0xFFFFFFFF) + (1U << 31);
+	return DiyFp{ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), (int16_t)(x.e + y.e + 64)};
+}
+
+//! Normalized powers of 10, every 8 decimal exponents, covering the range of floats.
+struct CachedPower {
+	uint64_t f;
+	int16_t e;
+	int16_t k;
+};
+
+const CachedPower CACHED_POWERS[] = {
+		{0xCFB11EAD453994BA, -170, -32},
+		{0x9ABE14CD44753B53, -143, -24},
+		{0xE69594BEC44DE15B, -117, -16},
+		{0xABCC77118461CEFD, -90, -8},
+		{0x8000000000000000, -63, 0},
+		{0xBEBC200000000000, -37, 8},
+		{0x8E1BC9BF04000000, -10, 16},
+		{0xD3C21BCECCEDA100, 16, 24},
+		{0x9DC5ADA82B70B59E, 43, 32},
+		{0xEB194F8E1AE525FD, 69, 40},
+		{0xAF298D050E4395D7, 96, 48},
+};
+
+// The product with the cached power gets a binary exponent in this range, so that the integer part fits in 32 bits,
+// and the fraction can be multiplied by 10.
+const int16_t MIN_TARGET_EXPONENT = -60;
+const int16_t MAX_TARGET_EXPONENT = -32;
+
+const CachedPower& getCachedPower(int16_t exponent) {
+	for (const CachedPower& power : CACHED_POWERS) {
+		int16_t targetExponent = exponent + power.e + 64;
+		if (targetExponent >= MIN_TARGET_EXPONENT && targetExponent <= MAX_TARGET_EXPONENT) {
+			return power;
+		}
+	}
+	// Not reached for floats.
+	return CACHED_POWERS[0];
+}
+
+void roundWeed(char* digits, uint8_t length, uint64_t delta, uint64_t rest, uint64_t tenKappa, uint64_t distance) {
+	while (rest < distance && rest + tenKappa <= delta
+		   && (rest + tenKappa < distance || distance - rest > rest + tenKappa - distance)) {
+		digits[length - 1]--;
+		rest += tenKappa;
+	}
+}
+
+/**
+ * Generate the shortest digits of the value, such that value = digits * 10^decimalExponent.
+ */
+uint8_t grisu2(float value, char* digits, int16_t& decimalExponent) {
+	union {
+		float value;
+		uint32_t bits;
+	} convert;
+	convert.value      = value;
+	uint32_t biasedExp = (convert.bits >> 23) & 0xFF;
+	DiyFp v{convert.bits & 0x7FFFFF, -149};
+	if (biasedExp != 0) {
+		v.f |= 1 << 23;
+		v.e = (int16_t)biasedExp - 150;
+	}
+
+	// Boundaries: halfway to the neighbouring floats.
+	DiyFp plus = normalize(DiyFp{(v.f << 1) + 1, (int16_t)(v.e - 1)});
+	DiyFp minus;
+	if (v.f == (1 << 23) && biasedExp > 1) {
+		// The float below has a smaller exponent, so it's closer.
+		minus = DiyFp{(v.f << 2) - 1, (int16_t)(v.e - 2)};
+	}
+	else {
+		minus = DiyFp{(v.f << 1) - 1, (int16_t)(v.e - 1)};
+	}
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+
+	const CachedPower& power = getCachedPower(plus.e);
+	DiyFp cached{power.f, power.e};
+	DiyFp w  = multiply(normalize(v), cached);
+	DiyFp wp = multiply(plus, cached);
+	DiyFp wm = multiply(minus, cached);
+	// A value exactly on a boundary reads back as the float with the even mantissa. So the boundaries are included
+	// when the mantissa is even, else they are left out. Either way, allowing for the rounding of the multiplications,
+	// which is less than a unit.
+	if ((v.f & 1) == 0) {
+		wm.f--;
+		wp.f++;
+	}
+	else {
+		wm.f++;
+		wp.f--;
+	}
+
+	// Generate digits of wp, until it's within delta.
+	uint64_t delta    = wp.f - wm.f;
+	uint64_t distance = wp.f - w.f;
+	DiyFp one{1ULL << -wp.e, wp.e};
+	uint32_t p1     = (uint32_t)(wp.f >> -one.e);
+	uint64_t p2     = wp.f & (one.f - 1);
+	uint8_t kappa   = 10;
+	while (kappa > 0 && p1 < POWERS_OF_10[kappa - 1]) {
+		kappa--;
+	}
+	decimalExponent = -power.k;
+	uint8_t length  = 0;
+	while (kappa > 0) {
+		uint32_t digit = p1 / POWERS_OF_10[kappa - 1];
+		p1 %= POWERS_OF_10[kappa - 1];
+		if (digit != 0 || length != 0) {
+			digits[length++] = '0' + digit;
+		}
+		kappa--;
+		uint64_t rest = ((uint64_t)p1 << -one.e) + p2;
+		if (rest <= delta) {
+			decimalExponent += kappa;
+			roundWeed(digits, length, delta, rest, (uint64_t)POWERS_OF_10[kappa] << -one.e, distance);
+			return length;
+		}
+	}
+	uint8_t fractionDigits = 0;
+	while (true) {
+		p2 *= 10;
+		delta *= 10;
+		uint8_t digit = (uint8_t)(p2 >> -one.e);
+		if (digit != 0 || length != 0) {
+			digits[length++] = '0' + digit;
+		}
+		p2 &= one.f - 1;
+		fractionDigits++;
+		if (p2 <= delta) {
+			decimalExponent -= fractionDigits;
+			roundWeed(digits, length, delta, p2, one.f, distance * POWERS_OF_10[fractionDigits]);
+			return length;
+		}
+	}
+}
+
+}  // namespace
+
+uint8_t formatInt(char* buf, int32_t value) {
+	uint8_t length = 0;
+	if (value < 0) {
+		buf[length++] = '-';
+	}
+	uint32_t absValue = (value < 0) ? 0U - (uint32_t)value : (uint32_t)value;
+	length += writeDigits(buf + length, absValue, 10, false, 1);
+	buf[length] = 0;
+	return length;
+}
+
+uint8_t formatUnsigned(char* buf, uint32_t value, uint8_t base, bool upperCase) {
+	if (base < 2 || base > 16) {
+		base = 10;
+	}
+	uint8_t length = writeDigits(buf, value, base, upperCase, 1);
+	buf[length]    = 0;
+	return length;
+}
+
+uint8_t formatHex(char* buf, uint32_t value, uint8_t minDigits, bool upperCase) {
+	uint8_t length = writeDigits(buf, value, 16, upperCase, minDigits);
+	buf[length]    = 0;
+	return length;
+}
+
+uint8_t formatFloat(char* buf, float value, uint8_t precision) {
+	union {
+		float value;
+		uint32_t bits;
+	} convert;
+	convert.value      = value;
+	bool negative      = (convert.bits >> 31) != 0;
+	uint32_t biasedExp = (convert.bits >> 23) & 0xFF;
+	uint32_t mantissa  = convert.bits & 0x7FFFFF;
+	if (biasedExp == 0xFF) {
+		if (mantissa != 0) {
+			return writeString(buf, "nan");
+		}
+		return writeString(buf, negative ? "-inf" : "inf");
+	}
+	if (biasedExp == 0) {
+		return formatFixed(buf, negative, mantissa, -149, precision);
+	}
+	return formatFixed(buf, negative, mantissa | (1 << 23), (int16_t)biasedExp - 150, precision);
+}
+
+uint8_t formatFloat(char* buf, double value, uint8_t precision) {
+	union {
+		double value;
+		uint64_t bits;
+	} convert;
+	convert.value      = value;
+	bool negative      = (convert.bits >> 63) != 0;
+	uint32_t biasedExp = (convert.bits >> 52) & 0x7FF;
+	uint64_t mantissa  = convert.bits & ((1ULL << 52) - 1);
+	if (biasedExp == 0x7FF) {
+		if (mantissa != 0) {
+			return writeString(buf, "nan");
+		}
+		return writeString(buf, negative ? "-inf" : "inf");
+	}
+	if (biasedExp == 0) {
+		return formatFixed(buf, negative, mantissa, -1074, precision);
+	}
+	return formatFixed(buf, negative, mantissa | (1ULL << 52), (int16_t)biasedExp - 1075, precision);
+}
+
+uint8_t formatFloatShortest(char* buf, float value) {
+	union {
+		float value;
+		uint32_t bits;
+	} convert;
+	convert.value      = value;
+	bool negative      = (convert.bits >> 31) != 0;
+	uint32_t biasedExp = (convert.bits >> 23) & 0xFF;
+	if (biasedExp == 0xFF) {
+		if ((convert.bits & 0x7FFFFF) != 0) {
+			return writeString(buf, "nan");
+		}
+		return writeString(buf, negative ? "-inf" : "inf");
+	}
+
+	uint8_t length = 0;
+	if (negative) {
+		buf[length++] = '-';
+	}
+	if ((convert.bits & 0x7FFFFFFF) == 0) {
+		buf[length++] = '0';
+		buf[length]   = 0;
+		return length;
+	}
+
+	char digits[MAX_NUMBER_STRING_LENGTH];
+	int16_t decimalExponent;
+	uint8_t digitCount = grisu2(value, digits, decimalExponent);
+
+	// Exponent of the first digit.
+	int16_t exponent = digitCount + decimalExponent - 1;
+	if (exponent >= -5 && exponent < 9) {
+		if (exponent < 0) {
+			// 0.000ddd
+			buf[length++] = '0';
+			buf[length++] = '.';
+			for (int16_t i = -1; i > exponent; --i) {
+				buf[length++] = '0';
+			}
+			for (uint8_t i = 0; i < digitCount; ++i) {
+				buf[length++] = digits[i];
+			}
+		}
+		else {
+			// ddd.ddd or ddd000
+			for (int16_t i = 0; i <= exponent || i < digitCount; ++i) {
+				if (i == exponent + 1) {
+					buf[length++] = '.';
+				}
+				buf[length++] = (i < digitCount) ? digits[i] : '0';
+			}
+		}
+	}
+	else {
+		// d.ddde+xx
+		buf[length++] = digits[0];
+		if (digitCount > 1) {
+			buf[length++] = '.';
+			for (uint8_t i = 1; i < digitCount; ++i) {
+				buf[length++] = digits[i];
+			}
+		}
+		buf[length++] = 'e';
+		buf[length++] = (exponent < 0) ? '-' : '+';
+		length += writeDigits(buf + length, (exponent < 0) ? -exponent : exponent, 10, false, 2);
+	}
+	buf[length] = 0;
+	return length;
+}
@@ -1,3 +1,4 @@
+#include <NumberFormat.h>
 #include <Serial.h>
 #include <ipc/cs_IpcRamData.h>
 #include <microapp.h>
@@ -38,7 +39,7 @@ microapp_size_t Serial_::write(const char* str) {
 	return _write(str);
 }
 
-microapp_size_t Serial_::write(String str) {
+microapp_size_t Serial_::write(StringView str) {
 	return _write(str);
 }
 
@@ -76,7 +77,7 @@ microapp_size_t Serial_::print(const char* str) {
 	return _write(str);
 }
 
-microapp_size_t Serial_::print(String str) {
+microapp_size_t Serial_::print(StringView str) {
 	return _write(str);
 }
 
@@ -114,7 +115,7 @@ microapp_size_t Serial_::println(const char* str) {
 	return _write(str, CS_MICROAPP_SDK_LOG_FLAG_NEWLINE);
 }
 
-microapp_size_t Serial_::println(String str) {
+microapp_size_t Serial_::println(StringView str) {
 	return _write(str, CS_MICROAPP_SDK_LOG_FLAG_NEWLINE);
 }
 
@@ -122,9 +123,190 @@ microapp_size_t Serial_::println(const uint8_t* buf, int length) {
 	return _write(buf, length, CS_MICROAPP_SDK_LOG_FLAG_NEWLINE);
 }
 
+microapp_size_t Serial_::printf(const char* format, ...) {
+	va_list args;
+	va_start(args, format);
+	microapp_size_t count = _appendFormatted(format, args);
+	va_end(args);
+	if (!_lineBuffered) {
+		flush();
+	}
+	return count;
+}
+
+void Serial_::setLineBuffered(bool lineBuffered) {
+	if (!lineBuffered) {
+		flush();
+	}
+	_lineBuffered = lineBuffered;
+}
+
+void Serial_::flush() {
+	if (_lineSize > 0) {
+		_sendLine(CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
+	}
+}
+
 /// Implementations (protected)
 
+microapp_size_t Serial_::_append(char value) {
+	if (value == '\n') {
+		_sendLine(CS_MICROAPP_SDK_LOG_FLAG_NEWLINE);
+		return 1;
+	}
+	_line[_lineSize++] = value;
+	if (_lineSize == MAX_STRING_SIZE) {
+		_sendLine(CS_MICROAPP_SDK_LOG_FLAG_CLEAR);
+	}
+	return 1;
+}
+
+microapp_size_t Serial_::_append(const char* str, microapp_size_t length) {
+	for (microapp_size_t i = 0; i < length; ++i) {
+		_append(str[i]);
+	}
+	return length;
+}
+
+microapp_size_t Serial_::_appendPadded(const char* str, microapp_size_t length, uint8_t width, char pad, bool leftAlign) {
+	microapp_size_t count = 0;
+	if (!leftAlign) {
+		if (pad == '0' && length > 0 && str[0] == '-') {
+			// The sign goes before the zeros.
+			count += _append('-');
+			str++;
+			length--;
+		}
+		while (count + length < width) {
+			count += _append(pad);
+		}
+	}
+	count += _append(str, length);
+	while (count < width) {
+		count += _append(' ');
+	}
+	return count;
+}
+
+microapp_size_t Serial_::_appendFormatted(const char* format, va_list args) {
+	microapp_size_t count = 0;
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	while (*format != 0) {
+		char c = *format++;
+		if (c != '%') {
+			count += _append(c);
+			continue;
+		}
+
+		bool leftAlign = false;
+		char pad       = ' ';
+		while (*format == '-' || *format == '0') {
+			if (*format == '-') {
+				leftAlign = true;
+			}
+			else {
+				pad = '0';
+			}
+			format++;
+		}
+		uint8_t width = 0;
+		while (*format >= '0' && *format <= '9') {
+			width = width * 10 + (*format++ - '0');
+		}
+		int precision = -1;
+		if (*format == '.') {
+			format++;
+			precision = 0;
+			while (*format >= '0' && *format <= '9') {
+				precision = precision * 10 + (*format++ - '0');
+			}
+		}
+		bool isLong = false;
+		while (*format == 'l' || *format == 'h') {
+			isLong = (*format == 'l');
+			format++;
+		}
+
+		c = *format;
+		if (c == 0) {
+			break;
+		}
+		format++;
+		switch (c) {
+			case 'd':
+			case 'i': {
+				long value     = isLong ? va_arg(args, long) : va_arg(args, int);
+				uint8_t length = formatInt(buf, value);
+				count += _appendPadded(buf, length, width, pad, leftAlign);
+				break;
+			}
+			case 'u':
+			case 'x':
+			case 'X': {
+				unsigned long value = isLong ? va_arg(args, unsigned long) : va_arg(args, unsigned int);
+				uint8_t length      = formatUnsigned(buf, value, (c == 'u') ? 10 : 16, c == 'X');
+				count += _appendPadded(buf, length, width, pad, leftAlign);
+				break;
+			}
+			case 'c': {
+				buf[0] = (char)va_arg(args, int);
+				count += _appendPadded(buf, 1, width, ' ', leftAlign);
+				break;
+			}
+			case 's': {
+				const char* str = va_arg(args, const char*);
+				if (str == nullptr) {
+					str = "(null)";
+				}
+				count += _appendPadded(str, strlen(str), width, ' ', leftAlign);
+				break;
+			}
+			case 'f': {
+				uint8_t length = formatFloat(buf, va_arg(args, double), (precision < 0) ? 6 : precision);
+				count += _appendPadded(buf, length, width, pad, leftAlign);
+				break;
+			}
+			case 'g': {
+				// Floats are single precision on the microapp, so print the shortest text of the float.
+				uint8_t length = formatFloatShortest(buf, (float)va_arg(args, double));
+				count += _appendPadded(buf, length, width, pad, leftAlign);
+				break;
+			}
+			case '%': {
+				count += _append('%');
+				break;
+			}
+			default: {
+				// Unsupported conversion: write it as is.
+				count += _append('%');
+				count += _append(c);
+				break;
+			}
+		}
+	}
+	return count;
+}
+
+void Serial_::_sendLine(MicroappSdkLogFlags flags) {
+	uint8_t* payload                      = getOutgoingMessagePayload();
+	microapp_sdk_log_string_t* logRequest = reinterpret_cast<microapp_sdk_log_string_t*>(payload);
+	logRequest->logHeader.size            = _lineSize;
+	memcpy(logRequest->str, _line, _lineSize);
+	// Clear the buffer before yielding, interrupt handlers may print as well.
+	_lineSize = 0;
+	_write(reinterpret_cast<microapp_sdk_log_header_t*>(logRequest), Type::Str, flags);
+}
+
+
 microapp_size_t Serial_::_write(char value, MicroappSdkLogFlags flags) {
+	if (_lineBuffered) {
+		microapp_size_t count = _append(value);
+		// A newline character already sent the line.
+		if ((flags & CS_MICROAPP_SDK_LOG_FLAG_NEWLINE) && value != '\n') {
+			_sendLine(CS_MICROAPP_SDK_LOG_FLAG_NEWLINE);
+		}
+		return count;
+	}
 	uint8_t* payload                    = getOutgoingMessagePayload();
 	microapp_sdk_log_char_t* logRequest = reinterpret_cast<microapp_sdk_log_char_t*>(payload);
 	logRequest->value                   = value;
@@ -132,23 +314,22 @@ microapp_size_t Serial_::_write(char value, MicroappSdkLogFlags flags) {
 	return _write(reinterpret_cast<microapp_sdk_log_header_t*>(logRequest), Type::Char, flags);
 }
 
+// Floats are formatted by the microapp, like Arduino does: with 2 decimals.
 microapp_size_t Serial_::_write(float value, MicroappSdkLogFlags flags) {
-	uint8_t* payload                     = getOutgoingMessagePayload();
-	microapp_sdk_log_float_t* logRequest = reinterpret_cast<microapp_sdk_log_float_t*>(payload);
-	logRequest->value                    = value;
-	logRequest->logHeader.size           = sizeof(value);
-	return _write(reinterpret_cast<microapp_sdk_log_header_t*>(logRequest), Type::Float, flags);
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	return _write(StringView(buf, formatFloat(buf, value, 2)), flags);
 }
 
 microapp_size_t Serial_::_write(double value, MicroappSdkLogFlags flags) {
-	uint8_t* payload                      = getOutgoingMessagePayload();
-	microapp_sdk_log_double_t* logRequest = reinterpret_cast<microapp_sdk_log_double_t*>(payload);
-	logRequest->value                     = value;
-	logRequest->logHeader.size            = sizeof(value);
-	return _write(reinterpret_cast<microapp_sdk_log_header_t*>(logRequest), Type::Double, flags);
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	return _write(StringView(buf, formatFloat(buf, value, 2)), flags);
 }
 
 microapp_size_t Serial_::_write(int value, MicroappSdkLogFlags flags) {
+	if (_lineBuffered) {
+		char buf[MAX_NUMBER_STRING_LENGTH + 1];
+		return _write(StringView(buf, formatInt(buf, value)), flags);
+	}
 	uint8_t* payload                   = getOutgoingMessagePayload();
 	microapp_sdk_log_int_t* logRequest = reinterpret_cast<microapp_sdk_log_int_t*>(payload);
 	logRequest->value                  = value;
@@ -157,6 +338,9 @@ microapp_size_t Serial_::_write(int value, MicroappSdkLogFlags flags) {
 }
 
 microapp_size_t Serial_::_write(short value, MicroappSdkLogFlags flags) {
+	if (_lineBuffered) {
+		return _write((int)value, flags);
+	}
 	uint8_t* payload                     = getOutgoingMessagePayload();
 	microapp_sdk_log_short_t* logRequest = reinterpret_cast<microapp_sdk_log_short_t*>(payload);
 	logRequest->value                    = value;
@@ -165,6 +349,10 @@ microapp_size_t Serial_::_write(short value, MicroappSdkLogFlags flags) {
 }
 
 microapp_size_t Serial_::_write(unsigned int value, MicroappSdkLogFlags flags) {
+	if (_lineBuffered) {
+		char buf[MAX_NUMBER_STRING_LENGTH + 1];
+		return _write(StringView(buf, formatUnsigned(buf, value)), flags);
+	}
 	uint8_t* payload                    = getOutgoingMessagePayload();
 	microapp_sdk_log_uint_t* logRequest = reinterpret_cast<microapp_sdk_log_uint_t*>(payload);
 	logRequest->value                   = value;
@@ -173,19 +361,17 @@ microapp_size_t Serial_::_write(unsigned int value, MicroappSdkLogFlags flags) {
 }
 
 microapp_size_t Serial_::_write(const char* str, MicroappSdkLogFlags flags) {
-	uint8_t* payload                      = getOutgoingMessagePayload();
-	microapp_sdk_log_string_t* logRequest = reinterpret_cast<microapp_sdk_log_string_t*>(payload);
-	if (strlen(str) > MAX_STRING_SIZE) {
-		logRequest->logHeader.size = MAX_STRING_SIZE;
-	}
-	else {
-		logRequest->logHeader.size = strlen(str);
-	}
-	memcpy(logRequest->str, str, logRequest->logHeader.size);
-	return _write(reinterpret_cast<microapp_sdk_log_header_t*>(logRequest), Type::Str, flags);
+	return _write(StringView(str), flags);
 }
 
-microapp_size_t Serial_::_write(String str, MicroappSdkLogFlags flags) {
+microapp_size_t Serial_::_write(StringView str, MicroappSdkLogFlags flags) {
+	if (_lineBuffered) {
+		microapp_size_t count = _append(str.data(), str.length());
+		if (flags & CS_MICROAPP_SDK_LOG_FLAG_NEWLINE) {
+			_sendLine(CS_MICROAPP_SDK_LOG_FLAG_NEWLINE);
+		}
+		return count;
+	}
 	uint8_t* payload                      = getOutgoingMessagePayload();
 	microapp_sdk_log_string_t* logRequest = reinterpret_cast<microapp_sdk_log_string_t*>(payload);
 	if (str.length() > MAX_STRING_SIZE) {
@@ -194,11 +380,13 @@ microapp_size_t Serial_::_write(String str, MicroappSdkLogFlags flags) {
 	else {
 		logRequest->logHeader.size = str.length();
 	}
-	memcpy(logRequest->str, str.c_str(), logRequest->logHeader.size);
+	memcpy(logRequest->str, str.data(), logRequest->logHeader.size);
 	return _write(reinterpret_cast<microapp_sdk_log_header_t*>(logRequest), Type::Str, flags);
 }
 
 microapp_size_t Serial_::_write(const uint8_t* buf, int length, MicroappSdkLogFlags flags) {
+	// Arrays are formatted by bluenet, keep the order of logs.
+	flush();
 	uint8_t* payload                     = getOutgoingMessagePayload();
 	microapp_sdk_log_array_t* logRequest = reinterpret_cast<microapp_sdk_log_array_t*>(payload);
 	if (length < 0) {
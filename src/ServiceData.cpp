@@ -1,22 +1,10 @@
 #include <ServiceData.h>
 
 void ServiceData_::write(uint16_t appUuid, const char* str) {
-	uint8_t* payload                         = getOutgoingMessagePayload();
-	microapp_sdk_service_data_t* serviceData = reinterpret_cast<microapp_sdk_service_data_t*>(payload);
-	serviceData->appUuid                     = appUuid;
-	microapp_size_t size                              = strlen(str);
-	// Silently truncate data if too long
-	if (size > MICROAPP_SDK_MAX_SERVICE_DATA_LENGTH) {
-		serviceData->size = MICROAPP_SDK_MAX_SERVICE_DATA_LENGTH;
-	}
-	else {
-		serviceData->size = size;
-	}
-	memcpy(serviceData->data, str, serviceData->size);
-	_write(serviceData);
+	write(appUuid, StringView(str));
 }
 
-void ServiceData_::write(uint16_t appUuid, String str) {
+void ServiceData_::write(uint16_t appUuid, StringView str) {
 	uint8_t* payload                         = getOutgoingMessagePayload();
 	microapp_sdk_service_data_t* serviceData = reinterpret_cast<microapp_sdk_service_data_t*>(payload);
 	serviceData->appUuid                     = appUuid;
@@ -27,7 +15,7 @@ void ServiceData_::write(uint16_t appUuid, String str) {
 	else {
 		serviceData->size = str.length();
 	}
-	memcpy(serviceData->data, str.c_str(), serviceData->size);
+	memcpy(serviceData->data, str.data(), serviceData->size);
 	_write(serviceData);
 }
 
@@ -46,6 +34,29 @@ void ServiceData_::write(uint16_t appUuid, uint8_t* buf, microapp_size_t size) {
 	_write(serviceData);
 }
 
+void ServiceData_::write(uint16_t appUuid, int value) {
+	write(appUuid, (long)value);
+}
+
+void ServiceData_::write(uint16_t appUuid, unsigned int value) {
+	write(appUuid, (unsigned long)value);
+}
+
+void ServiceData_::write(uint16_t appUuid, long value) {
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	write(appUuid, StringView(buf, formatInt(buf, value)));
+}
+
+void ServiceData_::write(uint16_t appUuid, unsigned long value) {
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	write(appUuid, StringView(buf, formatUnsigned(buf, value)));
+}
+
+void ServiceData_::write(uint16_t appUuid, double value, uint8_t decimals) {
+	char buf[MAX_NUMBER_STRING_LENGTH + 1];
+	write(appUuid, StringView(buf, formatFloat(buf, value, decimals)));
+}
+
 // Set header fields and call sendMessage
 void ServiceData_::_write(microapp_sdk_service_data_t* serviceData) {
 	serviceData->header.messageType = CS_MICROAPP_SDK_TYPE_SERVICE_DATA;
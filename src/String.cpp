@@ -0,0 +1,89 @@
+#include <String.h>
+
+StringView::StringView(const char* str) {
+	if (str == nullptr) {
+		return;
+	}
+	_str    = str;
+	_length = strlen(str);
+	// The strlen of the microapp stops at MAX_STRING_SIZE: count the rest of a longer string.
+	if (_length == MAX_STRING_SIZE) {
+		while (_length < UINT16_MAX && str[_length] != 0) {
+			_length++;
+		}
+	}
+}
+
+int StringView::compareTo(StringView other) const {
+	microapp_size_t length = (_length < other._length) ? _length : other._length;
+	int result             = memcmp(_str, other._str, length);
+	if (result != 0) {
+		return result;
+	}
+	return (int)_length - (int)other._length;
+}
+
+bool StringView::equals(StringView other) const {
+	return _length == other._length && memcmp(_str, other._str, _length) == 0;
+}
+
+bool StringView::startsWith(StringView prefix) const {
+	return prefix._length <= _length && memcmp(_str, prefix._str, prefix._length) == 0;
+}
+
+bool StringView::endsWith(StringView suffix) const {
+	return suffix._length <= _length && memcmp(_str + _length - suffix._length, suffix._str, suffix._length) == 0;
+}
+
+int StringView::indexOf(char c, microapp_size_t from) const {
+	for (microapp_size_t i = from; i < _length; ++i) {
+		if (_str[i] == c) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int StringView::indexOf(StringView str, microapp_size_t from) const {
+	if (str._length > _length) {
+		return -1;
+	}
+	for (microapp_size_t i = from; i <= _length - str._length; ++i) {
+		if (memcmp(_str + i, str._str, str._length) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+int StringView::lastIndexOf(char c) const {
+	for (microapp_size_t i = _length; i > 0; --i) {
+		if (_str[i - 1] == c) {
+			return i - 1;
+		}
+	}
+	return -1;
+}
+
+StringView StringView::substring(microapp_size_t from, microapp_size_t to) const {
+	if (to > _length) {
+		to = _length;
+	}
+	if (from > to) {
+		from = to;
+	}
+	return StringView(_str + from, to - from);
+}
+
+bool appendToString(char* str, microapp_size_t& length, microapp_size_t capacity, StringView value) {
+	microapp_size_t count = value.length();
+	bool fits             = true;
+	if (count > capacity - length) {
+		count = capacity - length;
+		fits  = false;
+	}
+	memcpy(str + length, value.data(), count);
+	length += count;
+	str[length] = 0;
+	return fits;
+}
@@ -0,0 +1,166 @@
+#include <Arduino.h>
+#include <Task.h>
+
+namespace {
+
+// Written at the bottom of each task stack, to detect a stack overflow.
+const uint32_t STACK_CANARY = 0xC0FFEE42;
+
+const uint32_t STACK_WORDS = TASK_STACK_SIZE / sizeof(uint32_t);
+
+// Only linked in when tasks are started.
+uint32_t taskStacks[TASK_MAX_COUNT][STACK_WORDS] __attribute__((aligned(8)));
+
+#ifdef MICROAPP_HOST_BUILD
+
+void switchContext(ucontext_t* from, ucontext_t* to) {
+	swapcontext(from, to);
+}
+
+#else
+
+/*
+ * Save the callee saved registers on the current stack, store the stack pointer in *from, then switch to the stack
+ * pointer 'to', and restore the registers saved there. The lr popped into pc returns to the caller of the switch that
+ * saved them, or to the task entry for a new stack.
+ */
+__attribute__((naked, noinline)) void switchContext(void** from, void** to) {
+	asm volatile(
+			"push {r4-r11, lr}\n"
+			"vpush {s16-s31}\n"
+			"mov r2, sp\n"
+			"str r2, [r0]\n"
+			"ldr r2, [r1]\n"
+			"mov sp, r2\n"
+			"vpop {s16-s31}\n"
+			"pop {r4-r11, pc}\n");
+}
+
+// Registers saved by switchContext(): s16-s31, r4-r11, lr.
+const uint8_t SAVED_REGISTER_WORDS = 16 + 8 + 1;
+
+#endif
+
+// Whether a task that sleeps until a time in ms can continue: at the first resume at or after that time.
+bool isAwake(uint32_t wakeMs, uint32_t nowMs) {
+	return (int32_t)(wakeMs - nowMs) <= 0;
+}
+
+}  // namespace
+
+int8_t TaskClass::start(TaskFunction function) {
+	if (function == nullptr) {
+		return TASK_ID_NONE;
+	}
+	for (int8_t id = 0; id < TASK_MAX_COUNT; ++id) {
+		TaskControlBlock& task = _tasks[id];
+		if (task.state != TASK_FREE) {
+			continue;
+		}
+		task.function = function;
+		task.stack    = taskStacks[id];
+		task.stack[0] = STACK_CANARY;
+#ifdef MICROAPP_HOST_BUILD
+		getcontext(&task.context);
+		task.context.uc_stack.ss_sp   = task.stack;
+		task.context.uc_stack.ss_size = TASK_STACK_SIZE;
+		task.context.uc_link          = nullptr;
+		makecontext(&task.context, entry, 0);
+#else
+		// Registers as switchContext() saves them, with entry() as return address.
+		uint32_t* sp = task.stack + STACK_WORDS - SAVED_REGISTER_WORDS;
+		for (uint8_t i = 0; i < SAVED_REGISTER_WORDS - 1; ++i) {
+			sp[i] = 0;
+		}
+		sp[SAVED_REGISTER_WORDS - 1] = (uint32_t)reinterpret_cast<uintptr_t>(&entry);
+		task.context                 = sp;
+#endif
+		task.state = TASK_READY;
+		return id;
+	}
+	return TASK_ID_NONE;
+}
+
+bool TaskClass::isRunning(int8_t id) {
+	return id >= 0 && id < TASK_MAX_COUNT && _tasks[id].state != TASK_FREE;
+}
+
+void TaskClass::run() {
+	if (inTask() || _running || interruptDepth() != 0) {
+		return;
+	}
+	_running       = true;
+	bool timeKnown = false;
+	uint32_t nowMs = 0;
+	for (int8_t id = 0; id < TASK_MAX_COUNT; ++id) {
+		TaskControlBlock& task = _tasks[id];
+		if (task.state == TASK_SLEEPING) {
+			// Only get the time when needed.
+			if (!timeKnown) {
+				nowMs     = millis();
+				timeKnown = true;
+			}
+			if (isAwake(task.wakeMs, nowMs)) {
+				task.state = TASK_READY;
+			}
+		}
+		if (task.state == TASK_READY) {
+			resume(id);
+		}
+	}
+	_running = false;
+}
+
+void TaskClass::resume(int8_t id) {
+	TaskControlBlock& task = _tasks[id];
+	while (true) {
+		_current = id;
+		switchContext(&_mainContext, &task.context);
+		_current = TASK_ID_MAIN;
+		if (task.stack[0] != STACK_CANARY) {
+			// Memory below the stack may be overwritten: stop the task before it does more damage.
+			task.state = TASK_FREE;
+			return;
+		}
+		if (task.state != TASK_CALLING_MAIN) {
+			return;
+		}
+		task.mainFunction(task.mainArg);
+		task.state = TASK_READY;
+	}
+}
+
+void TaskClass::suspend() {
+	switchContext(&_tasks[_current].context, &_mainContext);
+}
+
+void TaskClass::sleepUntil(uint32_t wakeMs) {
+	if (!inTask()) {
+		return;
+	}
+	TaskControlBlock& task = _tasks[_current];
+	task.wakeMs            = wakeMs;
+	task.state             = TASK_SLEEPING;
+	suspend();
+}
+
+void TaskClass::runOnMainStack(void (*function)(void*), void* arg) {
+	if (!inTask()) {
+		function(arg);
+		return;
+	}
+	TaskControlBlock& task = _tasks[_current];
+	task.mainFunction      = function;
+	task.mainArg           = arg;
+	task.state             = TASK_CALLING_MAIN;
+	suspend();
+}
+
+void TaskClass::entry() {
+	TaskClass& tasks       = Tasks;
+	TaskControlBlock& task = tasks._tasks[tasks._current];
+	task.function();
+	// The stack can be used by a new task: this one is never resumed.
+	task.state = TASK_FREE;
+	tasks.suspend();
+}
@@ -0,0 +1,93 @@
+#include <Timer.h>
+
+namespace {
+
+uint32_t millisecondsToTicks(uint32_t ms) {
+	uint32_t ticks = ms / MICROAPP_LOOP_INTERVAL_MS + (ms % MICROAPP_LOOP_INTERVAL_MS != 0);
+	return (ticks == 0) ? 1 : ticks;
+}
+
+// Whether a deadline has passed, also when the tick counter wraps around.
+bool isDue(uint32_t deadline, uint32_t now) {
+	return (int32_t)(now - deadline) >= 0;
+}
+
+}  // namespace
+
+int8_t TimerClass::every(uint32_t intervalMs, TimerCallback callback) {
+	return schedule(intervalMs, true, callback);
+}
+
+int8_t TimerClass::after(uint32_t delayMs, TimerCallback callback) {
+	return schedule(delayMs, false, callback);
+}
+
+int8_t TimerClass::schedule(uint32_t delayMs, bool periodic, TimerCallback callback) {
+	if (callback == nullptr) {
+		return TIMER_ID_NONE;
+	}
+	for (int8_t id = 0; id < TIMER_MAX_COUNT; ++id) {
+		TimerEntry& timer = _timers[id];
+		if (timer.callback == nullptr) {
+			uint32_t ticks = millisecondsToTicks(delayMs);
+			timer.callback = callback;
+			timer.deadline = getLoopTickCount() + ticks;
+			timer.period   = periodic ? ticks : 0;
+			timer.sequence = _scheduleCount++;
+			return id;
+		}
+	}
+	return TIMER_ID_NONE;
+}
+
+bool TimerClass::cancel(int8_t id) {
+	if (!isScheduled(id)) {
+		return false;
+	}
+	_timers[id].callback = nullptr;
+	return true;
+}
+
+bool TimerClass::isScheduled(int8_t id) {
+	return id >= 0 && id < TIMER_MAX_COUNT && _timers[id].callback != nullptr;
+}
+
+int8_t TimerClass::nextDueTimer(uint32_t now) {
+	int8_t next = TIMER_ID_NONE;
+	for (int8_t id = 0; id < TIMER_MAX_COUNT; ++id) {
+		const TimerEntry& timer = _timers[id];
+		if (timer.callback == nullptr || !isDue(timer.deadline, now)) {
+			continue;
+		}
+		if (next == TIMER_ID_NONE) {
+			next = id;
+			continue;
+		}
+		// Compare the differences, as the tick and schedule counters wrap around.
+		int32_t later = (int32_t)(timer.deadline - _timers[next].deadline);
+		if (later < 0 || (later == 0 && (int16_t)(timer.sequence - _timers[next].sequence) < 0)) {
+			next = id;
+		}
+	}
+	return next;
+}
+
+void TimerClass::run() {
+	uint32_t now = getLoopTickCount();
+	int8_t id;
+	// A periodic timer is rescheduled before its callback is called, so each timer is called at most once per run.
+	while ((id = nextDueTimer(now)) != TIMER_ID_NONE) {
+		TimerEntry& timer      = _timers[id];
+		TimerCallback callback = timer.callback;
+		if (timer.period == 0) {
+			timer.callback = nullptr;
+		}
+		else {
+			timer.deadline += timer.period;
+			if (isDue(timer.deadline, now)) {
+				timer.deadline = now + timer.period;
+			}
+		}
+		callback();
+	}
+}
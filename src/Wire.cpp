@@ -14,8 +14,8 @@ int WireBase_::write(const char* str) {
 	return _write(reinterpret_cast<const uint8_t*>(str), strlen(str), Type::Str);
 }
 
-int WireBase_::write(String str, int length) {
-	return _write(reinterpret_cast<const uint8_t*>(str.c_str()), length, Type::Str);
+int WireBase_::write(StringView str, int length) {
+	return _write(reinterpret_cast<const uint8_t*>(str.data()), length, Type::Str);
 }
 
 int WireBase_::write(const uint8_t* buf, int length) {
@@ -30,7 +30,7 @@ int WireBase_::send(const char* str) {
 	return write(str);
 }
 
-int WireBase_::send(String str, int length) {
+int WireBase_::send(StringView str, int length) {
 	return write(str, length);
 }
 
@@ -53,21 +53,102 @@ void WireBase_::begin() {
 // }
 
 void WireBase_::beginTransmission(const uint8_t address) {
-	_address = address;
+	flush();
+	_address       = address;
+	_transmitting  = true;
+	_writeLen      = 0;
+	_writeOverflow = false;
 }
 
-void WireBase_::endTransmission() {
-	// dummy for now
+uint8_t WireBase_::endTransmission(bool stop) {
+	if (!_transmitting) {
+		return 4;
+	}
+	_transmitting = false;
+	if (_writeOverflow) {
+		_writeLen = 0;
+		return 1;
+	}
+	if (!stop) {
+		_writePending = true;
+		return 0;
+	}
+	if (_sendWrite(_address, _writeBuf, _writeLen, true) != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		return 4;
+	}
+	return 0;
+}
+
+void WireBase_::flush() {
+	if (!_writePending) {
+		return;
+	}
+	_writePending = false;
+	_sendWrite(_address, _writeBuf, _writeLen, true);
+}
+
+int WireBase_::requestFrom(const uint8_t address, const int size, bool stop) {
+	if (_writePending && address == _address) {
+		_writePending = false;
+		return _transfer(address, _writeBuf, _writeLen, size, stop);
+	}
+	flush();
+	return _transfer(address, nullptr, 0, size, stop);
+}
+
+int WireBase_::writeThenRead(const uint8_t address, const uint8_t reg, uint8_t* buf, int length) {
+	return writeThenRead(address, &reg, 1, buf, length);
+}
+
+int WireBase_::writeThenRead(
+		const uint8_t address, const uint8_t* writeBuf, int writeLength, uint8_t* readBuf, int readLength) {
+	flush();
+	if (writeLength > WIRE_MAX_PAYLOAD_LENGTH) {
+		return 0;
+	}
+	int length = _transfer(address, writeBuf, writeLength, readLength, true);
+	for (int i = 0; i < length; ++i) {
+		readBuf[i] = _readBuf[i];
+	}
+	_readPtr = length;
+	return length;
+}
+
+microapp_sdk_result_t WireBase_::_sendWrite(uint8_t address, const uint8_t* buf, int length, bool stop) {
+	if (length == 0) {
+		// Nothing to send.
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	uint8_t* payload               = getOutgoingMessagePayload();
+	microapp_sdk_twi_t* twiRequest = reinterpret_cast<microapp_sdk_twi_t*>(payload);
+	twiRequest->header.messageType = CS_MICROAPP_SDK_TYPE_TWI;
+	twiRequest->header.ack         = CS_MICROAPP_SDK_ACK_REQUEST;
+	twiRequest->address            = address;
+	twiRequest->type               = CS_MICROAPP_SDK_TWI_WRITE;
+	twiRequest->flags              = stop ? CS_MICROAPP_SDK_TWI_FLAG_STOP : CS_MICROAPP_SDK_TWI_FLAG_CLEAR;
+	twiRequest->size               = length;
+	for (int i = 0; i < length; ++i) {
+		twiRequest->buf[i] = buf[i];
+	}
+	sendMessage();
+	return (microapp_sdk_result_t)twiRequest->header.ack;
 }
 
-void WireBase_::requestFrom(const uint8_t address, const int size, bool stop) {
+int WireBase_::_transfer(uint8_t address, const uint8_t* writeBuf, int writeLen, int readLen, bool stop) {
+	if (readLen > WIRE_MAX_PAYLOAD_LENGTH) {
+		readLen = WIRE_MAX_PAYLOAD_LENGTH;
+	}
+	// In a batch, the write is queued, and the read sends it along, unless a batch was started by the caller already.
+	bool batchStarted = (writeLen > 0 && beginBatch() == CS_MICROAPP_SDK_ACK_SUCCESS);
+	microapp_sdk_result_t writeResult = _sendWrite(address, writeBuf, writeLen, false);
+
 	uint8_t* payload               = getOutgoingMessagePayload();
 	microapp_sdk_twi_t* twiRequest = reinterpret_cast<microapp_sdk_twi_t*>(payload);
 	twiRequest->header.messageType = CS_MICROAPP_SDK_TYPE_TWI;
 	twiRequest->header.ack         = CS_MICROAPP_SDK_ACK_REQUEST;
 	twiRequest->address            = address;
 	twiRequest->type               = CS_MICROAPP_SDK_TWI_READ;
-	twiRequest->size               = size;
+	twiRequest->size               = readLen;
 	twiRequest->flags              = CS_MICROAPP_SDK_TWI_FLAG_CLEAR;
 	if (stop) {
 		twiRequest->flags |= CS_MICROAPP_SDK_TWI_FLAG_STOP;
@@ -83,6 +164,17 @@ void WireBase_::requestFrom(const uint8_t address, const int size, bool stop) {
 	for (int i = 0; i < _readLen; ++i) {
 		_readBuf[i] = twiRequest->buf[i];
 	}
+	if (batchStarted) {
+		// Gets the result of the write, when it was sent in the batch.
+		microapp_sdk_result_t batchResult = commitBatch();
+		if (writeResult == CS_MICROAPP_SDK_ACK_SUCCESS) {
+			writeResult = batchResult;
+		}
+	}
+	if (writeResult != CS_MICROAPP_SDK_ACK_SUCCESS) {
+		_readLen = 0;
+	}
+	return _readLen;
 }
 
 int WireBase_::available() {
@@ -107,37 +199,37 @@ const uint8_t WireBase_::read() {
 // than silently fail.
 //
 int WireBase_::_write(const uint8_t* buf, int length, Type type) {
-	if (length == 0) {
+	if (length <= 0) {
 		// Nothing to send.
 		return 0;
 	}
 
-	uint8_t* payload               = getOutgoingMessagePayload();
-	microapp_sdk_twi_t* twiRequest = reinterpret_cast<microapp_sdk_twi_t*>(payload);
-	twiRequest->header.messageType = CS_MICROAPP_SDK_TYPE_TWI;
-	twiRequest->header.ack         = CS_MICROAPP_SDK_ACK_REQUEST;
-	twiRequest->address            = _address;
-	twiRequest->type               = CS_MICROAPP_SDK_TWI_WRITE;
-	twiRequest->flags              = CS_MICROAPP_SDK_TWI_FLAG_STOP;
-
 	// Make sure length is not too large.
 	if (type == Type::Str && length > WIRE_MAX_STRING_LENGTH) {
 		length = WIRE_MAX_STRING_LENGTH;
 	}
 
-	// Make sure that in all cases that length is truncated. Do not silently fail.
-	if (length > WIRE_MAX_PAYLOAD_LENGTH) {
-		length = WIRE_MAX_PAYLOAD_LENGTH;
+	if (_transmitting) {
+		// Buffer until endTransmission().
+		if (length > WIRE_MAX_PAYLOAD_LENGTH - _writeLen) {
+			length         = WIRE_MAX_PAYLOAD_LENGTH - _writeLen;
+			_writeOverflow = true;
+		}
+		for (int i = 0; i < length; ++i) {
+			_writeBuf[_writeLen++] = buf[i];
+		}
+		return length;
 	}
 
-	twiRequest->size = length;
+	// Without beginTransmission(), write immediately.
+	flush();
 
-	// Copy the data.
-	for (int i = 0; i < length; ++i) {
-		twiRequest->buf[i] = buf[i];
+	// Make sure that in all cases that length is truncated. Do not silently fail.
+	if (length > WIRE_MAX_PAYLOAD_LENGTH) {
+		length = WIRE_MAX_PAYLOAD_LENGTH;
 	}
 
 	// TODO: check result.
-	sendMessage();
+	_sendWrite(_address, buf, length, true);
 	return length;
 }
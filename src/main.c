@@ -1,4 +1,9 @@
 #include <Arduino.h>
+#include <BleRequest.h>
+#include <Mesh.h>
+#include <MeshTransport.h>
+#include <Task.h>
+#include <Timer.h>
 #include <ipc/cs_IpcRamData.h>
 #include <microapp.h>
 
@@ -6,14 +11,19 @@
 extern "C" {
 #endif
 
-#if __SIZEOF_POINTER__ != 4
+#if __SIZEOF_POINTER__ != 4 && !defined(MICROAPP_HOST_BUILD)
 #warning "Incorrect uintptr_t type"
 #endif
 
 /*
- * Yield to bluenet and indicate end of setup
+ * Complete BLE requests that finished while they were sent, send buffered logs and TWI writes, then yield to bluenet
+ * and indicate end of setup
  */
 void signalSetupEnd() {
+	getBleRequestTable().completeDeferred();
+	Serial.flush();
+	Wire.flush();
+
 	uint8_t* payload            = getOutgoingMessagePayload();
 	microapp_sdk_yield_t* yield = reinterpret_cast<microapp_sdk_yield_t*>(payload);
 	yield->header.ack           = CS_MICROAPP_SDK_ACK_NO_REQUEST;
@@ -24,9 +34,19 @@ void signalSetupEnd() {
 }
 
 /*
- * Yield to bluenet and indicate end of loop
+ * Send queued requests, then yield to bluenet and indicate end of loop
  */
 void signalLoopEnd() {
+	// Complete BLE requests that finished while they were sent, and reads of which the next part did not come in.
+	// Their handlers may send more requests
+	getBleRequestTable().completeDeferred();
+	getBleRequestTable().completeStalledReads();
+	// Send mesh messages that were packed or queued during the loop or by interrupt handlers
+	MeshTransport.flush();
+	Mesh.flushMeshMsgQueue();
+	Serial.flush();
+	Wire.flush();
+
 	uint8_t* payload            = getOutgoingMessagePayload();
 	microapp_sdk_yield_t* yield = reinterpret_cast<microapp_sdk_yield_t*>(payload);
 	yield->header.ack           = CS_MICROAPP_SDK_ACK_NO_REQUEST;
@@ -48,6 +68,8 @@ int __attribute__((optimize("O0"))) dummy_main() {
 	signalSetupEnd();
 	while (1) {
 		loop();
+		Timer.run();
+		Tasks.run();
 		signalLoopEnd();
 	}
 	// will not be reached
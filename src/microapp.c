@@ -1,3 +1,4 @@
+#include <Task.h>
 #include <ipc/cs_IpcRamData.h>
 #include <microapp.h>
 
@@ -10,14 +11,57 @@ const uint8_t MICROAPP_IPC_CURRENT_PROTOCOL_VERSION           = 1;
 // Important: Do not include <string.h> / <cstring>. This bloats up the binary unnecessary.
 // On Arduino there is the String class. Roll your own functions like strlen, see below.
 
+// The functions below copy or compare a word (4 bytes) at a time where possible. This only works when both pointers
+// can be word aligned at the same time, i.e. when they have the same offset from a word boundary. A few bytes are
+// handled one by one before (head) and after (tail) the aligned words.
+
+typedef uint32_t microapp_word_t;
+
+const uintptr_t WORD_MASK = sizeof(microapp_word_t) - 1;
+
+// Below this size, the byte loops are faster than aligning the pointers first
+const microapp_size_t WORD_ACCESS_MIN_SIZE = 8;
+
+// Do not let the compiler replace the loops below by calls to memcpy or memset, i.e. to themselves
+#define NO_LIBCALL_LOOPS __attribute__((optimize("no-tree-loop-distribute-patterns")))
+
+// Evaluates to nonzero if any of the bytes in the word is zero
+#define HAS_ZERO_BYTE(word) ((((word) - 0x01010101UL) & ~(word)) & 0x80808080UL)
+
+static inline bool isWordAligned(const void* ptr) {
+	return ((uintptr_t)ptr & WORD_MASK) == 0;
+}
+
+static inline bool haveSameAlignment(const void* ptr1, const void* ptr2) {
+	return (((uintptr_t)ptr1 ^ (uintptr_t)ptr2) & WORD_MASK) == 0;
+}
+
 // returns size MAX_STRING_SIZE for strings that are too long, note that this can still not fit in the payload
 // the actually supported string length depends on the opcode
 // the limit here is just to prevent looping forever
-uint8_t strlen(const char* str) {
-	for (microapp_size_t i = 0; i < MAX_STRING_SIZE; ++i) {
+NO_LIBCALL_LOOPS uint8_t strlen(const char* str) {
+	microapp_size_t i = 0;
+	// Bytes up to the first word boundary
+	while (!isWordAligned(str + i) && i < MAX_STRING_SIZE) {
+		if (str[i] == 0) {
+			return i;
+		}
+		i++;
+	}
+	// An aligned word never crosses a page or memory boundary, so it's fine to read past the end of the string here
+	while (i < MAX_STRING_SIZE) {
+		microapp_word_t word = *(const microapp_word_t*)(str + i);
+		if (HAS_ZERO_BYTE(word)) {
+			break;
+		}
+		i += sizeof(microapp_word_t);
+	}
+	// Find the zero byte in the last word
+	while (i < MAX_STRING_SIZE) {
 		if (str[i] == 0) {
 			return i;
 		}
+		i++;
 	}
 	return MAX_STRING_SIZE;
 }
@@ -26,30 +70,134 @@ uint8_t strlen(const char* str) {
 // returns 0 if ptr1 and ptr2 are equal
 // returns -1 if for the first unmatching byte i we have ptr1[i] < ptr2[i]
 // returns 1 if for the first unmatching byte i we have ptr1[i] > ptr2[i]
-int memcmp(const void* ptr1, const void* ptr2, microapp_size_t num) {
-	char* p = (char*)ptr1;
-	char* q = (char*)ptr2;
+NO_LIBCALL_LOOPS int memcmp(const void* ptr1, const void* ptr2, microapp_size_t num) {
+	const uint8_t* p = (const uint8_t*)ptr1;
+	const uint8_t* q = (const uint8_t*)ptr2;
 	if (ptr1 == ptr2) {  // point to the same address
 		return 0;
 	}
-	for (microapp_size_t i = 0; i < num; ++i) {
-		if (*(p + i) < *(q + i)) {
-			return -1;
+	if (num >= WORD_ACCESS_MIN_SIZE && haveSameAlignment(p, q)) {
+		while (!isWordAligned(p)) {
+			if (*p != *q) {
+				return (*p < *q) ? -1 : 1;
+			}
+			p++;
+			q++;
+			num--;
+		}
+		// Skip equal words, the first unequal word is compared byte by byte below
+		while (num >= sizeof(microapp_word_t)) {
+			if (*(const microapp_word_t*)p != *(const microapp_word_t*)q) {
+				break;
+			}
+			p += sizeof(microapp_word_t);
+			q += sizeof(microapp_word_t);
+			num -= sizeof(microapp_word_t);
 		}
-		else if (*(p + i) > *(q + i)) {
-			return 1;
+	}
+	for (microapp_size_t i = 0; i < num; ++i) {
+		if (p[i] != q[i]) {
+			return (p[i] < q[i]) ? -1 : 1;
 		}
 	}
 	return 0;
 }
 
-void* memcpy(void* dest, const void* src, microapp_size_t num) {
-	uint8_t* p = (uint8_t*)src;
-	uint8_t* q = (uint8_t*)dest;
-	for (microapp_size_t i = 0; i < num; ++i) {
-		*q = *p;
-		p++;
-		q++;
+NO_LIBCALL_LOOPS void* memcpy(void* dest, const void* src, microapp_size_t num) {
+	const uint8_t* p = (const uint8_t*)src;
+	uint8_t* q       = (uint8_t*)dest;
+	if (num >= WORD_ACCESS_MIN_SIZE && haveSameAlignment(p, q)) {
+		// Align the destination, which aligns the source too
+		while (!isWordAligned(q)) {
+			*q++ = *p++;
+			num--;
+		}
+		microapp_word_t* qWord       = (microapp_word_t*)q;
+		const microapp_word_t* pWord = (const microapp_word_t*)p;
+		// Copy 4 words per iteration, this results in LDM/STM instructions
+		while (num >= 4 * sizeof(microapp_word_t)) {
+			microapp_word_t w0 = pWord[0];
+			microapp_word_t w1 = pWord[1];
+			microapp_word_t w2 = pWord[2];
+			microapp_word_t w3 = pWord[3];
+			qWord[0]           = w0;
+			qWord[1]           = w1;
+			qWord[2]           = w2;
+			qWord[3]           = w3;
+			pWord += 4;
+			qWord += 4;
+			num -= 4 * sizeof(microapp_word_t);
+		}
+		while (num >= sizeof(microapp_word_t)) {
+			*qWord++ = *pWord++;
+			num -= sizeof(microapp_word_t);
+		}
+		p = (const uint8_t*)pWord;
+		q = (uint8_t*)qWord;
+	}
+	while (num > 0) {
+		*q++ = *p++;
+		num--;
+	}
+	return dest;
+}
+
+NO_LIBCALL_LOOPS void* memmove(void* dest, const void* src, microapp_size_t num) {
+	const uint8_t* p = (const uint8_t*)src;
+	uint8_t* q       = (uint8_t*)dest;
+	if (q <= p || q >= p + num) {
+		// Copying from front to back is safe
+		return memcpy(dest, src, num);
+	}
+	// Destination overlaps the end of the source: copy from back to front
+	p += num;
+	q += num;
+	if (num >= WORD_ACCESS_MIN_SIZE && haveSameAlignment(p, q)) {
+		while (!isWordAligned(q)) {
+			*--q = *--p;
+			num--;
+		}
+		while (num >= sizeof(microapp_word_t)) {
+			q -= sizeof(microapp_word_t);
+			p -= sizeof(microapp_word_t);
+			*(microapp_word_t*)q = *(const microapp_word_t*)p;
+			num -= sizeof(microapp_word_t);
+		}
+	}
+	while (num > 0) {
+		*--q = *--p;
+		num--;
+	}
+	return dest;
+}
+
+NO_LIBCALL_LOOPS void* memset(void* dest, int value, microapp_size_t num) {
+	uint8_t* q   = (uint8_t*)dest;
+	uint8_t byte = (uint8_t)value;
+	if (num >= WORD_ACCESS_MIN_SIZE) {
+		while (!isWordAligned(q)) {
+			*q++ = byte;
+			num--;
+		}
+		microapp_word_t word   = byte * 0x01010101UL;
+		microapp_word_t* qWord = (microapp_word_t*)q;
+		while (num >= 4 * sizeof(microapp_word_t)) {
+			qWord[0] = word;
+			qWord[1] = word;
+			qWord[2] = word;
+			qWord[3] = word;
+			qWord += 4;
+			num -= 4 * sizeof(microapp_word_t);
+		}
+		while (num >= sizeof(microapp_word_t)) {
+			*qWord++ = word;
+			num -= sizeof(microapp_word_t);
+		}
+		q = (uint8_t*)qWord;
+	}
+	while (num > 0) {
+		*q++ = byte;
+		num--;
 	}
 	return dest;
 }
@@ -65,20 +213,14 @@ static bluenet_io_buffers_t shared_io_buffers;
  */
 static bluenet_ipc_data_cpp_t ipc_data;
 
-uint8_t* getOutgoingMessagePayload() {
-	return shared_io_buffers.microapp2bluenet.payload;
-}
-
-uint8_t* getIncomingMessagePayload() {
-	return shared_io_buffers.bluenet2microapp.payload;
-}
-
 /*
  * Struct that stores copies of the shared io buffer
  */
 struct stack_entry_t {
 	bluenet_io_buffers_t ioBuffer;
 	bool filled;
+	// Whether the outgoing buffer of the interrupted context has been copied to this entry
+	bool outgoingSaved;
 };
 
 /*
@@ -94,6 +236,37 @@ static stack_entry_t stack[MAX_INTERRUPT_DEPTH];
 
 static bool stack_initialized = false;
 
+/*
+ * Index of the stack entry of the interrupt that is currently being handled, or -1 if none.
+ */
+static int8_t topStackIndex = -1;
+
+/*
+ * Copy the outgoing buffer of the interrupted context to the stack, before the interrupt handler modifies it.
+ *
+ * This is done lazily, so that interrupt handlers that do not make requests do not pay for the copy.
+ */
+static void saveOutgoingMessagePayload() {
+	if (topStackIndex < 0) {
+		return;
+	}
+	stack_entry_t* entry = &stack[topStackIndex];
+	if (entry->outgoingSaved) {
+		return;
+	}
+	memcpy(entry->ioBuffer.microapp2bluenet.payload, shared_io_buffers.microapp2bluenet.payload, MICROAPP_SDK_MAX_PAYLOAD);
+	entry->outgoingSaved = true;
+}
+
+uint8_t* getOutgoingMessagePayload() {
+	saveOutgoingMessagePayload();
+	return shared_io_buffers.microapp2bluenet.payload;
+}
+
+uint8_t* getIncomingMessagePayload() {
+	return shared_io_buffers.bluenet2microapp.payload;
+}
+
 // Cache whether the IPC ram data from bluenet is valid.
 static bool ipcValid = false;
 
@@ -168,6 +341,96 @@ int8_t getNextEmptyStackSlot() {
 	return -1;
 }
 
+/*
+ * Returns the number of bytes of the incoming buffer that are used by the interrupt.
+ */
+microapp_size_t getInterruptSize(microapp_sdk_header_t* header) {
+	microapp_size_t size = MICROAPP_SDK_MAX_PAYLOAD;
+	switch (header->messageType) {
+		case CS_MICROAPP_SDK_TYPE_PIN: {
+			size = sizeof(microapp_sdk_pin_t);
+			break;
+		}
+		case CS_MICROAPP_SDK_TYPE_BLE: {
+			auto ble = reinterpret_cast<microapp_sdk_ble_t*>(header);
+			if (ble->type == CS_MICROAPP_SDK_BLE_SCAN && ble->scan.type == CS_MICROAPP_SDK_BLE_SCAN_EVENT_SCAN) {
+				size = (ble->scan.eventScan.data - reinterpret_cast<uint8_t*>(header)) + ble->scan.eventScan.size;
+			}
+			break;
+		}
+		case CS_MICROAPP_SDK_TYPE_MESH: {
+			auto mesh = reinterpret_cast<microapp_sdk_mesh_t*>(header);
+			size      = (mesh->data - reinterpret_cast<uint8_t*>(header)) + mesh->size;
+			break;
+		}
+		case CS_MICROAPP_SDK_TYPE_MESSAGE: {
+			auto message = reinterpret_cast<microapp_sdk_message_t*>(header);
+			if (message->type == CS_MICROAPP_SDK_MSG_EVENT_RECEIVED_MSG) {
+				size = (message->receivedMessage.data - reinterpret_cast<uint8_t*>(header))
+					   + message->receivedMessage.size;
+			}
+			break;
+		}
+		default: break;
+	}
+	if (size > MICROAPP_SDK_MAX_PAYLOAD) {
+		size = MICROAPP_SDK_MAX_PAYLOAD;
+	}
+	return size;
+}
+
+// Number of yields to bluenet outside of interrupt handlers
+static uint32_t loopTickCount = 0;
+
+// Whether the message that is sent finishes an interrupt, rather than being a request or yield of its own
+static bool sendingInterruptResult = false;
+
+uint32_t getLoopTickCount() {
+	return loopTickCount;
+}
+
+enum TimeSupport {
+	TIME_SUPPORT_UNKNOWN = 0,
+	TIME_SUPPORT_YES,
+	TIME_SUPPORT_NO,
+};
+
+// Whether bluenet supports time requests: only known after the first one
+static TimeSupport timeSupport = TIME_SUPPORT_UNKNOWN;
+
+// Time received from bluenet, valid until the microapp yields again
+static bool cachedTimeValid    = false;
+static uint32_t cachedUptimeMs = 0;
+static uint16_t cachedUptimeUs = 0;
+
+bool getUptime(uint32_t* ms, uint16_t* us) {
+	if (!cachedTimeValid && timeSupport != TIME_SUPPORT_NO) {
+		auto request                = reinterpret_cast<microapp_sdk_time_t*>(getOutgoingMessagePayload());
+		request->header.messageType = MICROAPP_SDK_TYPE_TIME;
+		request->header.ack         = CS_MICROAPP_SDK_ACK_REQUEST;
+		microapp_sdk_result_t result = sendMessage();
+		if (result == CS_MICROAPP_SDK_ACK_SUCCESS && request->header.ack == CS_MICROAPP_SDK_ACK_SUCCESS) {
+			timeSupport    = TIME_SUPPORT_YES;
+			cachedUptimeMs = request->uptimeMs;
+			cachedUptimeUs = request->uptimeUs;
+			// Set after sendMessage(), which invalidates the cache.
+			cachedTimeValid = true;
+		}
+		else if (timeSupport == TIME_SUPPORT_UNKNOWN) {
+			// Older bluenet versions answer with any error, or leave the ack at request.
+			timeSupport = TIME_SUPPORT_NO;
+		}
+	}
+	if (!cachedTimeValid) {
+		*ms = loopTickCount * MICROAPP_LOOP_INTERVAL_MS;
+		*us = 0;
+		return false;
+	}
+	*ms = cachedUptimeMs;
+	*us = cachedUptimeUs;
+	return true;
+}
+
 /*
  * Handle incoming interrupts from bluenet
  */
@@ -198,16 +461,16 @@ void handleBluenetInterrupt() {
 		sendMessage();
 		return;
 	}
-	// Copy the shared buffers to the top of the stack
-	stack_entry_t* newStackEntry = &stack[stackIndex];
-	uint8_t* outgoingPayload     = getOutgoingMessagePayload();
-	// Copying the outgoing buffer is needed so that the outgoing buffer can be freely used
-	// for microapp requests during the interrupt handling
-	memcpy(newStackEntry->ioBuffer.microapp2bluenet.payload, outgoingPayload, MICROAPP_SDK_MAX_PAYLOAD);
-	// Copying the incoming buffer is needed so that the interrupt payload is preserved
+	// Copy the incoming buffer to the top of the stack, so that the interrupt payload is preserved
 	// if bluenet generates another interrupt before finishing handling this one
-	memcpy(newStackEntry->ioBuffer.bluenet2microapp.payload, incomingPayload, MICROAPP_SDK_MAX_PAYLOAD);
-	newStackEntry->filled = true;
+	// Only the part of the payload that is in use is copied
+	stack_entry_t* newStackEntry = &stack[stackIndex];
+	memcpy(newStackEntry->ioBuffer.bluenet2microapp.payload, incomingPayload, getInterruptSize(incomingHeader));
+	newStackEntry->filled        = true;
+	// The outgoing buffer is only copied when the interrupt handler uses it, see getOutgoingMessagePayload()
+	newStackEntry->outgoingSaved = false;
+	int8_t previousStackIndex    = topStackIndex;
+	topStackIndex                = stackIndex;
 
 	// Mark the incoming ack as 'in progress' so bluenet will keep calling
 	incomingHeader->ack = CS_MICROAPP_SDK_ACK_IN_PROGRESS;
@@ -220,47 +483,389 @@ void handleBluenetInterrupt() {
 	microapp_sdk_result_t result = handleInterrupt(stackEntryHeader);
 
 	// When done with the interrupt handling, we can pop the buffers from the stack again
-	// Though really we only need the outgoing buffer, since we just finished dealing with the incoming buffer
-	memcpy(outgoingPayload, newStackEntry->ioBuffer.microapp2bluenet.payload, MICROAPP_SDK_MAX_PAYLOAD);
+	// Only the outgoing buffer has to be restored, and only if the interrupt handler used it
+	if (newStackEntry->outgoingSaved) {
+		memcpy(shared_io_buffers.microapp2bluenet.payload,
+			   newStackEntry->ioBuffer.microapp2bluenet.payload,
+			   MICROAPP_SDK_MAX_PAYLOAD);
+	}
 	newStackEntry->filled = false;
+	topStackIndex         = previousStackIndex;
 
 	// End with a sendMessage call which yields back to bluenet
 	// Bluenet will see the acknowledge and not call again
-	incomingHeader->ack = result;
+	incomingHeader->ack    = result;
+	sendingInterruptResult = true;
 	sendMessage();
 	return;
 }
 
+/*
+ * Requests queued by beginBatch(), in the format of microapp_sdk_batch_t.
+ */
+static microapp_sdk_batch_t batch;
+
+static microapp_size_t batchSize = 0;
+
+// Whether a batch has been started
+static bool batchActive = false;
+
+// Requests are only batched at the interrupt depth at which the batch was started
+static uint8_t batchDepth = 0;
+
+// Result of the first batched request that failed
+static microapp_sdk_result_t batchResult = CS_MICROAPP_SDK_ACK_SUCCESS;
+
+enum BatchSupport {
+	BATCH_SUPPORT_UNKNOWN = 0,
+	BATCH_SUPPORT_YES,
+	BATCH_SUPPORT_NO,
+};
+
+// Whether bluenet handles batches, determined at the first batch
+static BatchSupport batchSupport = BATCH_SUPPORT_UNKNOWN;
+
+uint8_t interruptDepth() {
+	return MAX_INTERRUPT_DEPTH - emptySlotsInStack();
+}
+
+/*
+ * Returns the size of a request when it can be batched, or 0 when the result of the request is needed by the caller.
+ */
+microapp_size_t getBatchableRequestSize(microapp_sdk_header_t* header) {
+	switch (header->messageType) {
+		case CS_MICROAPP_SDK_TYPE_LOG: {
+			auto log = reinterpret_cast<microapp_sdk_log_header_t*>(header);
+			return sizeof(microapp_sdk_log_header_t) + log->size;
+		}
+		case CS_MICROAPP_SDK_TYPE_PIN: {
+			auto pin = reinterpret_cast<microapp_sdk_pin_t*>(header);
+			if (pin->type == CS_MICROAPP_SDK_PIN_ACTION && pin->action == CS_MICROAPP_SDK_PIN_READ) {
+				return 0;
+			}
+			return sizeof(microapp_sdk_pin_t);
+		}
+		case CS_MICROAPP_SDK_TYPE_SWITCH: {
+			auto switchRequest = reinterpret_cast<microapp_sdk_switch_t*>(header);
+			if (switchRequest->type != CS_MICROAPP_SDK_SWITCH_REQUEST_SET) {
+				return 0;
+			}
+			return sizeof(microapp_sdk_switch_t);
+		}
+		case CS_MICROAPP_SDK_TYPE_MESH: {
+			auto mesh = reinterpret_cast<microapp_sdk_mesh_t*>(header);
+			if (mesh->type != CS_MICROAPP_SDK_MESH_SEND || mesh->size > MAX_MICROAPP_MESH_PAYLOAD_SIZE) {
+				return 0;
+			}
+			return sizeof(microapp_sdk_mesh_t) - MAX_MICROAPP_MESH_PAYLOAD_SIZE + mesh->size;
+		}
+		case CS_MICROAPP_SDK_TYPE_TWI: {
+			auto twi = reinterpret_cast<microapp_sdk_twi_t*>(header);
+			if (twi->type != CS_MICROAPP_SDK_TWI_WRITE || twi->size > MICROAPP_SDK_MAX_TWI_PAYLOAD_SIZE) {
+				return 0;
+			}
+			return sizeof(microapp_sdk_twi_header_t) + twi->size;
+		}
+		default: return 0;
+	}
+}
+
+/*
+ * Returns the size of a request whose result is needed by the caller, when it can be the last request of a batch.
+ * Bluenet writes the result in the batch, so the size includes the space for it. Returns 0 for other requests.
+ */
+microapp_size_t getBatchableFinalRequestSize(microapp_sdk_header_t* header) {
+	switch (header->messageType) {
+		case CS_MICROAPP_SDK_TYPE_TWI: {
+			auto twi = reinterpret_cast<microapp_sdk_twi_t*>(header);
+			if (twi->type != CS_MICROAPP_SDK_TWI_READ || twi->size > MICROAPP_SDK_MAX_TWI_PAYLOAD_SIZE) {
+				return 0;
+			}
+			return sizeof(microapp_sdk_twi_header_t) + twi->size;
+		}
+		default: return 0;
+	}
+}
+
+void storeBatchResult(microapp_sdk_result_t result) {
+	if (result != CS_MICROAPP_SDK_ACK_SUCCESS && batchResult == CS_MICROAPP_SDK_ACK_SUCCESS) {
+		batchResult = result;
+	}
+}
+
+/*
+ * Send the batched requests to bluenet, overwriting the outgoing buffer.
+ */
+void sendBatch() {
+	uint8_t* outgoingPayload = getOutgoingMessagePayload();
+	// Requests made by interrupt handlers during the yield are not batched
+	batchActive              = false;
+	if (batchSupport != BATCH_SUPPORT_NO) {
+		batch.header.messageType = MICROAPP_SDK_TYPE_BATCH;
+		batch.header.ack         = CS_MICROAPP_SDK_ACK_REQUEST;
+		memcpy(outgoingPayload, &batch, MICROAPP_SDK_BATCH_HEADER_SIZE + batchSize);
+		sendMessage();
+		auto sentBatch = reinterpret_cast<microapp_sdk_batch_t*>(outgoingPayload);
+		if (sentBatch->header.ack == CS_MICROAPP_SDK_ACK_ERR_UNDEFINED && batchSupport == BATCH_SUPPORT_UNKNOWN) {
+			// Bluenet does not know batches, fall back to sending the requests one by one.
+			batchSupport = BATCH_SUPPORT_NO;
+		}
+		else {
+			batchSupport = BATCH_SUPPORT_YES;
+			for (microapp_size_t offset = 0; offset < batchSize; offset += sentBatch->data[offset] + 1) {
+				auto header = reinterpret_cast<microapp_sdk_header_t*>(&sentBatch->data[offset + 1]);
+				storeBatchResult((microapp_sdk_result_t)header->ack);
+			}
+		}
+	}
+	if (batchSupport == BATCH_SUPPORT_NO) {
+		for (microapp_size_t offset = 0; offset < batchSize; offset += batch.data[offset] + 1) {
+			memcpy(outgoingPayload, &batch.data[offset + 1], batch.data[offset]);
+			sendMessage();
+			storeBatchResult((microapp_sdk_result_t)outgoingPayload[1]);
+		}
+	}
+	batch.count = 0;
+	batchSize   = 0;
+	batchActive = true;
+}
+
+/*
+ * Send the batched requests to bluenet, while keeping the outgoing buffer intact.
+ */
+void flushBatch() {
+	if (batch.count == 0) {
+		return;
+	}
+	uint8_t pendingPayload[MICROAPP_SDK_MAX_PAYLOAD];
+	uint8_t* outgoingPayload = getOutgoingMessagePayload();
+	memcpy(pendingPayload, outgoingPayload, MICROAPP_SDK_MAX_PAYLOAD);
+	sendBatch();
+	memcpy(outgoingPayload, pendingPayload, MICROAPP_SDK_MAX_PAYLOAD);
+}
+
+/*
+ * Add the request in the outgoing buffer to the batch.
+ *
+ * @return true when the request has been added to the batch.
+ */
+bool addToBatch(microapp_sdk_header_t* header) {
+	if (header->messageType == CS_MICROAPP_SDK_TYPE_YIELD || header->ack != CS_MICROAPP_SDK_ACK_REQUEST) {
+		return false;
+	}
+	microapp_size_t size = getBatchableRequestSize(header);
+	if (size == 0 || size + 1 > MICROAPP_SDK_BATCH_MAX_DATA_SIZE) {
+		return false;
+	}
+	if (batchSize + size + 1 > MICROAPP_SDK_BATCH_MAX_DATA_SIZE) {
+		flushBatch();
+	}
+	batch.data[batchSize] = size;
+	memcpy(&batch.data[batchSize + 1], header, size);
+	batchSize += size + 1;
+	batch.count++;
+	header->ack = CS_MICROAPP_SDK_ACK_SUCCESS;
+	return true;
+}
+
+/*
+ * Add the request in the outgoing buffer as last request to the batch, and send the batch. The result of the request
+ * is copied back to the outgoing buffer.
+ *
+ * @return true when the request has been sent with the batch.
+ */
+bool sendBatchWithFinalRequest(microapp_sdk_header_t* header) {
+	if (batch.count == 0 || header->ack != CS_MICROAPP_SDK_ACK_REQUEST) {
+		return false;
+	}
+	microapp_size_t size = getBatchableFinalRequestSize(header);
+	if (size == 0 || batchSize + size + 1 > MICROAPP_SDK_BATCH_MAX_DATA_SIZE) {
+		return false;
+	}
+	microapp_size_t offset = batchSize;
+	batch.data[offset]     = size;
+	memcpy(&batch.data[offset + 1], header, size);
+	batchSize += size + 1;
+	batch.count++;
+	sendBatch();
+	if (batchSupport == BATCH_SUPPORT_YES) {
+		uint8_t* outgoingPayload = getOutgoingMessagePayload();
+		memmove(outgoingPayload, outgoingPayload + MICROAPP_SDK_BATCH_HEADER_SIZE + offset + 1, size);
+	}
+	// Otherwise the requests were sent one by one, and the result of the last one is in the outgoing buffer already.
+	return true;
+}
+
+microapp_sdk_result_t beginBatch() {
+	if (batchActive) {
+		return CS_MICROAPP_SDK_ACK_ERR_BUSY;
+	}
+	batchActive = true;
+	batchDepth  = interruptDepth();
+	batchResult = CS_MICROAPP_SDK_ACK_SUCCESS;
+	batch.count = 0;
+	batchSize   = 0;
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
+}
+
+microapp_sdk_result_t commitBatch() {
+	if (!batchActive) {
+		return CS_MICROAPP_SDK_ACK_ERR_EMPTY;
+	}
+	flushBatch();
+	batchActive = false;
+	return batchResult;
+}
+
+struct bluenet_call_t {
+	uint8_t opcode;
+	bool loopYield;
+	microapp_sdk_result_t result;
+};
+
+/*
+ * Yield control to bluenet, and handle the interrupts it has when it resumes the microapp.
+ */
+static void callBluenet(void* arg) {
+	auto call                                        = reinterpret_cast<bluenet_call_t*>(arg);
+	microappCallbackFunc callbackFunctionIntoBluenet = ipc_data.bluenet2microappData.microappCallback;
+	call->result = callbackFunctionIntoBluenet(call->opcode, &shared_io_buffers);
+	// Time passed while bluenet was running.
+	cachedTimeValid = false;
+
+	if (call->loopYield) {
+		loopTickCount++;
+	}
+
+	// Here the microapp resumes execution, check for incoming interrupts
+	handleBluenetInterrupt();
+}
+
 /*
  * Send the actual message to bluenet
  *
  * If there are no interrupts it will just return and at some later time be called again.
  */
 microapp_sdk_result_t sendMessage() {
+	// Bluenet may write in the outgoing buffer
+	saveOutgoingMessagePayload();
+
+	// Bluenet resumes a yield outside of interrupt handlers after a loop interval
+	auto outgoingHeader    = reinterpret_cast<microapp_sdk_header_t*>(getOutgoingMessagePayload());
+	bool loopYield         = (outgoingHeader->messageType == CS_MICROAPP_SDK_TYPE_YIELD && interruptDepth() == 0
+					  && !sendingInterruptResult);
+	sendingInterruptResult = false;
+
+	if (batchActive && interruptDepth() == batchDepth) {
+		microapp_sdk_header_t* header = reinterpret_cast<microapp_sdk_header_t*>(getOutgoingMessagePayload());
+		if (addToBatch(header)) {
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		if (sendBatchWithFinalRequest(header)) {
+			return CS_MICROAPP_SDK_ACK_SUCCESS;
+		}
+		// Keep the order of requests: first send what has been batched so far.
+		flushBatch();
+	}
+
 	bool checkOnce           = true;
 	microapp_sdk_result_t result = checkRamData(checkOnce);
 	if (result != CS_MICROAPP_SDK_ACK_SUCCESS) {
 		return result;
 	}
 
-	// The callback will yield control to bluenet.
-	microappCallbackFunc callbackFunctionIntoBluenet = ipc_data.bluenet2microappData.microappCallback;
-	uint8_t opcode = checkOnce ? CS_MICROAPP_CALLBACK_SIGNAL : CS_MICROAPP_CALLBACK_UPDATE_IO_BUFFER;
-	result         = callbackFunctionIntoBluenet(opcode, &shared_io_buffers);
+	bluenet_call_t call;
+	call.opcode    = checkOnce ? CS_MICROAPP_CALLBACK_SIGNAL : CS_MICROAPP_CALLBACK_UPDATE_IO_BUFFER;
+	call.loopYield = loopYield;
+	// The stack of a task is small: bluenet, and the interrupt handlers, run on the main stack.
+	if (Tasks.inTask()) {
+		Tasks.runOnMainStack(callBluenet, &call);
+	}
+	else {
+		callBluenet(&call);
+	}
+	return call.result;
+}
 
-	// Here the microapp resumes execution, check for incoming interrupts
-	handleBluenetInterrupt();
+/*
+ * Interrupt registrations are looked up via a hash table, keyed by type and id, so that dispatching an interrupt takes
+ * constant time. Each table entry holds the index of a registration plus one, or 0 when the entry is empty.
+ *
+ * The table is at least twice the size of the number of registrations, so it never fills up and the linear probe
+ * sequences stay short.
+ */
+constexpr uint8_t getInterruptTableSize(uint8_t registrations) {
+	uint8_t size = 1;
+	while (size < 2 * registrations) {
+		size <<= 1;
+	}
+	return size;
+}
 
-	return result;
+static_assert(MAX_INTERRUPT_REGISTRATIONS < 127, "Too many interrupt registrations");
+
+const uint8_t INTERRUPT_TABLE_SIZE = getInterruptTableSize(MAX_INTERRUPT_REGISTRATIONS);
+const uint8_t INTERRUPT_TABLE_MASK = INTERRUPT_TABLE_SIZE - 1;
+
+static uint8_t interruptTable[INTERRUPT_TABLE_SIZE];
+
+static inline uint8_t getInterruptTableIndex(uint8_t type, uint8_t id) {
+	return (type * 37 + id) & INTERRUPT_TABLE_MASK;
+}
+
+/*
+ * Returns the index in the interrupt table of the registration with the given type and id, or -1 if not found.
+ */
+static int8_t findInterruptTableIndex(uint8_t type, uint8_t id) {
+	uint8_t index = getInterruptTableIndex(type, id);
+	while (interruptTable[index] != 0) {
+		interrupt_registration_t* registration = &interruptRegistrations[interruptTable[index] - 1];
+		if (registration->type == type && registration->id == id) {
+			return index;
+		}
+		index = (index + 1) & INTERRUPT_TABLE_MASK;
+	}
+	return -1;
+}
+
+/*
+ * Removes an entry from the interrupt table, and moves up entries further along the probe sequence to fill the gap.
+ */
+static void removeInterruptTableIndex(uint8_t index) {
+	interruptTable[index] = 0;
+	uint8_t next          = (index + 1) & INTERRUPT_TABLE_MASK;
+	while (interruptTable[next] != 0) {
+		interrupt_registration_t* registration = &interruptRegistrations[interruptTable[next] - 1];
+		uint8_t home                           = getInterruptTableIndex(registration->type, registration->id);
+		// Move the entry if the gap is between its home index and its current index (cyclically)
+		if (((next - home) & INTERRUPT_TABLE_MASK) >= ((next - index) & INTERRUPT_TABLE_MASK)) {
+			interruptTable[index] = interruptTable[next];
+			interruptTable[next]  = 0;
+			index                 = next;
+		}
+		next = (next + 1) & INTERRUPT_TABLE_MASK;
+	}
 }
 
 microapp_sdk_result_t registerInterrupt(interrupt_registration_t* interrupt) {
-	for (int i = 0; i < MAX_INTERRUPT_REGISTRATIONS; ++i) {
+	int8_t tableIndex = findInterruptTableIndex(interrupt->type, interrupt->id);
+	if (tableIndex >= 0) {
+		// Already registered: only update the handler
+		interruptRegistrations[interruptTable[tableIndex] - 1].handler = interrupt->handler;
+		return CS_MICROAPP_SDK_ACK_SUCCESS;
+	}
+	for (uint8_t i = 0; i < MAX_INTERRUPT_REGISTRATIONS; ++i) {
 		if (!interruptRegistrations[i].registered) {
 			interruptRegistrations[i].registered = true;
 			interruptRegistrations[i].handler    = interrupt->handler;
 			interruptRegistrations[i].type       = interrupt->type;
 			interruptRegistrations[i].id         = interrupt->id;
+
+			uint8_t index = getInterruptTableIndex(interrupt->type, interrupt->id);
+			while (interruptTable[index] != 0) {
+				index = (index + 1) & INTERRUPT_TABLE_MASK;
+			}
+			interruptTable[index] = i + 1;
 			return CS_MICROAPP_SDK_ACK_SUCCESS;
 		}
 	}
@@ -268,77 +873,54 @@ microapp_sdk_result_t registerInterrupt(interrupt_registration_t* interrupt) {
 }
 
 microapp_sdk_result_t removeInterruptRegistration(MicroappSdkType type, uint8_t id) {
-	for (int i = 0; i < MAX_INTERRUPT_REGISTRATIONS; ++i) {
-		if (!interruptRegistrations[i].registered) {
-			continue;
-		}
-		if (interruptRegistrations[i].type == type && interruptRegistrations[i].id == id) {
-			interruptRegistrations[i].registered = false;
-			return CS_MICROAPP_SDK_ACK_SUCCESS;
-		}
+	int8_t tableIndex = findInterruptTableIndex(type, id);
+	if (tableIndex < 0) {
+		return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
 	}
-	return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
+	interruptRegistrations[interruptTable[tableIndex] - 1].registered = false;
+	removeInterruptTableIndex(tableIndex);
+	return CS_MICROAPP_SDK_ACK_SUCCESS;
 }
 
 microapp_sdk_result_t callInterrupt(MicroappSdkType type, uint8_t id, microapp_sdk_header_t* interruptHeader) {
-	for (int i = 0; i < MAX_INTERRUPT_REGISTRATIONS; ++i) {
-		if (!interruptRegistrations[i].registered) {
-			continue;
-		}
-		if (interruptRegistrations[i].type != type) {
-			continue;
-		}
-		if (interruptRegistrations[i].id == id) {
-			if (interruptRegistrations[i].handler) {
-				return interruptRegistrations[i].handler(interruptHeader);
-			}
-			// Handler does not exist
-			return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
-		}
+	int8_t tableIndex = findInterruptTableIndex(type, id);
+	if (tableIndex < 0) {
+		// No soft interrupt of this type with this id registered
+		return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
+	}
+	interruptFunction handler = interruptRegistrations[interruptTable[tableIndex] - 1].handler;
+	if (handler) {
+		return handler(interruptHeader);
 	}
-	// No soft interrupt of this type with this id registered
+	// Handler does not exist
 	return CS_MICROAPP_SDK_ACK_ERR_NOT_FOUND;
 }
 
+/*
+ * For all interrupt types, the id is the first field after the header: the pin for pin interrupts, and the (sub)type
+ * for the others. Checked here at compile time.
+ */
+static_assert(__builtin_offsetof(microapp_sdk_pin_t, pin) == sizeof(microapp_sdk_header_t), "Unexpected id offset");
+static_assert(__builtin_offsetof(microapp_sdk_ble_t, type) == sizeof(microapp_sdk_header_t), "Unexpected id offset");
+static_assert(__builtin_offsetof(microapp_sdk_mesh_t, type) == sizeof(microapp_sdk_header_t), "Unexpected id offset");
+static_assert(
+		__builtin_offsetof(microapp_sdk_message_t, type) == sizeof(microapp_sdk_header_t), "Unexpected id offset");
+static_assert(
+		__builtin_offsetof(microapp_sdk_bluenet_event_t, type) == sizeof(microapp_sdk_header_t),
+		"Unexpected id offset");
+static_assert(__builtin_offsetof(microapp_sdk_asset_t, type) == sizeof(microapp_sdk_header_t), "Unexpected id offset");
+
+// Message types that are interrupts
+const uint32_t INTERRUPT_TYPES = (1UL << CS_MICROAPP_SDK_TYPE_PIN) | (1UL << CS_MICROAPP_SDK_TYPE_BLE)
+								 | (1UL << CS_MICROAPP_SDK_TYPE_MESH) | (1UL << CS_MICROAPP_SDK_TYPE_MESSAGE)
+								 | (1UL << CS_MICROAPP_SDK_TYPE_BLUENET_EVENT) | (1UL << CS_MICROAPP_SDK_TYPE_ASSETS);
+
 microapp_sdk_result_t handleInterrupt(microapp_sdk_header_t* interruptHeader) {
-	// For all possible interrupt types, get the id from the incoming message
-	uint8_t id;
-	switch (interruptHeader->messageType) {
-		case CS_MICROAPP_SDK_TYPE_PIN: {
-			microapp_sdk_pin_t* pinInterrupt = reinterpret_cast<microapp_sdk_pin_t*>(interruptHeader);
-			id                            = pinInterrupt->pin;
-			break;
-		}
-		case CS_MICROAPP_SDK_TYPE_BLE: {
-			microapp_sdk_ble_t* bleInterrupt = reinterpret_cast<microapp_sdk_ble_t*>(interruptHeader);
-			id                            = bleInterrupt->type;
-			break;
-		}
-		case CS_MICROAPP_SDK_TYPE_MESH: {
-			microapp_sdk_mesh_t* meshInterrupt = reinterpret_cast<microapp_sdk_mesh_t*>(interruptHeader);
-			id                              = meshInterrupt->type;
-			break;
-		}
-		case CS_MICROAPP_SDK_TYPE_MESSAGE: {
-			auto messageInterrupt = reinterpret_cast<microapp_sdk_message_t*>(interruptHeader);
-			id                    = messageInterrupt->type;
-			break;
-		}
-		case CS_MICROAPP_SDK_TYPE_BLUENET_EVENT: {
-			auto eventInterrupt = reinterpret_cast<microapp_sdk_bluenet_event_t*>(interruptHeader);
-			id                  = eventInterrupt->type;
-			break;
-		}
-		case CS_MICROAPP_SDK_TYPE_ASSETS: {
-			auto assetInterrupt = reinterpret_cast<microapp_sdk_asset_t*>(interruptHeader);
-			id                  = assetInterrupt->type;
-			break;
-		}
-		default: {
-			return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
-		}
+	uint8_t type = interruptHeader->messageType;
+	if (type >= 32 || (INTERRUPT_TYPES & (1UL << type)) == 0) {
+		return CS_MICROAPP_SDK_ACK_ERR_UNDEFINED;
 	}
 	// Call the interrupt
-	MicroappSdkType type = (MicroappSdkType)interruptHeader->messageType;
-	return callInterrupt(type, id, interruptHeader);
+	uint8_t id = reinterpret_cast<uint8_t*>(interruptHeader)[sizeof(microapp_sdk_header_t)];
+	return callInterrupt((MicroappSdkType)type, id, interruptHeader);
 }